@@ -0,0 +1,86 @@
+#include "BootProfiler.hpp"
+#include <esp_timer.h>
+#include "Log.hpp"
+
+// Initialize static member
+BootProfiler* BootProfiler::instance = nullptr;
+
+// Private constructor
+BootProfiler::BootProfiler() : markCount(0) {
+    for (uint8_t i = 0; i < MAX_MARKS; i++) {
+        marks[i].micros = 0;
+        marks[i].name.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+// Destructor
+BootProfiler::~BootProfiler() {
+}
+
+// Get singleton instance
+BootProfiler& BootProfiler::getInstance() {
+    if (instance == nullptr) {
+        instance = new BootProfiler();
+    }
+    return *instance;
+}
+
+// Check if instance exists
+bool BootProfiler::hasInstance() {
+    return instance != nullptr;
+}
+
+// Destroy the singleton instance
+void BootProfiler::destroyInstance() {
+    if (instance != nullptr) {
+        delete instance;
+        instance = nullptr;
+    }
+}
+
+void BootProfiler::mark(const char* name) {
+    uint32_t now = (uint32_t)esp_timer_get_time();
+
+    uint8_t index = markCount.fetch_add(1, std::memory_order_relaxed);
+    if (index >= MAX_MARKS) return;
+
+    marks[index].micros = now;
+    marks[index].name.store(name, std::memory_order_release);
+}
+
+uint32_t BootProfiler::getMarkTime(const char* name) const {
+    uint8_t count = markCount.load(std::memory_order_relaxed);
+    if (count > MAX_MARKS) count = MAX_MARKS;
+
+    for (uint8_t i = 0; i < count; i++) {
+        const char* markName = marks[i].name.load(std::memory_order_acquire);
+        if (markName && strcmp(markName, name) == 0) {
+            return marks[i].micros;
+        }
+    }
+    return NOT_MARKED;
+}
+
+void BootProfiler::report() const {
+    uint8_t count = markCount.load(std::memory_order_relaxed);
+    if (count > MAX_MARKS) count = MAX_MARKS;
+
+    // Marks from parallel tasks land out of order; print them by time
+    uint8_t order[MAX_MARKS];
+    uint8_t ready = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (!marks[i].name.load(std::memory_order_acquire)) continue;
+
+        uint8_t position = ready++;
+        while (position > 0 && marks[order[position - 1]].micros > marks[i].micros) {
+            order[position] = order[position - 1];
+            position--;
+        }
+        order[position] = i;
+    }
+
+    for (uint8_t i = 0; i < ready; i++) {
+        const Mark& mark = marks[order[i]];
+        LOG_INFO("Boot: %8u us  %s", mark.micros, mark.name.load(std::memory_order_relaxed));
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+// Microsecond timestamps for boot phases.
+//
+// mark() may be called from any task. Each call stores a name and
+// esp_timer_get_time(), which counts from system start. report() logs every
+// mark in time order once boot has finished. Names must be string literals.
+class BootProfiler {
+   private:
+    // Private constructor to prevent direct instantiation
+    BootProfiler();
+
+    // Static instance pointer
+    static BootProfiler* instance;
+
+    // Delete copy constructor and assignment operator
+    BootProfiler(const BootProfiler&) = delete;
+    BootProfiler& operator=(const BootProfiler&) = delete;
+
+   public:
+    static const uint8_t MAX_MARKS = 24;
+    static const uint32_t NOT_MARKED = 0xFFFFFFFFUL;
+
+    // Public destructor
+    ~BootProfiler();
+
+    // Static method to get the singleton instance (create it from setup() before starting boot tasks)
+    static BootProfiler& getInstance();
+
+    // Static method to check if instance exists
+    static bool hasInstance();
+
+    // Static method to destroy the instance
+    static void destroyInstance();
+
+    // Record that a phase reached this point
+    void mark(const char* name);
+
+    // Microseconds since system start at the named mark, NOT_MARKED if it never happened
+    uint32_t getMarkTime(const char* name) const;
+
+    // Log all marks in time order
+    void report() const;
+
+   private:
+    struct Mark {
+        uint32_t micros;
+        std::atomic<const char*> name;  // Published last; null until the slot is complete
+    };
+
+    Mark marks[MAX_MARKS];
+    std::atomic<uint8_t> markCount;  // Slots claimed so far
+};
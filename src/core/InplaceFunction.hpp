@@ -0,0 +1,207 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Callable wrapper that stores its target inside the object, like a
+// std::function that never allocates.
+//
+// Any callable whose size and alignment fit Capacity can be stored. A
+// lambda that captures too much fails to compile (static_assert) instead
+// of silently going to the heap. Copy, move and destroy go through one
+// per-type manager function. Calls go through one per-type invoker. An
+// empty function holds a no-op invoker, so calling it is always safe and
+// needs no null check; for non-void results it returns R().
+//
+// The default capacity fits a lambda capturing four pointers, e.g.
+// [this, channel].
+static const size_t INPLACE_FUNCTION_CAPACITY = 4 * sizeof(void*);
+
+template <typename Signature, size_t Capacity = INPLACE_FUNCTION_CAPACITY>
+class InplaceFunction;
+
+template <typename R, typename... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity> {
+   public:
+    InplaceFunction() : invoker(&invokeEmpty), manager(nullptr) {}
+    InplaceFunction(std::nullptr_t) : InplaceFunction() {}
+
+    template <typename F, typename Fn = typename std::decay<F>::type,
+              typename = typename std::enable_if<!std::is_same<Fn, InplaceFunction>::value>::type>
+    InplaceFunction(F&& callable) : InplaceFunction() {
+        static_assert(sizeof(Fn) <= Capacity, "Callable does not fit this InplaceFunction; capture less or raise Capacity");
+        static_assert(alignof(Fn) <= alignof(Storage), "Callable is over-aligned for InplaceFunction");
+        if (isNull(callable)) return;
+        new (&storage) Fn(std::forward<F>(callable));
+        invoker = &invokeTarget<Fn>;
+        manager = &manageTarget<Fn>;
+    }
+
+    InplaceFunction(const InplaceFunction& other) : InplaceFunction() { copyFrom(other); }
+    InplaceFunction(InplaceFunction&& other) : InplaceFunction() { moveFrom(other); }
+
+    ~InplaceFunction() { reset(); }
+
+    InplaceFunction& operator=(const InplaceFunction& other) {
+        if (this != &other) {
+            reset();
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    InplaceFunction& operator=(InplaceFunction&& other) {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    InplaceFunction& operator=(std::nullptr_t) {
+        reset();
+        return *this;
+    }
+
+    R operator()(Args... args) const {
+        return invoker(const_cast<Storage*>(&storage), std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const { return manager != nullptr; }
+
+    void reset() {
+        if (manager) {
+            manager(Operation::DESTROY, &storage, nullptr);
+            manager = nullptr;
+        }
+        invoker = &invokeEmpty;
+    }
+
+   private:
+    enum class Operation : uint8_t { COPY, MOVE, DESTROY };
+
+    using Storage = typename std::aligned_storage<Capacity, alignof(std::max_align_t)>::type;
+    using Invoker = R (*)(Storage* storage, Args&&... args);
+    using Manager = void (*)(Operation operation, Storage* target, Storage* source);
+
+    Storage storage;
+    Invoker invoker;
+    Manager manager;  // Null when empty
+
+    static R invokeEmpty(Storage*, Args&&...) { return R(); }
+
+    // A null function pointer makes an empty function, as with std::function
+    template <typename Fn>
+    static bool isNull(const Fn&) { return false; }
+    template <typename Ret, typename... Params>
+    static bool isNull(Ret (*function)(Params...)) { return function == nullptr; }
+
+    template <typename Fn>
+    static R invokeTarget(Storage* storage, Args&&... args) {
+        return (*reinterpret_cast<Fn*>(storage))(std::forward<Args>(args)...);
+    }
+
+    template <typename Fn>
+    static void manageTarget(Operation operation, Storage* target, Storage* source) {
+        switch (operation) {
+            case Operation::COPY:
+                new (target) Fn(*reinterpret_cast<const Fn*>(source));
+                break;
+            case Operation::MOVE:
+                new (target) Fn(std::move(*reinterpret_cast<Fn*>(source)));
+                reinterpret_cast<Fn*>(source)->~Fn();
+                break;
+            case Operation::DESTROY:
+                reinterpret_cast<Fn*>(target)->~Fn();
+                break;
+        }
+    }
+
+    void copyFrom(const InplaceFunction& other) {
+        if (!other.manager) return;
+        other.manager(Operation::COPY, &storage, const_cast<Storage*>(&other.storage));
+        invoker = other.invoker;
+        manager = other.manager;
+    }
+
+    void moveFrom(InplaceFunction& other) {
+        if (!other.manager) return;
+        other.manager(Operation::MOVE, &storage, &other.storage);
+        invoker = other.invoker;
+        manager = other.manager;
+        other.invoker = &invokeEmpty;
+        other.manager = nullptr;
+    }
+};
+
+// Fixed set of subscribers to one event, stored inline.
+//
+// add() returns a handle for remove(), or -1 when all MaxCallbacks slots are
+// taken. Handles stay valid while other subscribers come and go. Calling
+// the list calls every subscriber in slot order. A subscriber may add
+// others or remove others while it runs, but must not remove itself.
+template <typename Signature, uint8_t MaxCallbacks, size_t Capacity = INPLACE_FUNCTION_CAPACITY>
+class CallbackList;
+
+template <typename... Args, uint8_t MaxCallbacks, size_t Capacity>
+class CallbackList<void(Args...), MaxCallbacks, Capacity> {
+    static_assert(MaxCallbacks <= 32, "CallbackList tracks slots in a 32-bit mask");
+
+   public:
+    using Callback = InplaceFunction<void(Args...), Capacity>;
+
+    CallbackList() : usedMask(0) {}
+
+    int add(Callback callback) {
+        if (!callback) return -1;
+
+        for (uint8_t i = 0; i < MaxCallbacks; i++) {
+            if (!(usedMask & (1UL << i))) {
+                callbacks[i] = std::move(callback);
+                usedMask |= 1UL << i;
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    bool remove(int handle) {
+        if (handle < 0 || handle >= MaxCallbacks || !(usedMask & (1UL << handle))) return false;
+
+        usedMask &= ~(1UL << handle);
+        callbacks[handle].reset();
+        return true;
+    }
+
+    // Replace every subscriber with this one (nullptr just clears)
+    int set(Callback callback) {
+        clear();
+        return add(std::move(callback));
+    }
+
+    void clear() {
+        for (uint8_t i = 0; i < MaxCallbacks; i++) {
+            callbacks[i].reset();
+        }
+        usedMask = 0;
+    }
+
+    bool empty() const { return usedMask == 0; }
+
+    void operator()(Args... args) const {
+        // Checked per slot, so a subscriber removing another takes effect at once
+        for (uint8_t i = 0; i < MaxCallbacks; i++) {
+            if (usedMask & (1UL << i)) {
+                callbacks[i](args...);
+            }
+        }
+    }
+
+   private:
+    Callback callbacks[MaxCallbacks];
+    uint32_t usedMask;
+};
@@ -0,0 +1,147 @@
+#include "Log.hpp"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Initialize static member
+Log* Log::instance = nullptr;
+
+// Private constructor
+Log::Log() : enqueuePos(0),
+             dequeuePos(0),
+             writtenCount(0),
+             droppedCount(0),
+             printedCount(0),
+             task(nullptr) {
+    for (uint32_t i = 0; i < RING_SIZE; i++) {
+        ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+// Destructor
+Log::~Log() {
+    if (task != nullptr) {
+        vTaskDelete((TaskHandle_t)task);
+        task = nullptr;
+    }
+}
+
+// Get singleton instance
+Log& Log::getInstance() {
+    if (instance == nullptr) {
+        instance = new Log();
+    }
+    return *instance;
+}
+
+// Check if instance exists
+bool Log::hasInstance() {
+    return instance != nullptr;
+}
+
+// Destroy the singleton instance
+void Log::destroyInstance() {
+    if (instance != nullptr) {
+        delete instance;
+        instance = nullptr;
+    }
+}
+
+void Log::initialize() {
+    if (task != nullptr) return;
+
+    TaskHandle_t handle = nullptr;
+    if (xTaskCreatePinnedToCore(drainTask, "log", TASK_STACK_SIZE, this, TASK_PRIORITY, &handle, tskNO_AFFINITY) == pdPASS) {
+        task = handle;
+    }
+}
+
+Log::Stats Log::getStats() const {
+    Stats stats;
+    stats.written = writtenCount.load(std::memory_order_relaxed);
+    stats.dropped = droppedCount.load(std::memory_order_relaxed);
+    stats.printed = printedCount;
+    return stats;
+}
+
+void* Log::getTaskHandle() const {
+    return task;
+}
+
+// Private methods
+
+// Multi-producer enqueue: claim a slot with a CAS, fill it, then publish it through its sequence
+void Log::push(uint8_t level, const char* format, const Word* args, uint8_t argCount) {
+    uint32_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Record* record;
+
+    for (;;) {
+        record = &ring[pos & RING_MASK];
+        uint32_t sequence = record->sequence.load(std::memory_order_acquire);
+        int32_t difference = (int32_t)(sequence - pos);
+
+        if (difference == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (difference < 0) {
+            // Ring full: drop rather than wait for the drain task
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    record->format = format;
+    record->level = level;
+    record->argCount = argCount;
+    for (uint8_t i = 0; i < argCount; i++) {
+        record->args[i] = args[i];
+    }
+    record->sequence.store(pos + 1, std::memory_order_release);
+    writtenCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool Log::printNext() {
+    Record& record = ring[dequeuePos & RING_MASK];
+    if (record.sequence.load(std::memory_order_acquire) != dequeuePos + 1) return false;
+
+    Word args[MAX_ARGS] = {};
+    for (uint8_t i = 0; i < record.argCount; i++) {
+        args[i] = record.args[i];
+    }
+    const char* format = record.format;
+    uint8_t level = record.level;
+
+    // Hand the slot back to producers before the slow part
+    record.sequence.store(dequeuePos + RING_SIZE, std::memory_order_release);
+    dequeuePos++;
+
+    // Info lines print as-is; other levels get a short tag
+    static const char* const prefixes[] = {"", "[E] ", "[W] ", "", "[D] "};
+    const char* prefix = level < sizeof(prefixes) / sizeof(prefixes[0]) ? prefixes[level] : "";
+    size_t prefixLength = strlen(prefix);
+    memcpy(line, prefix, prefixLength);
+
+    // Every argument is one word wide, so unused trailing ones are simply ignored
+    size_t capacity = sizeof(line) - 1 - prefixLength;
+    int length = snprintf(line + prefixLength, capacity, format, args[0], args[1], args[2], args[3], args[4], args[5]);
+    if (length < 0) return true;
+    if ((size_t)length >= capacity) {
+        length = capacity - 1;
+    }
+    length += prefixLength;
+    line[length++] = '\n';
+
+    Serial.write((const uint8_t*)line, length);
+    printedCount++;
+    return true;
+}
+
+void Log::drainTask(void* parameter) {
+    Log* log = static_cast<Log*>(parameter);
+
+    for (;;) {
+        if (!log->printNext()) {
+            vTaskDelay(pdMS_TO_TICKS(DRAIN_INTERVAL));
+        }
+    }
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <type_traits>
+
+// Deferred-format logging.
+//
+// LOG_*() does not format anything. It stores the format string pointer and
+// up to MAX_ARGS raw word-sized arguments in a lock-free ring. A low-priority
+// task formats the records and writes them to Serial. When the ring is full
+// the record is dropped and counted, so the caller never blocks.
+//
+// Arguments must be integers, enums or pointers. Floats and String objects
+// are rejected at compile time. A %s argument is read when the record is
+// printed, not when it is logged, so it must outlive the record (string
+// literals or long-lived buffers only).
+//
+// UNIMIX_LOG_LEVEL (a build flag, default LOG_LEVEL_INFO) removes disabled
+// levels at compile time. Their arguments are not even evaluated.
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef UNIMIX_LOG_LEVEL
+#define UNIMIX_LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#define LOG_DISABLED() \
+    do {               \
+    } while (0)
+
+#if UNIMIX_LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) Log::getInstance().write(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) LOG_DISABLED()
+#endif
+
+#if UNIMIX_LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...) Log::getInstance().write(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) LOG_DISABLED()
+#endif
+
+#if UNIMIX_LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) Log::getInstance().write(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) LOG_DISABLED()
+#endif
+
+#if UNIMIX_LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) Log::getInstance().write(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) LOG_DISABLED()
+#endif
+
+class Log {
+   private:
+    // Private constructor to prevent direct instantiation
+    Log();
+
+    // Static instance pointer
+    static Log* instance;
+
+    // Delete copy constructor and assignment operator
+    Log(const Log&) = delete;
+    Log& operator=(const Log&) = delete;
+
+   public:
+    typedef uintptr_t Word;
+
+    static const uint8_t MAX_ARGS = 6;
+    static const uint32_t RING_SIZE = 64;  // Records, must be a power of two
+    static const size_t LINE_LENGTH = 160;
+    static const uint32_t TASK_STACK_SIZE = 3072;
+    static const uint8_t TASK_PRIORITY = 1;
+    static const unsigned long DRAIN_INTERVAL = 10;  // ms the task sleeps when the ring is empty
+
+    struct Stats {
+        uint32_t written;  // Records queued
+        uint32_t dropped;  // Records lost because the ring was full
+        uint32_t printed;  // Records formatted and sent to Serial
+    };
+
+    // Public destructor
+    ~Log();
+
+    // Static method to get the singleton instance (call once from setup() before any other task logs)
+    static Log& getInstance();
+
+    // Static method to check if instance exists
+    static bool hasInstance();
+
+    // Static method to destroy the instance
+    static void destroyInstance();
+
+    // Starts the drain task; records logged before this are kept and printed once it runs
+    void initialize();
+
+    // Queue a record (use the LOG_* macros)
+    template <typename... Args>
+    void write(uint8_t level, const char* format, Args... args) {
+        static_assert(sizeof...(Args) <= MAX_ARGS, "Too many log arguments");
+        const Word words[MAX_ARGS + 1] = {toWord(args)...};
+        push(level, format, words, sizeof...(Args));
+    }
+
+    Stats getStats() const;
+
+    // Drain task handle (TaskHandle_t), null before initialize()
+    void* getTaskHandle() const;
+
+   private:
+    static const uint32_t RING_MASK = RING_SIZE - 1;
+
+    struct Record {
+        std::atomic<uint32_t> sequence;  // Vyukov bounded queue turn counter
+        const char* format;
+        uint8_t level;
+        uint8_t argCount;
+        Word args[MAX_ARGS];
+    };
+
+    Record ring[RING_SIZE];
+    std::atomic<uint32_t> enqueuePos;
+    uint32_t dequeuePos;  // Only touched by the drain task
+
+    std::atomic<uint32_t> writtenCount;
+    std::atomic<uint32_t> droppedCount;
+    uint32_t printedCount;
+
+    void* task;
+    char line[LINE_LENGTH];
+
+    // Internal methods
+    void push(uint8_t level, const char* format, const Word* args, uint8_t argCount);
+    bool printNext();
+    static void drainTask(void* parameter);
+
+    template <typename T>
+    static typename std::enable_if<!std::is_pointer<T>::value, Word>::type toWord(T value) {
+        static_assert((std::is_integral<T>::value || std::is_enum<T>::value) && sizeof(T) <= sizeof(Word),
+                      "Log arguments must be word-sized integers, enums or pointers");
+        return (Word)value;
+    }
+
+    template <typename T>
+    static Word toWord(T* value) {
+        return (Word)(uintptr_t)value;
+    }
+};
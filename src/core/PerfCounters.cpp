@@ -0,0 +1,126 @@
+#include "PerfCounters.hpp"
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Initialize static members
+PerfCounters* PerfCounters::instance = nullptr;
+const uint32_t PerfCounters::LOOP_BIN_LIMITS[LOOP_BINS - 1] = {1000, 2000, 5000, 10000, 20000, 50000, 100000};
+
+// Private constructor
+PerfCounters::PerfCounters() : ioUpdateLast(0),
+                               ioUpdateMax(0),
+                               ioUpdateTotal(0),
+                               ioUpdateCount(0),
+                               partialRefreshMs(0),
+                               fullRefreshMs(0),
+                               wifiReconnects(0),
+                               wifiFailedConnects(0),
+                               wifiConnectAttempts(0),
+                               taskCount(0) {
+    for (uint8_t i = 0; i < LOOP_BINS; i++) {
+        loopHistogram[i].store(0, std::memory_order_relaxed);
+    }
+    for (uint8_t i = 0; i < MAX_TASKS; i++) {
+        taskNames[i] = nullptr;
+        taskHandles[i] = nullptr;
+    }
+}
+
+// Destructor
+PerfCounters::~PerfCounters() {
+}
+
+// Get singleton instance
+PerfCounters& PerfCounters::getInstance() {
+    if (instance == nullptr) {
+        instance = new PerfCounters();
+    }
+    return *instance;
+}
+
+// Check if instance exists
+bool PerfCounters::hasInstance() {
+    return instance != nullptr;
+}
+
+// Destroy the singleton instance
+void PerfCounters::destroyInstance() {
+    if (instance != nullptr) {
+        delete instance;
+        instance = nullptr;
+    }
+}
+
+// Recording
+void PerfCounters::recordLoopPeriod(uint32_t micros) {
+    uint8_t bin = 0;
+    while (bin < LOOP_BINS - 1 && micros >= LOOP_BIN_LIMITS[bin]) {
+        bin++;
+    }
+    loopHistogram[bin].fetch_add(1, std::memory_order_relaxed);
+}
+
+void PerfCounters::recordIOUpdate(uint32_t micros) {
+    ioUpdateLast.store(micros, std::memory_order_relaxed);
+    ioUpdateTotal.fetch_add(micros, std::memory_order_relaxed);
+    ioUpdateCount.fetch_add(1, std::memory_order_relaxed);
+
+    // Single writer, so a plain compare-then-store is enough for the max
+    if (micros > ioUpdateMax.load(std::memory_order_relaxed)) {
+        ioUpdateMax.store(micros, std::memory_order_relaxed);
+    }
+}
+
+void PerfCounters::recordRefresh(bool full, uint32_t ms) {
+    (full ? fullRefreshMs : partialRefreshMs).store(ms, std::memory_order_relaxed);
+}
+
+void PerfCounters::recordNetwork(uint32_t reconnects, uint32_t failedConnects, uint32_t connectAttempts) {
+    wifiReconnects.store(reconnects, std::memory_order_relaxed);
+    wifiFailedConnects.store(failedConnects, std::memory_order_relaxed);
+    wifiConnectAttempts.store(connectAttempts, std::memory_order_relaxed);
+}
+
+bool PerfCounters::registerTask(const char* name, void* taskHandle) {
+    if (taskCount >= MAX_TASKS || taskHandle == nullptr) return false;
+
+    taskNames[taskCount] = name;
+    taskHandles[taskCount] = taskHandle;
+    taskCount++;
+    return true;
+}
+
+// Reading
+void PerfCounters::getSnapshot(Snapshot& snapshot) const {
+    for (uint8_t i = 0; i < LOOP_BINS; i++) {
+        snapshot.loopHistogram[i] = loopHistogram[i].load(std::memory_order_relaxed);
+    }
+
+    uint32_t count = ioUpdateCount.load(std::memory_order_relaxed);
+    snapshot.ioUpdateLast = ioUpdateLast.load(std::memory_order_relaxed);
+    snapshot.ioUpdateMax = ioUpdateMax.load(std::memory_order_relaxed);
+    snapshot.ioUpdateAvg = count ? ioUpdateTotal.load(std::memory_order_relaxed) / count : 0;
+
+    snapshot.partialRefreshMs = partialRefreshMs.load(std::memory_order_relaxed);
+    snapshot.fullRefreshMs = fullRefreshMs.load(std::memory_order_relaxed);
+
+    snapshot.wifiReconnects = wifiReconnects.load(std::memory_order_relaxed);
+    snapshot.wifiFailedConnects = wifiFailedConnects.load(std::memory_order_relaxed);
+    snapshot.wifiConnectAttempts = wifiConnectAttempts.load(std::memory_order_relaxed);
+
+    snapshot.freeHeap = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    snapshot.largestFreeBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+
+    snapshot.taskCount = taskCount;
+    for (uint8_t i = 0; i < taskCount; i++) {
+        snapshot.tasks[i].name = taskNames[i];
+        snapshot.tasks[i].highWaterMark = uxTaskGetStackHighWaterMark((TaskHandle_t)taskHandles[i]);
+    }
+}
+
+void PerfCounters::resetLoopHistogram() {
+    for (uint8_t i = 0; i < LOOP_BINS; i++) {
+        loopHistogram[i].store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+// Runtime metrics for the performance screen.
+//
+// Producers (the control loop, the input and network jobs, UI refreshes) only do relaxed atomic
+// stores and increments. Readers take a Snapshot whenever they like. Nothing
+// here locks, allocates or logs, so recording is safe from any task.
+class PerfCounters {
+   private:
+    // Private constructor to prevent direct instantiation
+    PerfCounters();
+
+    // Static instance pointer
+    static PerfCounters* instance;
+
+    // Delete copy constructor and assignment operator
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+   public:
+    static const uint8_t LOOP_BINS = 8;
+    static const uint8_t MAX_TASKS = 4;
+
+    // Upper bound (exclusive, us) of every loop period bin but the last
+    static const uint32_t LOOP_BIN_LIMITS[LOOP_BINS - 1];
+
+    struct TaskStack {
+        const char* name;
+        uint32_t highWaterMark;  // Bytes of stack never touched
+    };
+
+    struct Snapshot {
+        uint32_t loopHistogram[LOOP_BINS];
+        uint32_t ioUpdateLast;      // us
+        uint32_t ioUpdateMax;       // us
+        uint32_t ioUpdateAvg;       // us
+        uint32_t partialRefreshMs;  // Last partial display update
+        uint32_t fullRefreshMs;     // Last full display update
+        uint32_t wifiReconnects;
+        uint32_t wifiFailedConnects;
+        uint32_t wifiConnectAttempts;  // Attempts still in the telemetry history
+        uint32_t freeHeap;
+        uint32_t largestFreeBlock;
+        uint8_t taskCount;
+        TaskStack tasks[MAX_TASKS];
+    };
+
+    // Public destructor
+    ~PerfCounters();
+
+    // Static method to get the singleton instance
+    static PerfCounters& getInstance();
+
+    // Static method to check if instance exists
+    static bool hasInstance();
+
+    // Static method to destroy the instance
+    static void destroyInstance();
+
+    // Recording
+    void recordLoopPeriod(uint32_t micros);
+    void recordIOUpdate(uint32_t micros);
+    void recordRefresh(bool full, uint32_t ms);
+    void recordNetwork(uint32_t reconnects, uint32_t failedConnects, uint32_t connectAttempts);
+
+    // Tasks whose stack high-water mark is reported (register from setup())
+    bool registerTask(const char* name, void* taskHandle);
+
+    // Reading
+    void getSnapshot(Snapshot& snapshot) const;
+    void resetLoopHistogram();
+
+   private:
+    std::atomic<uint32_t> loopHistogram[LOOP_BINS];
+    std::atomic<uint32_t> ioUpdateLast;
+    std::atomic<uint32_t> ioUpdateMax;
+    std::atomic<uint32_t> ioUpdateTotal;
+    std::atomic<uint32_t> ioUpdateCount;
+    std::atomic<uint32_t> partialRefreshMs;
+    std::atomic<uint32_t> fullRefreshMs;
+    std::atomic<uint32_t> wifiReconnects;
+    std::atomic<uint32_t> wifiFailedConnects;
+    std::atomic<uint32_t> wifiConnectAttempts;
+
+    const char* taskNames[MAX_TASKS];
+    void* taskHandles[MAX_TASKS];
+    uint8_t taskCount;
+};
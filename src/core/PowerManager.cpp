@@ -0,0 +1,360 @@
+#include "PowerManager.hpp"
+#include <driver/gpio.h>
+#include <driver/uart.h>
+#include <esp_sleep.h>
+#include "Log.hpp"
+#include "Scheduler.hpp"
+#include "../io/IO.hpp"
+#include "../network/Network.hpp"
+
+namespace {
+const int UART_WAKE_THRESHOLD = 3;  // RX edges needed to wake; these first bytes are lost
+}
+
+// Initialize static member
+PowerManager* PowerManager::instance = nullptr;
+
+// Private constructor
+PowerManager::PowerManager() : initialized(false),
+                               enabled(true),
+                               inputIdleTimeout(DEFAULT_INPUT_IDLE_TIMEOUT),
+                               minSleep(DEFAULT_MIN_SLEEP),
+                               maxSleep(DEFAULT_MAX_SLEEP),
+                               awakeHolds(0),
+                               sleepCommitted(false),
+                               inputJob(Scheduler::INVALID_JOB),
+                               inputActivePeriod(1),
+                               inputIdlePeriod(1),
+                               inputSlowed(false),
+                               wakePinCount(0),
+                               wakePinRevision(0),
+                               lastWakeTime(0),
+                               awaitingInput(false),
+                               wakeMicros(0),
+                               inputRunsAtWake(0),
+                               wakeLatencySum(0),
+                               wakeLatencyCount(0) {
+    resetStats();
+}
+
+// Destructor
+PowerManager::~PowerManager() {
+    shutdown();
+}
+
+// Get singleton instance
+PowerManager& PowerManager::getInstance() {
+    if (instance == nullptr) {
+        instance = new PowerManager();
+    }
+    return *instance;
+}
+
+// Check if instance exists
+bool PowerManager::hasInstance() {
+    return instance != nullptr;
+}
+
+// Destroy the singleton instance
+void PowerManager::destroyInstance() {
+    if (instance != nullptr) {
+        delete instance;
+        instance = nullptr;
+    }
+}
+
+// Lifecycle
+void PowerManager::initialize() {
+    if (initialized) return;
+
+    refreshWakePins();
+
+    // Console input wakes the chip too (the serial protocol is polled from a job)
+    uart_set_wakeup_threshold(UART_NUM_0, UART_WAKE_THRESHOLD);
+    esp_sleep_enable_uart_wakeup(UART_NUM_0);
+    esp_sleep_enable_gpio_wakeup();
+
+    initialized = true;
+    LOG_INFO("Power: Initialized with %u wake pins", wakePinCount);
+}
+
+void PowerManager::shutdown() {
+    if (!initialized) return;
+
+    setInputActive(true);
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+    initialized = false;
+}
+
+void PowerManager::idle() {
+    if (!initialized) {
+        delay(1);
+        return;
+    }
+
+    checkWakeLatency();
+
+    // Stay awake until the input job has handled a GPIO wake
+    if (awaitingInput) return;
+
+    if (!canSleep()) {
+        setInputActive(true);
+        delay(1);
+        return;
+    }
+
+    setInputActive(false);
+
+    unsigned long deadline = Scheduler::getInstance().getNextDeadline();
+    if (deadline == 0) return;
+    if (deadline < minSleep) {
+        delay(1);
+        return;
+    }
+
+    refreshWakePins();
+
+    // An edge seen while awake would not re-trigger a level wakeup, so poll input right away
+    if (pinsChangedSinceArmed()) {
+        lastWakeTime = millis();
+        setInputActive(true);
+        return;
+    }
+
+    unsigned long limit = maxSleep;
+    if (Network::hasInstance() && Network::getInstance().isConnected() && limit > CONNECTED_MAX_SLEEP) {
+        limit = CONNECTED_MAX_SLEEP;
+    }
+    lightSleep(deadline < limit ? deadline : limit);
+}
+
+void PowerManager::setInputJob(int jobId, unsigned long activePeriodMs, unsigned long idlePeriodMs) {
+    setInputActive(true);
+
+    inputJob = jobId;
+    inputActivePeriod = activePeriodMs ? activePeriodMs : 1;
+    inputIdlePeriod = idlePeriodMs > inputActivePeriod ? idlePeriodMs : inputActivePeriod;
+    inputSlowed = false;
+}
+
+// Configuration
+void PowerManager::setEnabled(bool enable) {
+    enabled = enable;
+    if (!enabled) {
+        setInputActive(true);
+    }
+}
+
+void PowerManager::setInputIdleTimeout(unsigned long timeoutMs) {
+    inputIdleTimeout = timeoutMs;
+}
+
+void PowerManager::setSleepLimits(unsigned long minSleepMs, unsigned long maxSleepMs) {
+    minSleep = minSleepMs ? minSleepMs : 1;
+    maxSleep = maxSleepMs > minSleep ? maxSleepMs : minSleep;
+}
+
+void PowerManager::holdAwake() {
+    // A committed sleep cannot be called off, so the hold starts once the chip is awake again
+    while (true) {
+        portENTER_CRITICAL(&sleepLock);
+        if (!sleepCommitted) {
+            awakeHolds.fetch_add(1, std::memory_order_acq_rel);
+            portEXIT_CRITICAL(&sleepLock);
+            return;
+        }
+        portEXIT_CRITICAL(&sleepLock);
+    }
+}
+
+void PowerManager::releaseAwake() {
+    awakeHolds.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+// Status and stats
+bool PowerManager::isEnabled() const {
+    return enabled;
+}
+
+bool PowerManager::canSleep() const {
+    if (!initialized || !enabled) return false;
+    if (awakeHolds.load(std::memory_order_acquire) != 0) return false;
+
+    // Keep polling at full rate while the user is interacting
+    if (millis() - lastWakeTime < inputIdleTimeout) return false;
+    if (IO::hasInstance() && IO::getInstance().getIdleTime() < inputIdleTimeout) return false;
+
+    // Never sleep through association; once connected only with modem power save on.
+    // Both are atomics the network task stores as they change, so safe to read here
+    if (Network::hasInstance()) {
+        Network& network = Network::getInstance();
+        switch (network.getStatus()) {
+            case NetworkStatus::CONNECTING:
+            case NetworkStatus::RECONNECTING:
+                return false;
+            case NetworkStatus::CONNECTED:
+                return network.isPowerSaveActive();
+            default:
+                break;
+        }
+    }
+
+    return true;
+}
+
+const PowerManager::Stats& PowerManager::getStats() const {
+    return stats;
+}
+
+void PowerManager::resetStats() {
+    stats = Stats();
+    wakeLatencySum = 0;
+    wakeLatencyCount = 0;
+}
+
+void PowerManager::printStats(Print& out) const {
+    out.printf("Power: sleeps=%u asleep=%lums wakes timer=%u gpio=%u uart=%u\n",
+               (unsigned)stats.sleepCount, (unsigned long)(stats.asleepMicros / 1000),
+               (unsigned)stats.timerWakeCount, (unsigned)stats.gpioWakeCount, (unsigned)stats.uartWakeCount);
+    out.printf("Power: wake latency last=%uus avg=%uus max=%uus over budget=%u\n",
+               (unsigned)stats.lastWakeLatency, (unsigned)stats.wakeLatencyAvg,
+               (unsigned)stats.maxWakeLatency, (unsigned)stats.overBudgetCount);
+}
+
+// Private methods
+
+void PowerManager::refreshWakePins() {
+    if (!IO::hasInstance()) return;
+
+    IO& io = IO::getInstance();
+    uint32_t revision = io.getDeviceRevision();
+    if (initialized && revision == wakePinRevision) return;
+
+    wakePinCount = 0;
+    for (InputDevice* device : io.getAllDevices()) {
+        wakePinCount += device->getWakePins(wakePins + wakePinCount, MAX_WAKE_PINS - wakePinCount);
+    }
+    for (uint8_t i = 0; i < wakePinCount; i++) {
+        wakePinLevels[i] = gpio_get_level((gpio_num_t)wakePins[i]);
+    }
+    wakePinRevision = revision;
+}
+
+bool PowerManager::pinsChangedSinceArmed() {
+    for (uint8_t i = 0; i < wakePinCount; i++) {
+        if (gpio_get_level((gpio_num_t)wakePins[i]) != wakePinLevels[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PowerManager::armWakePins() {
+    for (uint8_t i = 0; i < wakePinCount; i++) {
+        // Level triggered: wake as soon as the pin leaves its current level
+        wakePinLevels[i] = gpio_get_level((gpio_num_t)wakePins[i]);
+        gpio_wakeup_enable((gpio_num_t)wakePins[i], wakePinLevels[i] ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+    }
+}
+
+void PowerManager::disarmWakePins() {
+    for (uint8_t i = 0; i < wakePinCount; i++) {
+        gpio_wakeup_disable((gpio_num_t)wakePins[i]);
+    }
+}
+
+void PowerManager::lightSleep(unsigned long sleepMs) {
+    armWakePins();
+    esp_sleep_enable_timer_wakeup((uint64_t)sleepMs * 1000ULL);
+
+    // Pending UART output would be garbled by the clock switch
+    Serial.flush();
+
+    // canSleep() ran a while ago; a hold taken since then (RMT frame, ADC start) calls the sleep off
+    portENTER_CRITICAL(&sleepLock);
+    sleepCommitted = awakeHolds.load(std::memory_order_acquire) == 0;
+    portEXIT_CRITICAL(&sleepLock);
+    if (!sleepCommitted) {
+        disarmWakePins();
+        return;
+    }
+
+    uint32_t start = micros();
+    esp_err_t result = esp_light_sleep_start();
+    uint32_t end = micros();
+
+    portENTER_CRITICAL(&sleepLock);
+    sleepCommitted = false;
+    portEXIT_CRITICAL(&sleepLock);
+
+    disarmWakePins();
+    if (result != ESP_OK) return;
+
+    stats.sleepCount++;
+    stats.asleepMicros += end - start;
+
+    switch (esp_sleep_get_wakeup_cause()) {
+        case ESP_SLEEP_WAKEUP_GPIO:
+            stats.gpioWakeCount++;
+            lastWakeTime = millis();
+            setInputActive(true);
+
+            // Measured until the input job has run once
+            awaitingInput = true;
+            wakeMicros = end;
+            inputRunsAtWake = getInputRunCount();
+            break;
+        case ESP_SLEEP_WAKEUP_UART:
+            stats.uartWakeCount++;
+            lastWakeTime = millis();
+            break;
+        default:
+            stats.timerWakeCount++;
+            break;
+    }
+}
+
+void PowerManager::setInputActive(bool active) {
+    if (inputJob == Scheduler::INVALID_JOB || active != inputSlowed) return;
+
+    Scheduler& scheduler = Scheduler::getInstance();
+    if (active) {
+        scheduler.setPeriod(inputJob, inputActivePeriod);
+        scheduler.reschedule(inputJob, 0);
+    } else {
+        scheduler.setPeriod(inputJob, inputIdlePeriod);
+    }
+    inputSlowed = !active;
+}
+
+void PowerManager::checkWakeLatency() {
+    if (!awaitingInput) return;
+
+    // No input job to wait for: nothing to measure
+    if (inputJob == Scheduler::INVALID_JOB) {
+        awaitingInput = false;
+        return;
+    }
+    if (getInputRunCount() == inputRunsAtWake) return;
+
+    awaitingInput = false;
+
+    uint32_t latency = micros() - wakeMicros;
+    stats.lastWakeLatency = latency;
+    if (latency > stats.maxWakeLatency) {
+        stats.maxWakeLatency = latency;
+    }
+    wakeLatencySum += latency;
+    wakeLatencyCount++;
+    stats.wakeLatencyAvg = wakeLatencySum / wakeLatencyCount;
+
+    if (latency > WAKE_LATENCY_BUDGET_US) {
+        stats.overBudgetCount++;
+        LOG_WARN("Power: Wake latency %uus exceeds %uus budget", latency, WAKE_LATENCY_BUDGET_US);
+    }
+}
+
+uint32_t PowerManager::getInputRunCount() const {
+    Scheduler::JobStats jobStats;
+    return Scheduler::getInstance().getStats(inputJob, jobStats) ? jobStats.runCount : 0;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+// Tickless idle for the main loop.
+//
+// Call idle() after Scheduler::run(). It asks the scheduler how long until
+// the next job is due. If nothing needs the CPU before then, it enters light
+// sleep with a timer wakeup at that deadline. The input pins reported by the
+// IO devices and the console UART are armed as wake sources. PCNT cannot wake
+// the chip, so every encoder pin is armed for the level opposite to the one
+// it has now.
+//
+// While sleeping is allowed, the registered input job is slowed to its idle
+// period, because a pin edge wakes the chip anyway. After a GPIO wake, the job
+// goes back to its active period and is due on the next tick. The time from
+// wake until that job has run is measured against WAKE_LATENCY_BUDGET_US.
+//
+// holdAwake() and the decision to sleep share a critical section. The holds
+// are checked once more right before esp_light_sleep_start(), and a hold
+// taken after that point waits until the chip is awake again, so nothing
+// that holds the chip awake is ever started into a sleep.
+class PowerManager {
+   private:
+    // Private constructor to prevent direct instantiation
+    PowerManager();
+
+    // Static instance pointer
+    static PowerManager* instance;
+
+    // Delete copy constructor and assignment operator
+    PowerManager(const PowerManager&) = delete;
+    PowerManager& operator=(const PowerManager&) = delete;
+
+   public:
+    static const uint8_t MAX_WAKE_PINS = 16;
+    static const unsigned long DEFAULT_INPUT_IDLE_TIMEOUT = 500;  // ms without input before sleeping
+    static const unsigned long DEFAULT_MIN_SLEEP = 3;             // Shorter waits are not worth the sleep transition
+    static const unsigned long DEFAULT_MAX_SLEEP = 1000;          // Upper bound on one sleep
+    static const unsigned long CONNECTED_MAX_SLEEP = 30;          // Keeps beacon loss short while WiFi is associated
+    static const uint32_t WAKE_LATENCY_BUDGET_US = 5000;
+
+    struct Stats {
+        uint32_t sleepCount;
+        uint32_t timerWakeCount;
+        uint32_t gpioWakeCount;
+        uint32_t uartWakeCount;
+        uint64_t asleepMicros;        // Total time spent in light sleep
+        uint32_t lastWakeLatency;     // us from GPIO wake until the input job ran
+        uint32_t maxWakeLatency;
+        uint32_t wakeLatencyAvg;
+        uint32_t overBudgetCount;     // Wakes that exceeded WAKE_LATENCY_BUDGET_US
+    };
+
+    // Public destructor
+    ~PowerManager();
+
+    // Static method to get the singleton instance
+    static PowerManager& getInstance();
+
+    // Static method to check if instance exists
+    static bool hasInstance();
+
+    // Static method to destroy the instance
+    static void destroyInstance();
+
+    // Lifecycle (initialize after IO so the wake pins are known)
+    void initialize();
+    void shutdown();
+
+    // Call at the end of every control loop pass
+    void idle();
+
+    // Scheduler job that polls input, and its periods while active and while sleeping
+    void setInputJob(int jobId, unsigned long activePeriodMs, unsigned long idlePeriodMs);
+
+    // Configuration
+    void setEnabled(bool enable);
+    void setInputIdleTimeout(unsigned long timeoutMs);
+    void setSleepLimits(unsigned long minSleepMs, unsigned long maxSleepMs);
+
+    // Keep the chip awake while a task on the other core is mid-transfer (callable from any task, not
+    // from an ISR). Blocks for the length of a sleep that is already under way.
+    void holdAwake();
+    void releaseAwake();
+
+    // Status and stats
+    bool isEnabled() const;
+    bool canSleep() const;
+    const Stats& getStats() const;
+    void resetStats();
+    void printStats(Print& out) const;
+
+   private:
+    bool initialized;
+    bool enabled;
+    unsigned long inputIdleTimeout;
+    unsigned long minSleep;
+    unsigned long maxSleep;
+    std::atomic<uint8_t> awakeHolds;
+    portMUX_TYPE sleepLock = portMUX_INITIALIZER_UNLOCKED;
+    bool sleepCommitted;  // Set under sleepLock from the final hold check until the wake
+
+    // Input polling job
+    int inputJob;
+    unsigned long inputActivePeriod;
+    unsigned long inputIdlePeriod;
+    bool inputSlowed;
+
+    // Wake pins, refreshed when IO devices change
+    int wakePins[MAX_WAKE_PINS];
+    uint8_t wakePinLevels[MAX_WAKE_PINS];  // Level each pin had when last armed
+    uint8_t wakePinCount;
+    uint32_t wakePinRevision;
+    unsigned long lastWakeTime;  // millis() of the last wake caused by input
+
+    // Wake-to-handled measurement
+    bool awaitingInput;
+    uint32_t wakeMicros;
+    uint32_t inputRunsAtWake;
+    uint64_t wakeLatencySum;
+    uint32_t wakeLatencyCount;
+
+    Stats stats;
+
+    // Internal methods
+    void refreshWakePins();
+    bool pinsChangedSinceArmed();
+    void armWakePins();
+    void disarmWakePins();
+    void lightSleep(unsigned long sleepMs);
+    void setInputActive(bool active);
+    void checkWakeLatency();
+    uint32_t getInputRunCount() const;
+};
@@ -0,0 +1,328 @@
+#include "Scheduler.hpp"
+
+// Initialize static member
+Scheduler* Scheduler::instance = nullptr;
+
+// Private constructor
+Scheduler::Scheduler() : expiring(NONE), currentTick(millis()) {
+    for (uint8_t i = 0; i < MAX_JOBS; i++) {
+        jobs[i] = Job();
+        jobs[i].inUse = false;
+        jobs[i].scheduled = false;
+    }
+    for (uint8_t level = 0; level < WHEEL_LEVELS; level++) {
+        for (uint8_t slot = 0; slot < WHEEL_SIZE; slot++) {
+            wheel[level][slot] = NONE;
+        }
+        occupied[level] = 0;
+    }
+}
+
+// Destructor
+Scheduler::~Scheduler() {
+}
+
+// Get singleton instance
+Scheduler& Scheduler::getInstance() {
+    if (instance == nullptr) {
+        instance = new Scheduler();
+    }
+    return *instance;
+}
+
+// Check if instance exists
+bool Scheduler::hasInstance() {
+    return instance != nullptr;
+}
+
+// Destroy the singleton instance
+void Scheduler::destroyInstance() {
+    if (instance != nullptr) {
+        delete instance;
+        instance = nullptr;
+    }
+}
+
+// Job management
+int Scheduler::addPeriodic(const char* name, unsigned long periodMs, JobCallback callback, void* context) {
+    if (periodMs == 0) periodMs = 1;
+
+    int jobId = allocateJob(name, periodMs, callback, context);
+    if (jobId != INVALID_JOB) {
+        insert(jobId, millis() + periodMs);
+    }
+    return jobId;
+}
+
+int Scheduler::addOneShot(const char* name, unsigned long delayMs, JobCallback callback, void* context) {
+    int jobId = allocateJob(name, 0, callback, context);
+    if (jobId != INVALID_JOB) {
+        insert(jobId, millis() + (delayMs ? delayMs : 1));
+    }
+    return jobId;
+}
+
+bool Scheduler::cancel(int jobId) {
+    if (jobId < 0 || jobId >= MAX_JOBS || !jobs[jobId].inUse) return false;
+
+    if (jobs[jobId].scheduled) {
+        unlink(jobId);
+    }
+    jobs[jobId].inUse = false;
+    return true;
+}
+
+bool Scheduler::reschedule(int jobId, unsigned long delayMs) {
+    if (jobId < 0 || jobId >= MAX_JOBS || !jobs[jobId].inUse) return false;
+
+    if (jobs[jobId].scheduled) {
+        unlink(jobId);
+    }
+    insert(jobId, millis() + (delayMs ? delayMs : 1));
+    return true;
+}
+
+bool Scheduler::setPeriod(int jobId, unsigned long periodMs) {
+    if (jobId < 0 || jobId >= MAX_JOBS || !jobs[jobId].inUse || jobs[jobId].period == 0) return false;
+
+    jobs[jobId].period = periodMs ? periodMs : 1;
+    return true;
+}
+
+bool Scheduler::isScheduled(int jobId) const {
+    return jobId >= 0 && jobId < MAX_JOBS && jobs[jobId].inUse && jobs[jobId].scheduled;
+}
+
+// Advance the wheel to now, running every job whose tick passed
+void Scheduler::run() {
+    uint32_t now = millis();
+
+    while ((int32_t)(now - currentTick) > 0) {
+        currentTick++;
+
+        // Entering a new 64 ms block: pull the matching upper-level slots down
+        if ((currentTick & WHEEL_MASK) == 0) {
+            if (((currentTick >> WHEEL_BITS) & WHEEL_MASK) == 0) {
+                cascade(2);
+            }
+            cascade(1);
+        }
+
+        expireSlot(currentTick & WHEEL_MASK);
+    }
+}
+
+unsigned long Scheduler::getNextDeadline() const {
+    uint32_t earliest = NO_DEADLINE;
+
+    // Level 0 holds exact ticks for the next 64 ms
+    if (occupied[0]) {
+        uint8_t start = (currentTick + 1) & WHEEL_MASK;
+        uint8_t slot = firstSlotFrom(occupied[0], start);
+        earliest = ((slot - start) & WHEEL_MASK) + 1;
+    }
+
+    // Upper levels: the start of the first occupied block is a safe lower bound
+    for (uint8_t level = 1; level < WHEEL_LEVELS; level++) {
+        if (!occupied[level]) continue;
+
+        uint8_t shift = WHEEL_BITS * level;
+        uint8_t start = ((currentTick >> shift) + 1) & WHEEL_MASK;
+        uint8_t slot = firstSlotFrom(occupied[level], start);
+        uint32_t blocks = ((slot - start) & WHEEL_MASK) + 1;
+        uint32_t blockStart = ((currentTick >> shift) + blocks) << shift;
+        uint32_t ticks = blockStart - currentTick;
+        if (ticks < earliest) earliest = ticks;
+    }
+
+    if (earliest == NO_DEADLINE) return NO_DEADLINE;
+
+    // The wheel may lag behind millis() until the next run()
+    uint32_t elapsed = millis() - currentTick;
+    return earliest > elapsed ? earliest - elapsed : 0;
+}
+
+// Stats
+bool Scheduler::getStats(int jobId, JobStats& stats) const {
+    if (jobId < 0 || jobId >= MAX_JOBS || !jobs[jobId].inUse) return false;
+
+    const Job& job = jobs[jobId];
+    stats.name = job.name;
+    stats.period = job.period;
+    stats.runCount = job.runCount;
+    stats.totalMicros = job.totalMicros;
+    stats.maxMicros = job.maxMicros;
+    stats.maxLateMs = job.maxLateMs;
+    return true;
+}
+
+void Scheduler::resetStats() {
+    for (uint8_t i = 0; i < MAX_JOBS; i++) {
+        jobs[i].runCount = 0;
+        jobs[i].totalMicros = 0;
+        jobs[i].maxMicros = 0;
+        jobs[i].maxLateMs = 0;
+    }
+}
+
+void Scheduler::printStats(Print& out) const {
+    for (uint8_t i = 0; i < MAX_JOBS; i++) {
+        const Job& job = jobs[i];
+        if (!job.inUse) continue;
+
+        uint32_t average = job.runCount ? job.totalMicros / job.runCount : 0;
+        out.printf("Scheduler: %-10s period=%lums runs=%u avg=%uus max=%uus late=%lums\n",
+                   job.name, job.period, (unsigned)job.runCount, (unsigned)average,
+                   (unsigned)job.maxMicros, job.maxLateMs);
+    }
+}
+
+// Private methods
+
+int Scheduler::allocateJob(const char* name, unsigned long period, JobCallback callback, void* context) {
+    if (!callback) return INVALID_JOB;
+
+    for (uint8_t i = 0; i < MAX_JOBS; i++) {
+        if (jobs[i].inUse) continue;
+
+        Job& job = jobs[i];
+        job = Job();
+        job.name = name;
+        job.callback = callback;
+        job.context = context;
+        job.period = period;
+        job.inUse = true;
+        job.scheduled = false;
+        return i;
+    }
+    return INVALID_JOB;
+}
+
+// Place a job in the wheel slot matching its distance from the current tick
+void Scheduler::insert(int8_t jobId, uint32_t expires) {
+    Job& job = jobs[jobId];
+    uint32_t delta = expires - currentTick;
+
+    uint8_t level;
+    uint32_t slotTick = expires;
+    if (delta < WHEEL_SIZE) {
+        level = 0;
+    } else if (delta < (1UL << (2 * WHEEL_BITS))) {
+        level = 1;
+    } else {
+        level = 2;
+        // Beyond the wheel range: park in the farthest slot, it is re-cascaded until due
+        if (delta >= (1UL << (3 * WHEEL_BITS))) {
+            slotTick = currentTick + (1UL << (3 * WHEEL_BITS)) - 1;
+        }
+    }
+
+    uint8_t slot = (slotTick >> (WHEEL_BITS * level)) & WHEEL_MASK;
+
+    job.expires = expires;
+    job.level = level;
+    job.slot = slot;
+    job.prev = NONE;
+    job.next = wheel[level][slot];
+    if (job.next != NONE) {
+        jobs[job.next].prev = jobId;
+    }
+    wheel[level][slot] = jobId;
+    occupied[level] |= 1ULL << slot;
+    job.scheduled = true;
+}
+
+void Scheduler::unlink(int8_t jobId) {
+    Job& job = jobs[jobId];
+    int8_t& head = job.level == EXPIRING ? expiring : wheel[job.level][job.slot];
+
+    if (job.prev != NONE) {
+        jobs[job.prev].next = job.next;
+    } else {
+        head = job.next;
+    }
+    if (job.next != NONE) {
+        jobs[job.next].prev = job.prev;
+    }
+    if (job.level != EXPIRING && head == NONE) {
+        occupied[job.level] &= ~(1ULL << job.slot);
+    }
+
+    job.next = NONE;
+    job.prev = NONE;
+    job.scheduled = false;
+}
+
+// Re-insert every job of the current upper-level slot relative to the new tick
+void Scheduler::cascade(uint8_t level) {
+    uint8_t slot = (currentTick >> (WHEEL_BITS * level)) & WHEEL_MASK;
+
+    int8_t jobId = wheel[level][slot];
+    wheel[level][slot] = NONE;
+    occupied[level] &= ~(1ULL << slot);
+
+    while (jobId != NONE) {
+        int8_t next = jobs[jobId].next;
+        jobs[jobId].scheduled = false;
+        insert(jobId, jobs[jobId].expires);
+        jobId = next;
+    }
+}
+
+void Scheduler::expireSlot(uint8_t slot) {
+    // Move the whole slot to the expiring list first so jobs rescheduled into it run next round,
+    // not now. The jobs stay linked there, so a callback that cancels or reschedules a job due on
+    // this same tick unlinks it from the list and it does not run.
+    expiring = wheel[0][slot];
+    wheel[0][slot] = NONE;
+    occupied[0] &= ~(1ULL << slot);
+
+    for (int8_t jobId = expiring; jobId != NONE; jobId = jobs[jobId].next) {
+        jobs[jobId].level = EXPIRING;
+    }
+
+    while (expiring != NONE) {
+        int8_t jobId = expiring;
+        unlink(jobId);
+        runJob(jobId);
+    }
+}
+
+void Scheduler::runJob(int8_t jobId) {
+    Job& job = jobs[jobId];
+
+    uint32_t now = millis();
+    unsigned long late = now - job.expires;
+    if (late > job.maxLateMs) {
+        job.maxLateMs = late;
+    }
+
+    // Periodic jobs keep their phase; periods missed while the loop was blocked are skipped
+    if (job.period > 0) {
+        uint32_t next = job.expires + job.period;
+        if ((int32_t)(next - now) <= 0) {
+            next = now + job.period;
+        }
+        insert(jobId, next);
+    }
+
+    uint32_t start = micros();
+    job.callback(job.context);
+    uint32_t duration = micros() - start;
+
+    job.runCount++;
+    job.totalMicros += duration;
+    if (duration > job.maxMicros) {
+        job.maxMicros = duration;
+    }
+
+    if (job.period == 0 && !job.scheduled) {
+        job.inUse = false;  // One-shot finished and was not rescheduled by its callback
+    }
+}
+
+// First set bit at or after start, wrapping around
+uint8_t Scheduler::firstSlotFrom(uint64_t mask, uint8_t start) {
+    uint64_t rotated = (mask >> start) | (start ? (mask << (WHEEL_SIZE - start)) : 0);
+    return (start + __builtin_ctzll(rotated)) & WHEEL_MASK;
+}
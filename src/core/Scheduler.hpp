@@ -0,0 +1,115 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Cooperative scheduler built on a three-level hierarchical timer wheel
+// (64 slots per level, 1 ms / 64 ms / 4096 ms resolution).
+//
+// Jobs live in a fixed pool. Inserting and cancelling a job is O(1).
+// Expiring a tick touches only the jobs in that tick's slot, plus an
+// occasional cascade from the upper levels. Call run() from loop(); it
+// catches up on every millisecond that elapsed since the previous call.
+class Scheduler {
+   private:
+    // Private constructor to prevent direct instantiation
+    Scheduler();
+
+    // Static instance pointer
+    static Scheduler* instance;
+
+    // Delete copy constructor and assignment operator
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+   public:
+    static const uint8_t MAX_JOBS = 16;
+    static const int INVALID_JOB = -1;
+    static const unsigned long NO_DEADLINE = 0xFFFFFFFFUL;
+
+    typedef void (*JobCallback)(void* context);
+
+    struct JobStats {
+        const char* name;
+        unsigned long period;      // 0 for one-shot jobs
+        uint32_t runCount;
+        uint32_t totalMicros;      // Accumulated run time
+        uint32_t maxMicros;        // Longest single run
+        unsigned long maxLateMs;   // Worst delay between deadline and start
+    };
+
+    // Public destructor
+    ~Scheduler();
+
+    // Static method to get the singleton instance
+    static Scheduler& getInstance();
+
+    // Static method to check if instance exists
+    static bool hasInstance();
+
+    // Static method to destroy the instance
+    static void destroyInstance();
+
+    // Job management (name must outlive the job, use string literals)
+    int addPeriodic(const char* name, unsigned long periodMs, JobCallback callback, void* context = nullptr);
+    int addOneShot(const char* name, unsigned long delayMs, JobCallback callback, void* context = nullptr);
+    bool cancel(int jobId);
+    bool reschedule(int jobId, unsigned long delayMs);
+    bool setPeriod(int jobId, unsigned long periodMs);  // Takes effect from the next run
+    bool isScheduled(int jobId) const;
+
+    // Run all jobs that became due since the last call
+    void run();
+
+    // Milliseconds until the earliest pending job (0 when something is due, NO_DEADLINE when idle)
+    unsigned long getNextDeadline() const;
+
+    // Stats
+    bool getStats(int jobId, JobStats& stats) const;
+    void resetStats();
+    void printStats(Print& out) const;
+
+   private:
+    static const uint8_t WHEEL_BITS = 6;
+    static const uint8_t WHEEL_SIZE = 1 << WHEEL_BITS;
+    static const uint8_t WHEEL_MASK = WHEEL_SIZE - 1;
+    static const uint8_t WHEEL_LEVELS = 3;
+    static const uint8_t EXPIRING = WHEEL_LEVELS;  // Level of jobs taken off a slot and waiting to run
+    static const int8_t NONE = -1;
+
+    struct Job {
+        const char* name;
+        JobCallback callback;
+        void* context;
+        unsigned long period;
+        uint32_t expires;  // Absolute tick (ms)
+        bool scheduled;
+        bool inUse;
+
+        // Intrusive list links within a wheel slot or the expiring list
+        int8_t next;
+        int8_t prev;
+        uint8_t level;
+        uint8_t slot;
+
+        // Stats
+        uint32_t runCount;
+        uint32_t totalMicros;
+        uint32_t maxMicros;
+        unsigned long maxLateMs;
+    };
+
+    Job jobs[MAX_JOBS];
+    int8_t wheel[WHEEL_LEVELS][WHEEL_SIZE];  // Slot list heads
+    uint64_t occupied[WHEEL_LEVELS];         // Bit per non-empty slot
+    int8_t expiring;                         // Jobs of the slot being expired that have not run yet
+    uint32_t currentTick;
+
+    // Internal methods
+    int allocateJob(const char* name, unsigned long period, JobCallback callback, void* context);
+    void insert(int8_t jobId, uint32_t expires);
+    void unlink(int8_t jobId);
+    void cascade(uint8_t level);
+    void expireSlot(uint8_t slot);
+    void runJob(int8_t jobId);
+    static uint8_t firstSlotFrom(uint64_t mask, uint8_t start);
+};
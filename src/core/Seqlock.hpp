@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+// Single-writer sequence lock for handing a small value to another core.
+//
+// write() never waits. It makes the sequence odd, stores the value, then
+// makes the sequence even again. read() copies the value and accepts the copy
+// only if the sequence was even and unchanged around it, so it never returns
+// a torn value. A reader never holds anything, so it cannot stall the writer.
+// If the writer keeps it busy, read() gives up after maxAttempts and the caller
+// keeps the copy it already has.
+//
+// The value is held as relaxed atomic words. A copy that races a write is
+// therefore well defined and is just thrown away. Only one task may write.
+template <typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock values are copied word by word");
+
+   public:
+    static const uint8_t DEFAULT_READ_ATTEMPTS = 8;
+
+    Seqlock() : sequence(0) {
+        for (size_t i = 0; i < WORD_COUNT; i++) {
+            words[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Publish a new value (owning task only)
+    void write(const T& value) {
+        uint32_t buffer[WORD_COUNT] = {};
+        memcpy(buffer, &value, sizeof(T));
+
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);  // Odd sequence is visible before any word changes
+
+        for (size_t i = 0; i < WORD_COUNT; i++) {
+            words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // One copy attempt; false if a write overlapped it
+    bool tryRead(T& value) const {
+        uint32_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1) return false;
+
+        uint32_t buffer[WORD_COUNT];
+        for (size_t i = 0; i < WORD_COUNT; i++) {
+            buffer[i] = words[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);  // Words are read before the sequence is checked again
+        if (sequence.load(std::memory_order_relaxed) != before) return false;
+
+        memcpy(&value, buffer, sizeof(T));
+        return true;
+    }
+
+    // Retry until a clean copy is made; value is left untouched on failure
+    bool read(T& value, uint8_t maxAttempts = DEFAULT_READ_ATTEMPTS) const {
+        for (uint8_t attempt = 0; attempt < maxAttempts; attempt++) {
+            if (tryRead(value)) return true;
+        }
+        return false;
+    }
+
+    // Number of completed writes, to skip reads when nothing new was published
+    uint32_t getVersion() const {
+        return sequence.load(std::memory_order_acquire) / 2;
+    }
+
+   private:
+    static const size_t WORD_COUNT = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    std::atomic<uint32_t> sequence;
+    std::atomic<uint32_t> words[WORD_COUNT];
+};
@@ -0,0 +1,190 @@
+#include "StateStore.hpp"
+#include "Log.hpp"
+
+namespace {
+const char* const NAMESPACE = "unimix";
+const char* const STATE_KEY = "state";
+}
+
+// Initialize static member
+StateStore* StateStore::instance = nullptr;
+
+// Private constructor
+StateStore::StateStore() : initialized(false),
+                           settleTime(DEFAULT_SETTLE_TIME),
+                           pending(false),
+                           lastChange(0),
+                           hasSaved(false) {
+    memset(&saved, 0, sizeof(saved));
+    memset(&stats, 0, sizeof(stats));
+}
+
+// Destructor
+StateStore::~StateStore() {
+    shutdown();
+}
+
+// Get singleton instance
+StateStore& StateStore::getInstance() {
+    if (instance == nullptr) {
+        instance = new StateStore();
+    }
+    return *instance;
+}
+
+// Check if instance exists
+bool StateStore::hasInstance() {
+    return instance != nullptr;
+}
+
+// Destroy the singleton instance
+void StateStore::destroyInstance() {
+    if (instance != nullptr) {
+        delete instance;
+        instance = nullptr;
+    }
+}
+
+// Lifecycle
+void StateStore::initialize() {
+    if (initialized) return;
+
+    if (!preferences.begin(NAMESPACE, false)) {
+        LOG_ERROR("Storage: Failed to open NVS namespace");
+        return;
+    }
+    initialized = true;
+}
+
+void StateStore::shutdown() {
+    if (!initialized) return;
+
+    flush();
+    preferences.end();
+    initialized = false;
+}
+
+void StateStore::update() {
+    if (!initialized) return;
+
+    if (Mixer::getInstance().takeDirty(Mixer::CONSUMER_STORAGE) != 0) {
+        // Restart the settle timer on every change
+        pending = true;
+        lastChange = millis();
+        return;
+    }
+
+    if (pending && millis() - lastChange >= settleTime) {
+        write();
+    }
+}
+
+bool StateStore::restore() {
+    if (!initialized) return false;
+
+    StoredState state;
+    memset(&state, 0, sizeof(state));
+    size_t length = preferences.getBytes(STATE_KEY, &state, sizeof(state));
+    if (length != sizeof(state) || state.version != STATE_VERSION) {
+        LOG_INFO("Storage: No saved state, using defaults");
+        return false;
+    }
+
+    Mixer& mixer = Mixer::getInstance();
+    uint8_t count = state.channelCount < mixer.getChannelCount() ? state.channelCount : mixer.getChannelCount();
+    for (uint8_t channel = 0; channel < count; channel++) {
+        mixer.jumpTo(channel, state.targets[channel]);
+        mixer.setMuted(channel, state.muteMask & (1UL << channel));
+
+        RotaryEncoder* encoder = mixer.getBoundEncoder(channel);
+        if (encoder) {
+            encoder->setReversed(state.reversedMask & (1UL << channel));
+        }
+    }
+
+    Animator::Config config = mixer.getAnimationConfig();
+    config.mode = (Animator::Mode)state.animationMode;
+    config.timeConstantMs = state.animationTimeConstant;
+    mixer.setAnimationConfig(config);
+
+    // Restoring is not a change worth writing back
+    mixer.takeDirty(Mixer::CONSUMER_STORAGE);
+    saved = state;
+    hasSaved = true;
+    stats.restored = true;
+
+    LOG_INFO("Storage: Restored %u channels", count);
+    return true;
+}
+
+void StateStore::flush() {
+    if (initialized && (pending || Mixer::getInstance().peekDirty(Mixer::CONSUMER_STORAGE))) {
+        Mixer::getInstance().takeDirty(Mixer::CONSUMER_STORAGE);
+        write();
+    }
+}
+
+void StateStore::markConfigDirty() {
+    pending = true;
+    lastChange = millis();
+}
+
+// Configuration
+void StateStore::setSettleTime(unsigned long settleMs) {
+    settleTime = settleMs;
+}
+
+// Stats
+const StateStore::Stats& StateStore::getStats() const {
+    return stats;
+}
+
+// Private methods
+
+void StateStore::capture(StoredState& state) const {
+    Mixer& mixer = Mixer::getInstance();
+
+    // Zeroed first so padding and unused channels compare equal between captures
+    memset(&state, 0, sizeof(state));
+    state.version = STATE_VERSION;
+    state.channelCount = mixer.getChannelCount();
+    state.animationMode = (uint8_t)mixer.getAnimationConfig().mode;
+    state.animationTimeConstant = mixer.getAnimationConfig().timeConstantMs;
+    state.muteMask = mixer.getMuteMask();
+
+    for (uint8_t channel = 0; channel < state.channelCount; channel++) {
+        state.targets[channel] = (uint8_t)mixer.getTarget(channel);
+
+        RotaryEncoder* encoder = mixer.getBoundEncoder(channel);
+        if (encoder && encoder->isReversed()) {
+            state.reversedMask |= 1UL << channel;
+        }
+    }
+}
+
+bool StateStore::write() {
+    pending = false;
+
+    StoredState state;
+    capture(state);
+    if (hasSaved && memcmp(&state, &saved, sizeof(state)) == 0) {
+        stats.skippedCount++;
+        return true;
+    }
+
+    uint32_t start = micros();
+    size_t written = preferences.putBytes(STATE_KEY, &state, sizeof(state));
+    stats.lastWriteMicros = micros() - start;
+
+    if (written != sizeof(state)) {
+        stats.failedCount++;
+        LOG_WARN("Storage: Write failed");
+        return false;
+    }
+
+    saved = state;
+    hasSaved = true;
+    stats.writeCount++;
+    LOG_DEBUG("Storage: Saved state (%u writes)", stats.writeCount);
+    return true;
+}
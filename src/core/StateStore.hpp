@@ -0,0 +1,103 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "../mixer/Mixer.hpp"
+
+// Persists mixer state and device configuration to NVS.
+//
+// restore() runs once at boot, before the first screen is drawn. After that,
+// update() watches the Mixer's storage dirty bits. A change only arms a
+// timer. The state is written once nothing has changed for the settle time,
+// so turning an encoder through 40 steps costs a single write. Writes that
+// would store the same bytes as the last commit are skipped.
+//
+// The whole state is one small blob under one key, so each commit appends a
+// single NVS entry. NVS is log-structured and moves to a fresh page as each
+// one fills, so wear spreads over the whole partition instead of rewriting
+// one sector.
+class StateStore {
+   private:
+    // Private constructor to prevent direct instantiation
+    StateStore();
+
+    // Static instance pointer
+    static StateStore* instance;
+
+    // Delete copy constructor and assignment operator
+    StateStore(const StateStore&) = delete;
+    StateStore& operator=(const StateStore&) = delete;
+
+   public:
+    static const unsigned long DEFAULT_SETTLE_TIME = 5000;  // ms a value must stay unchanged before it is written
+    static const uint8_t STATE_VERSION = 1;
+
+    struct Stats {
+        uint32_t writeCount;       // Commits to NVS
+        uint32_t skippedCount;     // Settled changes that matched the stored bytes
+        uint32_t failedCount;
+        uint32_t lastWriteMicros;
+        bool restored;             // State was loaded at boot
+    };
+
+    // Public destructor
+    ~StateStore();
+
+    // Static method to get the singleton instance
+    static StateStore& getInstance();
+
+    // Static method to check if instance exists
+    static bool hasInstance();
+
+    // Static method to destroy the instance
+    static void destroyInstance();
+
+    // Lifecycle
+    void initialize();
+    void shutdown();
+    void update();
+
+    // Apply the stored state to the Mixer and bound encoders (call after channels are created)
+    bool restore();
+
+    // Write now if anything is pending (e.g. before a restart)
+    void flush();
+
+    // Report a configuration change the Mixer does not see (e.g. encoder direction)
+    void markConfigDirty();
+
+    // Configuration
+    void setSettleTime(unsigned long settleMs);
+
+    // Stats
+    const Stats& getStats() const;
+
+   private:
+    // Stored layout; bump STATE_VERSION when it changes
+    struct StoredState {
+        uint8_t version;
+        uint8_t channelCount;
+        uint8_t animationMode;
+        uint8_t reserved;
+        uint16_t animationTimeConstant;
+        uint16_t reserved2;
+        uint32_t muteMask;
+        uint32_t reversedMask;  // Bit n = encoder bound to channel n is reversed
+        uint8_t targets[Mixer::MAX_CHANNELS];
+    };
+
+    Preferences preferences;
+    bool initialized;
+    unsigned long settleTime;
+
+    bool pending;
+    unsigned long lastChange;
+    StoredState saved;  // What NVS holds now
+    bool hasSaved;
+
+    Stats stats;
+
+    // Internal methods
+    void capture(StoredState& state) const;
+    bool write();
+};
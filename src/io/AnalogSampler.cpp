@@ -0,0 +1,201 @@
+#include "AnalogSampler.hpp"
+#include <driver/adc.h>
+#include "../core/Log.hpp"
+#include "../core/PowerManager.hpp"
+
+// Initialize static member
+AnalogSampler* AnalogSampler::instance = nullptr;
+
+// Private constructor
+AnalogSampler::AnalogSampler() : channelMask(0),
+                                 sampleRate(DEFAULT_SAMPLE_RATE),
+                                 running(false),
+                                 restartPending(false) {
+    for (uint8_t i = 0; i < MAX_CHANNELS; i++) {
+        attenuation[i] = ADC_ATTEN_DB_11;
+        batchSum[i] = 0;
+        batchCount[i] = 0;
+    }
+    memset(&stats, 0, sizeof(stats));
+}
+
+// Destructor
+AnalogSampler::~AnalogSampler() {
+    shutdown();
+}
+
+// Get singleton instance
+AnalogSampler& AnalogSampler::getInstance() {
+    if (instance == nullptr) {
+        instance = new AnalogSampler();
+    }
+    return *instance;
+}
+
+// Check if instance exists
+bool AnalogSampler::hasInstance() {
+    return instance != nullptr;
+}
+
+// Destroy the singleton instance
+void AnalogSampler::destroyInstance() {
+    if (instance != nullptr) {
+        delete instance;
+        instance = nullptr;
+    }
+}
+
+// Lifecycle
+void AnalogSampler::shutdown() {
+    stop();
+    restartPending = false;
+}
+
+void AnalogSampler::update() {
+    if (restartPending) {
+        restartPending = false;
+        stop();
+        if (channelMask != 0) {
+            start();
+        }
+    }
+    if (!running) return;
+
+    // Drain whatever DMA has finished; never wait for more
+    for (uint8_t i = 0; i < MAX_FRAMES_PER_UPDATE; i++) {
+        uint32_t length = 0;
+        esp_err_t result = adc_digi_read_bytes(frame, FRAME_BYTES, &length, 0);
+        if (result == ESP_ERR_INVALID_STATE) {
+            // The ring overran; the bytes returned are still valid samples
+            stats.overflows++;
+        } else if (result != ESP_OK) {
+            break;
+        }
+        if (length == 0) break;
+
+        processFrame(length);
+    }
+}
+
+// Channels
+bool AnalogSampler::addChannel(uint8_t channel, uint8_t atten) {
+    if (channel >= MAX_CHANNELS) return false;
+
+    uint8_t bit = 1 << channel;
+    if ((channelMask & bit) && attenuation[channel] == atten) return true;
+
+    channelMask |= bit;
+    attenuation[channel] = atten;
+    batchSum[channel] = 0;
+    batchCount[channel] = 0;
+    restartPending = true;
+    return true;
+}
+
+void AnalogSampler::removeChannel(uint8_t channel) {
+    if (channel >= MAX_CHANNELS || !(channelMask & (1 << channel))) return;
+
+    channelMask &= ~(1 << channel);
+    restartPending = true;
+}
+
+bool AnalogSampler::isRunning() const {
+    return running;
+}
+
+bool AnalogSampler::takeBatch(uint8_t channel, uint16_t& mean) {
+    if (channel >= MAX_CHANNELS || batchCount[channel] == 0) return false;
+
+    mean = (uint16_t)(((uint64_t)batchSum[channel] << MEAN_FRACTION_BITS) / batchCount[channel]);
+    batchSum[channel] = 0;
+    batchCount[channel] = 0;
+    return true;
+}
+
+// Configuration
+void AnalogSampler::setSampleRate(uint32_t sampleRateHz) {
+    if (sampleRateHz == sampleRate) return;
+
+    sampleRate = sampleRateHz;
+    restartPending = running || channelMask != 0;
+}
+
+// Stats
+const AnalogSampler::Stats& AnalogSampler::getStats() const {
+    return stats;
+}
+
+// Private methods
+
+bool AnalogSampler::start() {
+    adc_digi_pattern_config_t pattern[MAX_CHANNELS];
+    uint8_t patternCount = 0;
+    for (uint8_t channel = 0; channel < MAX_CHANNELS; channel++) {
+        if (!(channelMask & (1 << channel))) continue;
+
+        pattern[patternCount].atten = attenuation[channel];
+        pattern[patternCount].channel = channel;
+        pattern[patternCount].unit = 0;  // ADC1
+        pattern[patternCount].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+        patternCount++;
+    }
+
+    adc_digi_init_config_t initConfig = {};
+    initConfig.max_store_buf_size = BUFFER_BYTES;
+    initConfig.conv_num_each_intr = FRAME_BYTES;
+    initConfig.adc1_chan_mask = channelMask;
+    initConfig.adc2_chan_mask = 0;
+    if (adc_digi_initialize(&initConfig) != ESP_OK) {
+        LOG_ERROR("ADC: Failed to initialize DMA driver");
+        return false;
+    }
+
+    adc_digi_configuration_t digiConfig = {};
+    digiConfig.conv_limit_en = 1;  // Required on ESP32
+    digiConfig.conv_limit_num = 250;
+    digiConfig.pattern_num = patternCount;
+    digiConfig.adc_pattern = pattern;
+    digiConfig.sample_freq_hz = sampleRate;
+    digiConfig.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    digiConfig.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+    // Held before the DMA starts, so a sleep cannot begin with the conversion running
+    PowerManager::getInstance().holdAwake();
+    if (adc_digi_controller_configure(&digiConfig) != ESP_OK || adc_digi_start() != ESP_OK) {
+        LOG_ERROR("ADC: Failed to start continuous sampling");
+        adc_digi_deinitialize();
+        PowerManager::getInstance().releaseAwake();
+        return false;
+    }
+
+    running = true;
+    stats.restarts++;
+    LOG_INFO("ADC: Sampling %u channels at %u Hz", patternCount, sampleRate);
+    return true;
+}
+
+void AnalogSampler::stop() {
+    if (!running) return;
+
+    adc_digi_stop();
+    adc_digi_deinitialize();
+    PowerManager::getInstance().releaseAwake();
+    running = false;
+}
+
+void AnalogSampler::processFrame(uint32_t length) {
+    stats.frames++;
+
+    uint32_t count = length / SOC_ADC_DIGI_RESULT_BYTES;
+    const adc_digi_output_data_t* samples = reinterpret_cast<const adc_digi_output_data_t*>(frame);
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t channel = samples[i].type1.channel;
+        if (channel >= MAX_CHANNELS || !(channelMask & (1 << channel))) continue;
+
+        // Saturate rather than wrap if a device stops collecting its batches
+        if (batchCount[channel] == UINT16_MAX) continue;
+
+        batchSum[channel] += samples[i].type1.data;
+        batchCount[channel]++;
+        stats.samples++;
+    }
+}
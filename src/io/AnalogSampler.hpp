@@ -0,0 +1,91 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Background ADC1 sampling for analog input devices.
+//
+// Runs the ADC in continuous DMA mode over every registered channel, so
+// reading 8 faders costs one buffer copy per update() instead of 8 blocking
+// analogRead() calls. update() drains the finished DMA frames and adds each
+// sample to its channel's running sum. Devices collect that batch with
+// takeBatch(), which returns the oversampled mean and starts a new batch.
+//
+// Only ADC1 channels work in DMA mode (ADC2 is shared with WiFi). Adding or
+// removing a channel restarts the driver on the next update(). The ADC cannot
+// wake the chip, so light sleep is held off while sampling runs.
+class AnalogSampler {
+   private:
+    // Private constructor to prevent direct instantiation
+    AnalogSampler();
+
+    // Static instance pointer
+    static AnalogSampler* instance;
+
+    // Delete copy constructor and assignment operator
+    AnalogSampler(const AnalogSampler&) = delete;
+    AnalogSampler& operator=(const AnalogSampler&) = delete;
+
+   public:
+    static const uint8_t MAX_CHANNELS = 8;                // ADC1 channels 0-7
+    static const uint32_t DEFAULT_SAMPLE_RATE = 20000;    // Hz over all channels (driver minimum on ESP32)
+    static const uint32_t FRAME_BYTES = 256;              // One DMA frame, 128 samples
+    static const uint32_t BUFFER_BYTES = 1024;            // Driver ring buffer, 4 frames
+    static const uint8_t MAX_FRAMES_PER_UPDATE = 4;       // Bounds update() run time
+    static const uint8_t MEAN_FRACTION_BITS = 4;          // Extra resolution the oversampled mean keeps
+
+    struct Stats {
+        uint32_t frames;     // DMA frames processed
+        uint32_t samples;    // Samples added to a batch
+        uint32_t overflows;  // Reads that reported the ring buffer had overrun
+        uint32_t restarts;   // Driver (re)starts after channel changes
+    };
+
+    // Public destructor
+    ~AnalogSampler();
+
+    // Static method to get the singleton instance
+    static AnalogSampler& getInstance();
+
+    // Static method to check if instance exists
+    static bool hasInstance();
+
+    // Static method to destroy the instance
+    static void destroyInstance();
+
+    // Lifecycle (IO::update() calls update() before updating devices)
+    void shutdown();
+    void update();
+
+    // Channels (ADC1 channel numbers; attenuation is an adc_atten_t)
+    bool addChannel(uint8_t channel, uint8_t attenuation);
+    void removeChannel(uint8_t channel);
+    bool isRunning() const;
+
+    // Oversampled mean since the last call, scaled to 12 + MEAN_FRACTION_BITS bits; false if no samples arrived
+    bool takeBatch(uint8_t channel, uint16_t& mean);
+
+    // Configuration
+    void setSampleRate(uint32_t sampleRateHz);
+
+    // Stats
+    const Stats& getStats() const;
+
+   private:
+    uint8_t channelMask;
+    uint8_t attenuation[MAX_CHANNELS];
+    uint32_t sampleRate;
+    bool running;
+    bool restartPending;
+
+    // Per-channel batch since the last takeBatch()
+    uint32_t batchSum[MAX_CHANNELS];
+    uint16_t batchCount[MAX_CHANNELS];
+
+    alignas(4) uint8_t frame[FRAME_BYTES];
+    Stats stats;
+
+    // Internal methods
+    bool start();
+    void stop();
+    void processFrame(uint32_t length);
+};
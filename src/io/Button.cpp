@@ -1,6 +1,6 @@
 #include "Button.hpp"
 
-Button::Button(const String& deviceId, const Config& config)
+Button::Button(const DeviceId& deviceId, const Config& config)
     : TypedInputDevice<Button>(deviceId, DeviceType::BUTTON),
       config(config),
       currentState(false),
@@ -50,6 +50,12 @@ void Button::clearInputFlags() {
     stateChanged = false;
 }
 
+uint8_t Button::getWakePins(int* pins, uint8_t maxPins) const {
+    if (maxPins == 0) return 0;
+    pins[0] = config.pin;
+    return 1;
+}
+
 bool Button::isPressed() const {
     return currentState;
 }
@@ -68,12 +74,12 @@ bool Button::wasReleased() {
 
 unsigned long Button::getPressedDuration() const {
     if (!currentState) return 0;
-    return millis() - lastPressed;
+    return InputLog::now() - lastPressed;
 }
 
 unsigned long Button::getReleasedDuration() const {
     if (currentState) return 0;
-    return millis() - lastReleased;
+    return InputLog::now() - lastReleased;
 }
 
 void Button::setDebounceTime(unsigned long debounceMs) {
@@ -81,37 +87,46 @@ void Button::setDebounceTime(unsigned long debounceMs) {
 }
 
 void Button::setCallback(ButtonCallback callback) {
-    this->callback = callback;
+    callbacks.set(callback);
+}
+
+int Button::addCallback(ButtonCallback callback) {
+    return callbacks.add(callback);
+}
+
+bool Button::removeCallback(int handle) {
+    return callbacks.remove(handle);
 }
 
-std::unique_ptr<Button> Button::create(const String& deviceId, const Config& config) {
+GestureRecognizer& Button::getGestures() {
+    return gestures;
+}
+
+std::unique_ptr<Button> Button::create(const DeviceId& deviceId, const Config& config) {
     return std::unique_ptr<Button>(new Button(deviceId, config));
 }
 
 void Button::setupButton() {
-    if (config.enablePullup) {
-        pinMode(config.pin, INPUT_PULLUP);
-    } else {
-        pinMode(config.pin, INPUT);
-    }
+    configurePin();
 
     // Initialize button state
     currentState = readButtonRaw();
     lastState = currentState;
-    lastStateChange = millis();
+    lastStateChange = InputLog::now();
 
     if (currentState) {
-        lastPressed = millis();
+        lastPressed = InputLog::now();
     } else {
-        lastReleased = millis();
+        lastReleased = InputLog::now();
     }
 
     newInput = false;
 }
 
 void Button::updateButton() {
-    unsigned long currentTime = millis();
-    bool reading = readButtonRaw();
+    unsigned long currentTime = InputLog::now();
+    bool reading = tapRaw(0, false, [this] { return readButtonRaw(); }) != 0;
+    gestures.tick(currentTime);
 
     // Debouncing logic
     if (reading != lastState) {
@@ -124,6 +139,7 @@ void Button::updateButton() {
             currentState = reading;
             stateChanged = true;
             newInput = true;
+            markInput(currentTime);
 
             if (currentState) {
                 pressed = true;
@@ -133,16 +149,23 @@ void Button::updateButton() {
                 lastReleased = currentTime;
             }
 
-            // Call callback if set
-            if (callback) {
-                callback(currentState);
-            }
+            // Notify subscribers
+            callbacks(currentState);
+            gestures.onTransition(currentState, currentTime);
         }
     }
 
     lastState = reading;
 }
 
+void Button::configurePin() {
+    if (config.enablePullup) {
+        pinMode(config.pin, INPUT_PULLUP);
+    } else {
+        pinMode(config.pin, INPUT);
+    }
+}
+
 bool Button::readButtonRaw() {
     bool reading = digitalRead(config.pin);
 
@@ -1,13 +1,14 @@
 #pragma once
 
 #include "InputDevice.hpp"
-#include <functional>
+#include "GestureRecognizer.hpp"
+#include "../core/InplaceFunction.hpp"
 #include <memory>
 
 class Button : public TypedInputDevice<Button> {
    public:
     // Callback type
-    using ButtonCallback = std::function<void(bool pressed)>;
+    using ButtonCallback = InplaceFunction<void(bool pressed)>;
 
     struct Config {
         int pin;
@@ -18,7 +19,7 @@ class Button : public TypedInputDevice<Button> {
         Config() : pin(0), enablePullup(true), activeLow(true), debounceTime(50) {}
     };
 
-    Button(const String& deviceId, const Config& config);
+    Button(const DeviceId& deviceId, const Config& config);
     ~Button() override;
 
     // InputDevice interface
@@ -27,6 +28,7 @@ class Button : public TypedInputDevice<Button> {
     void update() override;
     bool hasNewInput() override;
     void clearInputFlags() override;
+    uint8_t getWakePins(int* pins, uint8_t maxPins) const override;
 
     // Button-specific methods
     bool isPressed() const;
@@ -38,15 +40,25 @@ class Button : public TypedInputDevice<Button> {
     // Configuration methods
     void setDebounceTime(unsigned long debounceMs);
 
-    // Callback methods
+    // Callback methods (set replaces all subscribers; add returns a handle for remove, -1 when full)
     void setCallback(ButtonCallback callback);
+    int addCallback(ButtonCallback callback);
+    bool removeCallback(int handle);
+
+    // Click, double click, long press and repeat, fed by this button's transitions
+    GestureRecognizer& getGestures();
 
     // Static factory method
-    static std::unique_ptr<Button> create(const String& deviceId, const Config& config);
+    static std::unique_ptr<Button> create(const DeviceId& deviceId, const Config& config);
 
-   private:
+   protected:
     Config config;
 
+    // Hardware hooks, overridden by buttons that are not on an ESP32 GPIO
+    virtual void configurePin();
+    virtual bool readButtonRaw();
+
+   private:
     // Button state
     bool currentState;
     bool lastState;
@@ -58,11 +70,11 @@ class Button : public TypedInputDevice<Button> {
     unsigned long lastReleased;
     bool newInput;
 
-    // Callback
-    ButtonCallback callback;
+    // Callbacks
+    CallbackList<void(bool pressed), MAX_CALLBACKS> callbacks;
+    GestureRecognizer gestures;
 
     // Private methods
     void setupButton();
     void updateButton();
-    bool readButtonRaw();
 };
\ No newline at end of file
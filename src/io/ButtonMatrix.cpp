@@ -0,0 +1,251 @@
+#include "ButtonMatrix.hpp"
+#include "../core/Log.hpp"
+
+ButtonMatrix::ButtonMatrix(const DeviceId& deviceId, const Config& config)
+    : TypedInputDevice<ButtonMatrix>(deviceId, DeviceType::KEYPAD),
+      config(config),
+      keyMask(0),
+      debounced(0),
+      count0(0),
+      count1(0),
+      reported(0),
+      heldBack(0),
+      lastScan(0),
+      newInput(false),
+      eventHead(0),
+      eventCount(0) {
+    memset(&stats, 0, sizeof(stats));
+
+    if (this->config.rows > MAX_ROWS) this->config.rows = MAX_ROWS;
+    if (this->config.cols > MAX_COLS) this->config.cols = MAX_COLS;
+
+    uint8_t keys = getKeyCount();
+    keyMask = keys >= 64 ? ~0ULL : (1ULL << keys) - 1;
+}
+
+ButtonMatrix::~ButtonMatrix() {
+    if (initialized) {
+        shutdown();
+    }
+}
+
+bool ButtonMatrix::initialize() {
+    if (initialized) return true;
+
+    if (config.rows == 0 || config.cols == 0) {
+        LOG_ERROR("Matrix: %08lx has no rows or columns", (unsigned long)id.hash());
+        return false;
+    }
+
+    for (uint8_t col = 0; col < config.cols; col++) {
+        pinMode(config.colPins[col], INPUT_PULLUP);
+    }
+
+    // Idle with every row low so any key press shows on its column
+    for (uint8_t row = 0; row < config.rows; row++) {
+        pinMode(config.rowPins[row], OUTPUT_OPEN_DRAIN);
+        digitalWrite(config.rowPins[row], LOW);
+    }
+
+    debounced = 0;
+    count0 = 0;
+    count1 = 0;
+    reported = 0;
+    heldBack = 0;
+    eventHead = 0;
+    eventCount = 0;
+    lastScan = InputLog::now();
+
+    initialized = true;
+    return true;
+}
+
+void ButtonMatrix::shutdown() {
+    if (initialized) {
+        for (uint8_t row = 0; row < config.rows; row++) {
+            pinMode(config.rowPins[row], INPUT);
+        }
+        initialized = false;
+    }
+}
+
+void ButtonMatrix::update() {
+    if (!initialized) return;
+
+    unsigned long now = InputLog::now();
+    if (now - lastScan < config.scanInterval) return;
+    lastScan = now;
+
+    uint32_t start = micros();
+    processScan(scanMatrix(), now);
+
+    stats.lastScanUs = micros() - start;
+    if (stats.lastScanUs > stats.maxScanUs) {
+        stats.maxScanUs = stats.lastScanUs;
+    }
+}
+
+bool ButtonMatrix::hasNewInput() {
+    return newInput;
+}
+
+void ButtonMatrix::clearInputFlags() {
+    newInput = false;
+}
+
+uint8_t ButtonMatrix::getWakePins(int* pins, uint8_t maxPins) const {
+    uint8_t count = 0;
+    for (uint8_t col = 0; col < config.cols && count < maxPins; col++) {
+        pins[count++] = config.colPins[col];
+    }
+    return count;
+}
+
+uint8_t ButtonMatrix::getKeyCount() const {
+    return config.rows * config.cols;
+}
+
+uint8_t ButtonMatrix::keyIndex(uint8_t row, uint8_t col) const {
+    return row * config.cols + col;
+}
+
+bool ButtonMatrix::isPressed(uint8_t key) const {
+    return key < MAX_KEYS && ((reported >> key) & 1);
+}
+
+uint64_t ButtonMatrix::getPressedMask() const {
+    return reported;
+}
+
+bool ButtonMatrix::takeEvent(KeyEvent& event) {
+    if (eventCount == 0) return false;
+
+    event = events[eventHead];
+    eventHead = (eventHead + 1) % EVENT_QUEUE_SIZE;
+    eventCount--;
+    return true;
+}
+
+const ButtonMatrix::Stats& ButtonMatrix::getStats() const {
+    return stats;
+}
+
+void ButtonMatrix::processScan(uint64_t sample, unsigned long timestamp) {
+    stats.scans++;
+
+    // Vertical counter: each key's count0/count1 bits form a 2-bit counter that
+    // advances while the sample differs from the debounced state and resets when
+    // it agrees. The key toggles when its counter wraps back to zero.
+    uint64_t delta = (sample & keyMask) ^ debounced;
+    count1 = (count1 ^ count0) & delta;
+    count0 = ~count0 & delta;
+    debounced ^= delta & ~(count0 | count1);
+
+    // Hold back presses that could be ghosts; releases always go through
+    uint64_t next = debounced;
+    if (!config.hasDiodes) {
+        uint64_t held = findGhostCandidates(debounced) & debounced & ~reported;
+        stats.ghostBlocks += __builtin_popcountll(held & ~heldBack);
+        heldBack = held;
+        next &= ~held;
+    }
+
+    uint64_t changed = next ^ reported;
+    reported = next;
+
+    while (changed) {
+        uint8_t key = __builtin_ctzll(changed);
+        changed &= changed - 1;
+
+        bool pressed = (reported >> key) & 1;
+        pushEvent(key, pressed, timestamp);
+        callbacks(key, pressed);
+    }
+}
+
+void ButtonMatrix::setCallback(KeyCallback callback) {
+    callbacks.set(callback);
+}
+
+int ButtonMatrix::addCallback(KeyCallback callback) {
+    return callbacks.add(callback);
+}
+
+bool ButtonMatrix::removeCallback(int handle) {
+    return callbacks.remove(handle);
+}
+
+std::unique_ptr<ButtonMatrix> ButtonMatrix::create(const DeviceId& deviceId, const Config& config) {
+    return std::unique_ptr<ButtonMatrix>(new ButtonMatrix(deviceId, config));
+}
+
+// Private methods
+
+uint64_t ButtonMatrix::scanMatrix() {
+    uint64_t sample = 0;
+
+    // Release every row, then pull one low at a time
+    for (uint8_t row = 0; row < config.rows; row++) {
+        digitalWrite(config.rowPins[row], HIGH);
+    }
+
+    for (uint8_t row = 0; row < config.rows; row++) {
+        digitalWrite(config.rowPins[row], LOW);
+        delayMicroseconds(config.settleUs);
+
+        uint8_t base = row * config.cols;
+        for (uint8_t col = 0; col < config.cols; col++) {
+            if (digitalRead(config.colPins[col]) == LOW) {
+                sample |= 1ULL << (base + col);
+            }
+        }
+
+        digitalWrite(config.rowPins[row], HIGH);
+    }
+
+    // Back to the idle state so presses can wake us
+    for (uint8_t row = 0; row < config.rows; row++) {
+        digitalWrite(config.rowPins[row], LOW);
+    }
+
+    return sample;
+}
+
+uint64_t ButtonMatrix::findGhostCandidates(uint64_t state) const {
+    uint64_t colMask = (1ULL << config.cols) - 1;
+    uint64_t candidates = 0;
+
+    for (uint8_t a = 0; a + 1 < config.rows; a++) {
+        uint64_t rowA = (state >> (a * config.cols)) & colMask;
+        if (__builtin_popcountll(rowA) < 2) continue;
+
+        for (uint8_t b = a + 1; b < config.rows; b++) {
+            uint64_t shared = rowA & (state >> (b * config.cols));
+            if (__builtin_popcountll(shared) < 2) continue;
+
+            // Two rows with two shared columns: every shared corner is suspect
+            candidates |= shared << (a * config.cols);
+            candidates |= shared << (b * config.cols);
+        }
+    }
+
+    return candidates;
+}
+
+void ButtonMatrix::pushEvent(uint8_t key, bool pressed, unsigned long timestamp) {
+    newInput = true;
+    markInput(timestamp);
+
+    if (eventCount == EVENT_QUEUE_SIZE) {
+        // Drop the oldest; the current state is still in getPressedMask()
+        eventHead = (eventHead + 1) % EVENT_QUEUE_SIZE;
+        eventCount--;
+        stats.droppedEvents++;
+    }
+
+    KeyEvent& event = events[(eventHead + eventCount) % EVENT_QUEUE_SIZE];
+    event.key = key;
+    event.pressed = pressed;
+    event.timestamp = timestamp;
+    eventCount++;
+}
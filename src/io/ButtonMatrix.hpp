@@ -0,0 +1,122 @@
+#pragma once
+
+#include "InputDevice.hpp"
+#include "../core/InplaceFunction.hpp"
+#include <memory>
+
+// Grid of keys wired as a row/column matrix (up to 8x8), e.g. the channel
+// mute/solo keypad.
+//
+// Rows are open-drain outputs and columns are inputs with pullups. A scan
+// pulls one row low at a time and reads the columns, so a full scan costs a
+// fixed rows * (cols + 2) GPIO operations plus one settle delay per row. It
+// runs from update() every scanInterval. Between scans all rows stay low, so
+// any key press pulls its column low and the columns serve as wake pins.
+//
+// All keys are debounced in parallel with a 2-bit vertical counter over
+// one 64-bit word per counter bit. A key changes state after it reads
+// differently for DEBOUNCE_SCANS consecutive scans. The cost does not
+// depend on how many keys are bouncing.
+//
+// Without diodes, three pressed corners of a rectangle make the fourth
+// corner read as pressed (ghosting). When pressed keys in two rows share
+// two or more columns, none of those corners can be trusted. Corners that
+// are not already down are held back until the rectangle breaks, and each
+// such block is counted. Any key combination without a rectangle is
+// reported exactly (n-key rollover). Set hasDiodes to skip the check.
+class ButtonMatrix : public TypedInputDevice<ButtonMatrix> {
+   public:
+    static const uint8_t MAX_ROWS = 8;
+    static const uint8_t MAX_COLS = 8;
+    static const uint8_t MAX_KEYS = MAX_ROWS * MAX_COLS;
+    static const uint8_t DEBOUNCE_SCANS = 4;  // Length of the vertical counter cycle
+    static const uint8_t EVENT_QUEUE_SIZE = 16;
+
+    // Callback type; key = row * cols + col
+    using KeyCallback = InplaceFunction<void(uint8_t key, bool pressed)>;
+
+    struct KeyEvent {
+        uint8_t key;
+        bool pressed;
+        unsigned long timestamp;
+    };
+
+    struct Stats {
+        uint32_t scans;
+        uint32_t ghostBlocks;    // Presses held back by ghosting detection
+        uint32_t droppedEvents;  // Events lost to a full queue
+        uint32_t lastScanUs;     // Time of the last scan and debounce
+        uint32_t maxScanUs;
+    };
+
+    struct Config {
+        int rowPins[MAX_ROWS];
+        int colPins[MAX_COLS];
+        uint8_t rows;
+        uint8_t cols;
+        unsigned long scanInterval;  // ms between scans; debounce time is DEBOUNCE_SCANS * scanInterval
+        uint8_t settleUs;            // Delay between pulling a row low and reading the columns
+        bool hasDiodes;              // Diode per key: no ghosting, skip the check
+
+        Config() : rowPins{}, colPins{}, rows(0), cols(0), scanInterval(5), settleUs(3), hasDiodes(false) {}
+    };
+
+    ButtonMatrix(const DeviceId& deviceId, const Config& config);
+    ~ButtonMatrix() override;
+
+    // InputDevice interface
+    bool initialize() override;
+    void shutdown() override;
+    void update() override;
+    bool hasNewInput() override;
+    void clearInputFlags() override;
+    uint8_t getWakePins(int* pins, uint8_t maxPins) const override;
+
+    // Matrix-specific methods
+    uint8_t getKeyCount() const;
+    uint8_t keyIndex(uint8_t row, uint8_t col) const;
+    bool isPressed(uint8_t key) const;
+    uint64_t getPressedMask() const;  // Bit per key, after ghosting detection
+    bool takeEvent(KeyEvent& event);  // Oldest queued key event, false when empty
+    const Stats& getStats() const;
+
+    // Debounce and ghosting for one raw scan (bit per key); update() calls it after
+    // scanning, and it can be fed directly to replay or benchmark scans
+    void processScan(uint64_t sample, unsigned long timestamp);
+
+    // Callback methods (set replaces all subscribers; add returns a handle for remove, -1 when full)
+    void setCallback(KeyCallback callback);
+    int addCallback(KeyCallback callback);
+    bool removeCallback(int handle);
+
+    // Static factory method
+    static std::unique_ptr<ButtonMatrix> create(const DeviceId& deviceId, const Config& config);
+
+   private:
+    Config config;
+    uint64_t keyMask;  // Bits of keys that exist
+
+    // Vertical counter debounce state
+    uint64_t debounced;
+    uint64_t count0;
+    uint64_t count1;
+
+    uint64_t reported;  // Debounced state minus held-back ghost candidates
+    uint64_t heldBack;  // Ghost candidates held back by the last scan
+    unsigned long lastScan;
+    bool newInput;
+
+    KeyEvent events[EVENT_QUEUE_SIZE];
+    uint8_t eventHead;
+    uint8_t eventCount;
+
+    Stats stats;
+
+    // Callbacks
+    CallbackList<void(uint8_t key, bool pressed), MAX_CALLBACKS> callbacks;
+
+    // Private methods
+    uint64_t scanMatrix();
+    uint64_t findGhostCandidates(uint64_t state) const;
+    void pushEvent(uint8_t key, bool pressed, unsigned long timestamp);
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string.h>
+#include "FrameSink.hpp"
+
+// In-memory FrameSink for running output devices on a host.
+//
+// Every written frame is copied into a buffer a test can inspect, and
+// counted. Real hardware keeps the sink busy while a frame goes out; here a
+// test calls holdBusy(true) to simulate that and check that devices keep the
+// next frame pending instead of waiting. getWireMicros() adds up the time
+// the frames would have taken on a WS2812 line, 30 us per LED plus the latch.
+class CaptureFrameSink : public FrameSink {
+   public:
+    static const size_t MAX_FRAME_BYTES = 3 * 64;
+
+    struct Stats {
+        uint32_t frames;
+        uint32_t rejected;  // Writes refused because the sink was busy
+    };
+
+    CaptureFrameSink() : length(0), busy(false), wireMicros(0) {
+        memset(frame, 0, sizeof(frame));
+        memset(&stats, 0, sizeof(stats));
+    }
+
+    bool write(const uint8_t* data, size_t size) override {
+        if (busy) {
+            stats.rejected++;
+            return false;
+        }
+
+        length = size < MAX_FRAME_BYTES ? size : MAX_FRAME_BYTES;
+        memcpy(frame, data, length);
+        stats.frames++;
+        wireMicros += (uint64_t)size * 8 * 1250 / 1000 + RmtFrameSink::LATCH_MICROS;
+        return true;
+    }
+
+    bool isBusy() const override { return busy; }
+
+    // Simulate a frame still going out
+    void holdBusy(bool hold) { busy = hold; }
+
+    // Last frame written
+    const uint8_t* getFrame() const { return frame; }
+    size_t getFrameLength() const { return length; }
+
+    const Stats& getStats() const { return stats; }
+    uint64_t getWireMicros() const { return wireMicros; }
+
+   private:
+    uint8_t frame[MAX_FRAME_BYTES];
+    size_t length;
+    bool busy;
+    uint64_t wireMicros;
+    Stats stats;
+};
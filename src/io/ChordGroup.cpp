@@ -0,0 +1,97 @@
+#include "ChordGroup.hpp"
+#include "GestureRecognizer.hpp"
+
+ChordGroup::ChordGroup() : pressedMask(0), firedMask(0), chordCount(0), window(DEFAULT_WINDOW) {
+    for (uint8_t i = 0; i < MAX_MEMBERS; i++) {
+        members[i] = nullptr;
+        pressTimes[i] = 0;
+    }
+}
+
+ChordGroup::~ChordGroup() {
+    for (uint8_t i = 0; i < MAX_MEMBERS; i++) {
+        removeMember(i);
+    }
+}
+
+int ChordGroup::addMember(GestureRecognizer& member) {
+    if (member.chordGroup) return -1;
+
+    for (uint8_t i = 0; i < MAX_MEMBERS; i++) {
+        if (!members[i]) {
+            members[i] = &member;
+            member.chordGroup = this;
+            member.chordSlot = i;
+            return i;
+        }
+    }
+    return -1;
+}
+
+void ChordGroup::removeMember(uint8_t slot) {
+    if (slot >= MAX_MEMBERS || !members[slot]) return;
+
+    members[slot]->chordGroup = nullptr;
+    members[slot] = nullptr;
+
+    uint16_t bit = 1 << slot;
+    pressedMask &= ~bit;
+    firedMask &= ~bit;
+}
+
+bool ChordGroup::addChord(uint8_t chordId, uint16_t memberMask) {
+    // A chord needs at least two buttons
+    if (chordCount >= MAX_CHORDS || __builtin_popcount(memberMask) < 2) return false;
+
+    chords[chordCount].mask = memberMask;
+    chords[chordCount].id = chordId;
+    chordCount++;
+    return true;
+}
+
+void ChordGroup::setWindow(unsigned long windowMs) {
+    window = windowMs;
+}
+
+void ChordGroup::setCallback(ChordCallback callback) {
+    this->callback = callback;
+}
+
+// Private methods
+
+void ChordGroup::onMemberTransition(uint8_t slot, bool pressed, unsigned long timestamp) {
+    uint16_t bit = 1 << slot;
+
+    if (!pressed) {
+        pressedMask &= ~bit;
+        firedMask &= ~bit;
+        return;
+    }
+
+    pressedMask |= bit;
+    pressTimes[slot] = timestamp;
+
+    for (uint8_t i = 0; i < chordCount; i++) {
+        uint16_t mask = chords[i].mask;
+        if (!(mask & bit) || (mask & ~pressedMask) || (mask & firedMask)) continue;
+
+        // Every member must have gone down within the window
+        bool together = true;
+        for (uint16_t rest = mask; rest; rest &= rest - 1) {
+            uint8_t member = __builtin_ctz(rest);
+            if (timestamp - pressTimes[member] > window) {
+                together = false;
+                break;
+            }
+        }
+        if (!together) continue;
+
+        firedMask |= mask;
+        for (uint16_t rest = mask; rest; rest &= rest - 1) {
+            members[__builtin_ctz(rest)]->cancel();
+        }
+
+        callback(chords[i].id);
+        return;
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Arduino.h>
+#include "../core/InplaceFunction.hpp"
+
+class GestureRecognizer;
+
+// Recognizes buttons pressed together (e.g. mute + solo) across devices.
+//
+// Members are the GestureRecognizers of up to 16 buttons; chords are masks
+// over member slots. A chord fires when its last member goes down and every
+// member went down within window ms of that press. Chords are checked in
+// the order they were added, and a member taken by a fired chord cannot
+// fire another until it is released. Firing cancels the members' own
+// gestures, so a chord never also produces clicks or long presses.
+class ChordGroup {
+   public:
+    static const uint8_t MAX_MEMBERS = 16;
+    static const uint8_t MAX_CHORDS = 8;
+    static const unsigned long DEFAULT_WINDOW = 80;  // ms between the first and last press of a chord
+
+    // Callback type
+    using ChordCallback = InplaceFunction<void(uint8_t chordId)>;
+
+    ChordGroup();
+    ~ChordGroup();
+
+    // Returns the member slot, -1 if the group is full or the button is in another group
+    int addMember(GestureRecognizer& member);
+    void removeMember(uint8_t slot);
+
+    // memberMask bit n = slot n
+    bool addChord(uint8_t chordId, uint16_t memberMask);
+
+    void setWindow(unsigned long windowMs);
+    void setCallback(ChordCallback callback);
+
+   private:
+    friend class GestureRecognizer;
+
+    struct Chord {
+        uint16_t mask;
+        uint8_t id;
+    };
+
+    GestureRecognizer* members[MAX_MEMBERS];
+    unsigned long pressTimes[MAX_MEMBERS];
+    uint16_t pressedMask;
+    uint16_t firedMask;  // Members held down as part of a fired chord
+
+    Chord chords[MAX_CHORDS];
+    uint8_t chordCount;
+    unsigned long window;
+
+    // Callback
+    ChordCallback callback;
+
+    // Called by members after their own state machine has seen the transition
+    void onMemberTransition(uint8_t slot, bool pressed, unsigned long timestamp);
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <Arduino.h>
+#include <string.h>
+
+// Device identifier stored inline, with its hash computed once.
+//
+// Ids are short names fixed at setup ("volume_encoder"), but they used to be
+// Arduino Strings. Each device and every copy of one meant a heap block.
+// A DeviceId is a plain 32-byte value: copies are memcpy and never
+// allocate. Comparison checks the FNV-1a hash before the text, so a lookup
+// across all devices mostly costs one 32-bit compare per device.
+//
+// Construction from a literal or String is implicit, so call sites keep
+// passing "name". Names longer than MAX_LENGTH are truncated and flagged;
+// IO refuses to register a truncated id.
+class DeviceId {
+   public:
+    static const uint8_t MAX_LENGTH = 25;  // Characters, without the terminator
+
+    DeviceId() : hashValue(FNV_OFFSET), len(0), truncated(false) { text[0] = '\0'; }
+    DeviceId(const char* name) { assign(name, name ? strlen(name) : 0); }
+    DeviceId(const String& name) { assign(name.c_str(), name.length()); }
+
+    const char* c_str() const { return text; }
+    uint8_t length() const { return len; }
+    bool isEmpty() const { return len == 0; }
+    bool isTruncated() const { return truncated; }
+    uint32_t hash() const { return hashValue; }
+
+    bool operator==(const DeviceId& other) const {
+        return hashValue == other.hashValue && len == other.len && memcmp(text, other.text, len) == 0;
+    }
+    bool operator!=(const DeviceId& other) const { return !(*this == other); }
+
+   private:
+    static const uint32_t FNV_OFFSET = 2166136261UL;
+    static const uint32_t FNV_PRIME = 16777619UL;
+
+    uint32_t hashValue;
+    uint8_t len;
+    bool truncated;
+    char text[MAX_LENGTH + 1];
+
+    void assign(const char* name, size_t nameLength) {
+        truncated = nameLength > MAX_LENGTH;
+        len = truncated ? MAX_LENGTH : (uint8_t)nameLength;
+        if (len > 0) {
+            memcpy(text, name, len);
+        }
+        text[len] = '\0';
+
+        hashValue = FNV_OFFSET;
+        for (uint8_t i = 0; i < len; i++) {
+            hashValue = (hashValue ^ (uint8_t)text[i]) * FNV_PRIME;
+        }
+    }
+};
@@ -0,0 +1,28 @@
+#include "ExpanderButton.hpp"
+
+ExpanderButton::ExpanderButton(const DeviceId& deviceId, Mcp23017& expander, const Config& config)
+    : Button(deviceId, config), expander(expander) {
+}
+
+void ExpanderButton::update() {
+    if (!initialized) return;
+
+    expander.service();
+    Button::update();
+}
+
+uint8_t ExpanderButton::getWakePins(int* pins, uint8_t maxPins) const {
+    // Only the expander's INT line can wake the chip
+    if (maxPins == 0 || expander.getInterruptPin() < 0) return 0;
+    pins[0] = expander.getInterruptPin();
+    return 1;
+}
+
+void ExpanderButton::configurePin() {
+    expander.configureInputs(1 << config.pin, config.enablePullup);
+}
+
+bool ExpanderButton::readButtonRaw() {
+    bool reading = (expander.getPins() >> config.pin) & 1;
+    return config.activeLow ? !reading : reading;
+}
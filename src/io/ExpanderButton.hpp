@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Button.hpp"
+#include "Mcp23017.hpp"
+
+// Button on an MCP23017 pin (Config::pin is the expander pin, 0-15).
+//
+// Debouncing and callbacks are the plain Button ones; only the pin access
+// goes through the expander. update() services the expander first, which
+// is a no-op unless its INT line fired or a safety scan is due.
+class ExpanderButton : public Button {
+   public:
+    ExpanderButton(const DeviceId& deviceId, Mcp23017& expander, const Config& config);
+
+    void update() override;
+    uint8_t getWakePins(int* pins, uint8_t maxPins) const override;
+
+   protected:
+    void configurePin() override;
+    bool readButtonRaw() override;
+
+   private:
+    Mcp23017& expander;
+};
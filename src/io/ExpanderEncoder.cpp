@@ -0,0 +1,114 @@
+#include "ExpanderEncoder.hpp"
+#include "../core/Log.hpp"
+
+namespace {
+// Count step indexed by (previous state << 2) | new state; 0 for no change or a skipped state
+const int8_t QUADRATURE_STEPS[16] = {0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1, 0};
+}
+
+ExpanderEncoder::ExpanderEncoder(const DeviceId& deviceId, Mcp23017& expander, const Config& config)
+    : RotaryEncoder(deviceId, config), expander(expander), count(0), lastState(0), lastScanId(0) {
+}
+
+ExpanderEncoder::~ExpanderEncoder() {
+    // Shut down here so the base destructor does not run the GPIO bench teardown
+    if (initialized) {
+        shutdown();
+    }
+}
+
+void ExpanderEncoder::update() {
+    if (!initialized) return;
+
+    expander.service();
+    decodeScan();
+    RotaryEncoder::update();
+}
+
+uint8_t ExpanderEncoder::getWakePins(int* pins, uint8_t maxPins) const {
+    // Only the expander's INT line can wake the chip
+    if (maxPins == 0 || expander.getInterruptPin() < 0) return 0;
+    pins[0] = expander.getInterruptPin();
+    return 1;
+}
+
+void ExpanderEncoder::setBenchMode(bool enable) {
+    if (!initialized || enable == benchMode) return;
+
+    // Decoding already sees every sample, so no edge interrupt or wake lock is needed
+    if (enable) {
+        resetBenchStats();
+        benchMode = true;
+    } else {
+        benchMode = false;
+
+        BenchStats bench = getBenchStats();
+        LOG_INFO("Encoder: %08lx bench %u edges, %u skipped states, %u steps", (unsigned long)getId().hash(),
+                 bench.rawEdges, bench.glitchCount, bench.detentSteps);
+    }
+}
+
+// Protected methods
+
+void ExpanderEncoder::attachCounter() {
+    expander.configureInputs((1 << config.pinA) | (1 << config.pinB), config.enablePullups);
+
+    count = 0;
+    lastState = readState(expander.getPins());
+    lastScanId = expander.getScanId();
+}
+
+void ExpanderEncoder::applyFilter() {
+    // Bounce shorter than a scan is never sampled; there is no hardware filter to set
+}
+
+int64_t ExpanderEncoder::readHardwareCount() const {
+    return count;
+}
+
+void ExpanderEncoder::writeHardwareCount(int64_t newCount) {
+    count = newCount;
+}
+
+void ExpanderEncoder::configureButtonPin() {
+    expander.configureInputs(1 << config.buttonPin, config.enablePullups);
+}
+
+bool ExpanderEncoder::readButtonRaw() {
+    if (!config.hasButton) return false;
+
+    // Button is active LOW when using pullups
+    bool reading = (expander.getPins() >> config.buttonPin) & 1;
+    return config.enablePullups ? !reading : reading;
+}
+
+// Private methods
+
+uint8_t ExpanderEncoder::readState(uint16_t pins) const {
+    return (((pins >> config.pinB) & 1) << 1) | ((pins >> config.pinA) & 1);
+}
+
+void ExpanderEncoder::decodeScan() {
+    uint32_t scanId = expander.getScanId();
+    if (scanId == lastScanId) return;
+    lastScanId = scanId;
+
+    uint16_t samples[Mcp23017::MAX_SAMPLES];
+    uint8_t sampleCount = expander.getScanSamples(samples);
+
+    for (uint8_t i = 0; i < sampleCount; i++) {
+        uint8_t state = readState(samples[i]);
+        if (state == lastState) continue;
+
+        int8_t step = QUADRATURE_STEPS[(lastState << 2) | state];
+        if (benchMode) {
+            benchRawEdges.fetch_add(1, std::memory_order_relaxed);
+            if (step == 0) {
+                benchGlitches.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        count += step;
+        lastState = state;
+    }
+}
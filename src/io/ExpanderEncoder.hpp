@@ -0,0 +1,42 @@
+#pragma once
+
+#include "RotaryEncoder.hpp"
+#include "Mcp23017.hpp"
+
+// Quadrature encoder on two MCP23017 pins (Config::pinA/pinB/buttonPin are
+// expander pins, 0-15).
+//
+// There is no PCNT behind an expander, so the count is decoded in software
+// from every port state a scan yields (up to two per interrupt thanks to
+// INTCAP). Detent quantization, reversal and callbacks are the plain
+// RotaryEncoder ones. Only full quadrature decoding is done; countMode and
+// filterNs are ignored. In bench mode a jump over a state (both pins changed
+// between samples) counts as a glitch, i.e. an edge lost to scan latency.
+class ExpanderEncoder : public RotaryEncoder {
+   public:
+    ExpanderEncoder(const DeviceId& deviceId, Mcp23017& expander, const Config& config);
+    ~ExpanderEncoder() override;
+
+    void update() override;
+    uint8_t getWakePins(int* pins, uint8_t maxPins) const override;
+    void setBenchMode(bool enable) override;
+
+   protected:
+    void attachCounter() override;
+    void applyFilter() override;
+    int64_t readHardwareCount() const override;
+    void writeHardwareCount(int64_t count) override;
+    void configureButtonPin() override;
+    bool readButtonRaw() override;
+
+   private:
+    Mcp23017& expander;
+
+    int64_t count;
+    uint8_t lastState;    // B << 1 | A
+    uint32_t lastScanId;  // Last expander scan decoded
+
+    // Private methods
+    uint8_t readState(uint16_t pins) const;
+    void decodeScan();
+};
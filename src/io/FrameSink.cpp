@@ -0,0 +1,113 @@
+#include "FrameSink.hpp"
+#include "../core/PowerManager.hpp"
+#include <Arduino.h>
+#include <driver/rmt.h>
+
+namespace {
+// 80 MHz APB / 2 = 25 ns per RMT tick
+const uint8_t CLOCK_DIVIDER = 2;
+const uint32_t T0H_TICKS = 16;  // 0.40 us
+const uint32_t T0L_TICKS = 34;  // 0.85 us
+const uint32_t T1H_TICKS = 32;  // 0.80 us
+const uint32_t T1L_TICKS = 18;  // 0.45 us
+
+// The tx-end callback is one per driver, so it finds the sink by channel
+RmtFrameSink* sinks[RMT_CHANNEL_MAX] = {};
+
+// Called by the driver from its interrupt as the RMT memory drains, so a
+// frame of any length goes out from the caller's buffer without a copy
+void translateBits(const void* source, rmt_item32_t* items, size_t sourceSize, size_t wantedItems,
+                   size_t* translatedSize, size_t* itemCount) {
+    rmt_item32_t zero;
+    zero.val = 0;
+    zero.level0 = 1;
+    zero.duration0 = T0H_TICKS;
+    zero.duration1 = T0L_TICKS;
+
+    rmt_item32_t one;
+    one.val = 0;
+    one.level0 = 1;
+    one.duration0 = T1H_TICKS;
+    one.duration1 = T1L_TICKS;
+
+    const uint8_t* bytes = (const uint8_t*)source;
+    size_t size = 0;
+    size_t count = 0;
+    while (size < sourceSize && count + 8 <= wantedItems) {
+        uint8_t byte = bytes[size++];
+        for (uint8_t bit = 0x80; bit != 0; bit >>= 1) {
+            items[count++].val = (byte & bit) ? one.val : zero.val;
+        }
+    }
+
+    *translatedSize = size;
+    *itemCount = count;
+}
+}
+
+RmtFrameSink::RmtFrameSink(int pin, uint8_t channel)
+    : pin(pin), channel(channel), started(false), sending(false), doneMicros(0) {
+}
+
+RmtFrameSink::~RmtFrameSink() {
+    if (started) {
+        rmt_driver_uninstall((rmt_channel_t)channel);
+        sinks[channel] = nullptr;
+
+        // A frame cut off by the uninstall never reports its end
+        if (sending.exchange(false)) {
+            PowerManager::getInstance().releaseAwake();
+        }
+    }
+}
+
+bool RmtFrameSink::begin() {
+    if (started) return true;
+    if (channel >= RMT_CHANNEL_MAX || sinks[channel]) return false;
+
+    rmt_config_t config = RMT_DEFAULT_CONFIG_TX((gpio_num_t)pin, (rmt_channel_t)channel);
+    config.clk_div = CLOCK_DIVIDER;
+    config.tx_config.idle_output_en = true;
+    config.tx_config.idle_level = RMT_IDLE_LEVEL_LOW;
+
+    if (rmt_config(&config) != ESP_OK) return false;
+    if (rmt_driver_install((rmt_channel_t)channel, 0, 0) != ESP_OK) return false;
+    if (rmt_translator_init((rmt_channel_t)channel, translateBits) != ESP_OK) {
+        rmt_driver_uninstall((rmt_channel_t)channel);
+        return false;
+    }
+
+    sinks[channel] = this;
+    rmt_register_tx_end_callback(
+        [](rmt_channel_t doneChannel, void*) {
+            RmtFrameSink* sink = sinks[doneChannel];
+            if (!sink || !sink->sending) return;
+
+            sink->doneMicros = micros();
+            sink->sending = false;
+            PowerManager::getInstance().releaseAwake();
+        },
+        nullptr);
+
+    started = true;
+    return true;
+}
+
+bool RmtFrameSink::write(const uint8_t* data, size_t length) {
+    if (!started || isBusy()) return false;
+
+    // Light sleep would stop the RMT clock mid-frame
+    PowerManager::getInstance().holdAwake();
+    sending = true;
+
+    if (rmt_write_sample((rmt_channel_t)channel, data, length, false) != ESP_OK) {
+        sending = false;
+        PowerManager::getInstance().releaseAwake();
+        return false;
+    }
+    return true;
+}
+
+bool RmtFrameSink::isBusy() const {
+    return sending || micros() - doneMicros < LATCH_MICROS;
+}
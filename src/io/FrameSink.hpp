@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+// Transmitter for the frames of a pixel output device.
+//
+// write() hands over one whole frame and returns at once. The sink may keep
+// reading that buffer until isBusy() turns false, so the caller must leave
+// it untouched until then; output devices double-buffer for this.
+// RmtFrameSink sends WS2812 frames from the RMT peripheral.
+// CaptureFrameSink (CaptureFrameSink.hpp) keeps them in memory, so output
+// devices can run on a host.
+class FrameSink {
+   public:
+    virtual ~FrameSink() = default;
+
+    // Start sending length bytes; false if a frame is still going out
+    virtual bool write(const uint8_t* data, size_t length) = 0;
+
+    // True until the last frame has been sent and the line has latched
+    virtual bool isBusy() const = 0;
+};
+
+class RmtFrameSink : public FrameSink {
+   public:
+    static const uint8_t DEFAULT_CHANNEL = 0;
+    static const uint32_t LATCH_MICROS = 300;  // Low time that latches a frame (WS2812B needs >280 us)
+
+    RmtFrameSink(int pin, uint8_t channel = DEFAULT_CHANNEL);
+    ~RmtFrameSink();
+
+    // Installs the RMT driver; call once before any device writes
+    bool begin();
+
+    bool write(const uint8_t* data, size_t length) override;
+    bool isBusy() const override;
+
+   private:
+    int pin;
+    uint8_t channel;
+    bool started;
+
+    // Set by write(), cleared from the RMT interrupt when the frame is out
+    std::atomic<bool> sending;
+    volatile uint32_t doneMicros;
+};
@@ -0,0 +1,112 @@
+#include "GestureRecognizer.hpp"
+#include "ChordGroup.hpp"
+
+// clang-format off
+const GestureRecognizer::Transition GestureRecognizer::TABLE[STATE_COUNT][EVENT_COUNT] = {
+    //                PRESS                                     RELEASE                                       TIMEOUT
+    /* IDLE */        {{PRESSED, EMIT_NONE, TIMER_LONG_PRESS},  {IDLE, EMIT_NONE, TIMER_KEEP},                {IDLE, EMIT_NONE, TIMER_KEEP}},
+    /* PRESSED */     {{PRESSED, EMIT_NONE, TIMER_KEEP},        {WAIT_SECOND, EMIT_NONE, TIMER_DOUBLE_CLICK}, {HELD, EMIT_LONG_PRESS, TIMER_REPEAT}},
+    /* HELD */        {{HELD, EMIT_NONE, TIMER_KEEP},           {IDLE, EMIT_NONE, TIMER_STOP},                {HELD, EMIT_REPEAT, TIMER_REPEAT}},
+    /* WAIT_SECOND */ {{SECOND, EMIT_DOUBLE_CLICK, TIMER_STOP}, {WAIT_SECOND, EMIT_NONE, TIMER_KEEP},         {IDLE, EMIT_CLICK, TIMER_STOP}},
+    /* SECOND */      {{SECOND, EMIT_NONE, TIMER_KEEP},         {IDLE, EMIT_NONE, TIMER_STOP},                {SECOND, EMIT_NONE, TIMER_STOP}},
+    /* CANCELLED */   {{CANCELLED, EMIT_NONE, TIMER_KEEP},      {IDLE, EMIT_NONE, TIMER_STOP},                {CANCELLED, EMIT_NONE, TIMER_STOP}},
+};
+// clang-format on
+
+GestureRecognizer::GestureRecognizer()
+    : state(IDLE), timerArmed(false), deadline(0), chordGroup(nullptr), chordSlot(0) {
+}
+
+GestureRecognizer::~GestureRecognizer() {
+    if (chordGroup) {
+        chordGroup->removeMember(chordSlot);
+    }
+}
+
+void GestureRecognizer::onTransition(bool pressed, unsigned long timestamp) {
+    dispatch(pressed ? PRESS : RELEASE, timestamp);
+
+    // The chord group may cancel this button, so it sees the press after the table has
+    if (chordGroup) {
+        chordGroup->onMemberTransition(chordSlot, pressed, timestamp);
+    }
+}
+
+void GestureRecognizer::setTiming(const Timing& timing) {
+    this->timing = timing;
+}
+
+const GestureRecognizer::Timing& GestureRecognizer::getTiming() const {
+    return timing;
+}
+
+void GestureRecognizer::setCallback(GestureCallback callback) {
+    this->callback = callback;
+}
+
+void GestureRecognizer::cancel() {
+    if (state == IDLE || state == WAIT_SECOND) {
+        // Not down: nothing to wait for, just drop a pending click
+        state = IDLE;
+    } else {
+        state = CANCELLED;
+    }
+    timerArmed = false;
+}
+
+// Private methods
+
+void GestureRecognizer::dispatch(Event event, unsigned long now) {
+    const Transition& transition = TABLE[state][event];
+    state = transition.next;
+    armTimer(transition.timer, now);
+
+    switch (transition.emit) {
+        case EMIT_CLICK:
+            callback(Gesture::CLICK);
+            break;
+        case EMIT_DOUBLE_CLICK:
+            callback(Gesture::DOUBLE_CLICK);
+            break;
+        case EMIT_LONG_PRESS:
+            callback(Gesture::LONG_PRESS);
+            break;
+        case EMIT_REPEAT:
+            callback(Gesture::REPEAT);
+            break;
+        case EMIT_NONE:
+            break;
+    }
+
+    // Without a double click window the click is final on release
+    if (transition.timer == TIMER_DOUBLE_CLICK && timing.doubleClickTime == 0) {
+        dispatch(TIMEOUT, now);
+    }
+}
+
+void GestureRecognizer::armTimer(Timer timer, unsigned long now) {
+    unsigned long duration = 0;
+    switch (timer) {
+        case TIMER_KEEP:
+            return;
+        case TIMER_STOP:
+            break;
+        case TIMER_LONG_PRESS:
+            duration = timing.longPressTime;
+            break;
+        case TIMER_REPEAT:
+            duration = timing.repeatInterval;
+            break;
+        case TIMER_DOUBLE_CLICK:
+            duration = timing.doubleClickTime;
+            break;
+    }
+
+    timerArmed = duration > 0;
+    deadline = now + duration;
+}
+
+void GestureRecognizer::onTimeout(unsigned long now) {
+    timerArmed = false;
+    dispatch(TIMEOUT, now);
+}
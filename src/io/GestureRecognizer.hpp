@@ -0,0 +1,114 @@
+#pragma once
+
+#include <Arduino.h>
+#include "../core/InplaceFunction.hpp"
+
+class ChordGroup;
+
+// Turns the debounced press/release transitions of one button into
+// gestures: click, double click, long press and repeat-while-held.
+//
+// The recognizer is a state machine driven by a const transition table
+// indexed by [state][event]. Each entry gives the next state, the gesture to
+// emit and the timer to arm. It is fed from the button's own update:
+// onTransition() when the debounced state changes, and tick() on every pass,
+// which costs a single compare unless the one pending deadline has passed.
+// No extra polling job is needed and nothing is allocated.
+//
+// With doubleClickTime set, a click is reported once that window has passed
+// without a second press. Set it to 0 to report clicks on release. A zero
+// longPressTime or repeatInterval disables that gesture.
+//
+// A button can also be a member of a ChordGroup. When the group completes a
+// chord, the member's own gesture is cancelled until it is released.
+class GestureRecognizer {
+   public:
+    enum class Gesture : uint8_t {
+        CLICK,
+        DOUBLE_CLICK,  // On the second press
+        LONG_PRESS,
+        REPEAT         // Every repeatInterval while held after a long press
+    };
+
+    // Callback type
+    using GestureCallback = InplaceFunction<void(Gesture gesture)>;
+
+    struct Timing {
+        unsigned long longPressTime;    // ms held before LONG_PRESS, 0 disables
+        unsigned long repeatInterval;   // ms between REPEATs, 0 disables
+        unsigned long doubleClickTime;  // ms after a release to wait for a second press, 0 disables
+
+        Timing() : longPressTime(500), repeatInterval(100), doubleClickTime(250) {}
+    };
+
+    GestureRecognizer();
+    ~GestureRecognizer();
+
+    GestureRecognizer(const GestureRecognizer&) = delete;
+    GestureRecognizer& operator=(const GestureRecognizer&) = delete;
+
+    // Feed from the owning device
+    void onTransition(bool pressed, unsigned long timestamp);
+    void tick(unsigned long now) {
+        if (timerArmed && (long)(now - deadline) >= 0) {
+            onTimeout(now);
+        }
+    }
+
+    // Configuration
+    void setTiming(const Timing& timing);
+    const Timing& getTiming() const;
+    void setCallback(GestureCallback callback);
+
+    // Drop the gesture in progress and ignore the button until it is released
+    void cancel();
+
+   private:
+    friend class ChordGroup;
+
+    enum State : uint8_t {
+        IDLE,
+        PRESSED,      // Down, waiting for long press
+        HELD,         // Long press fired, repeating
+        WAIT_SECOND,  // Released, waiting for a second press
+        SECOND,       // Second press of a double click, down
+        CANCELLED,    // Taken by a chord, waiting for release
+        STATE_COUNT
+    };
+
+    enum Event : uint8_t { PRESS, RELEASE, TIMEOUT, EVENT_COUNT };
+
+    enum Timer : uint8_t {
+        TIMER_KEEP,  // Leave the pending deadline alone
+        TIMER_STOP,
+        TIMER_LONG_PRESS,
+        TIMER_REPEAT,
+        TIMER_DOUBLE_CLICK
+    };
+
+    enum Emit : uint8_t { EMIT_NONE, EMIT_CLICK, EMIT_DOUBLE_CLICK, EMIT_LONG_PRESS, EMIT_REPEAT };
+
+    struct Transition {
+        State next;
+        Emit emit;
+        Timer timer;
+    };
+
+    static const Transition TABLE[STATE_COUNT][EVENT_COUNT];
+
+    Timing timing;
+    State state;
+    bool timerArmed;
+    unsigned long deadline;
+
+    ChordGroup* chordGroup;
+    uint8_t chordSlot;
+
+    // Callback
+    GestureCallback callback;
+
+    // Private methods
+    void dispatch(Event event, unsigned long now);
+    void armTimer(Timer timer, unsigned long now);
+    void onTimeout(unsigned long now);
+};
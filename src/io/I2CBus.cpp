@@ -0,0 +1,30 @@
+#include "I2CBus.hpp"
+#include <Wire.h>
+
+WireI2CBus::WireI2CBus(TwoWire& wire, int sdaPin, int sclPin, uint32_t clockHz)
+    : wire(wire), sdaPin(sdaPin), sclPin(sclPin), clockHz(clockHz) {
+}
+
+bool WireI2CBus::begin() {
+    return wire.begin(sdaPin, sclPin, clockHz);
+}
+
+bool WireI2CBus::write(uint8_t address, uint8_t reg, const uint8_t* data, size_t length) {
+    wire.beginTransmission(address);
+    wire.write(reg);
+    wire.write(data, length);
+    return wire.endTransmission() == 0;
+}
+
+bool WireI2CBus::read(uint8_t address, uint8_t reg, uint8_t* data, size_t length) {
+    // Repeated start keeps the register pointer and the read in one transaction
+    wire.beginTransmission(address);
+    wire.write(reg);
+    if (wire.endTransmission(false) != 0) return false;
+
+    if (wire.requestFrom(address, (uint8_t)length) != length) return false;
+    for (size_t i = 0; i < length; i++) {
+        data[i] = wire.read();
+    }
+    return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+class TwoWire;
+
+// Register-level I2C access for expander drivers.
+//
+// Drivers only ever write or burst-read consecutive registers of one
+// device, so that is all the interface offers. WireI2CBus runs it over
+// an Arduino TwoWire port. MockI2CBus (MockI2CBus.hpp) backs it with
+// plain memory, so drivers can run on a host.
+class I2CBus {
+   public:
+    virtual ~I2CBus() = default;
+
+    // Write length bytes starting at reg
+    virtual bool write(uint8_t address, uint8_t reg, const uint8_t* data, size_t length) = 0;
+
+    // Read length bytes starting at reg in one transaction
+    virtual bool read(uint8_t address, uint8_t reg, uint8_t* data, size_t length) = 0;
+};
+
+class WireI2CBus : public I2CBus {
+   public:
+    static const uint32_t DEFAULT_CLOCK = 400000;  // Hz, fast mode
+
+    WireI2CBus(TwoWire& wire, int sdaPin = -1, int sclPin = -1, uint32_t clockHz = DEFAULT_CLOCK);
+
+    // Starts the port; call once before any driver uses the bus
+    bool begin();
+
+    bool write(uint8_t address, uint8_t reg, const uint8_t* data, size_t length) override;
+    bool read(uint8_t address, uint8_t reg, uint8_t* data, size_t length) override;
+
+   private:
+    TwoWire& wire;
+    int sdaPin;
+    int sclPin;
+    uint32_t clockHz;
+};
@@ -1,4 +1,7 @@
 #include "IO.hpp"
+#include "AnalogSampler.hpp"
+#include "InputLog.hpp"
+#include "../core/Log.hpp"
 #include <Arduino.h>
 #include <type_traits>
 #include <memory>
@@ -7,7 +10,7 @@
 IO* IO::instance = nullptr;
 
 // Private constructor
-IO::IO() : initialized(false) {
+IO::IO() : initialized(false), lastInputTime(0), deviceRevision(0) {
     // Constructor implementation
 }
 
@@ -46,18 +49,33 @@ void IO::initialize() {
         for (auto& device : devices) {
             device->initialize();
         }
+        for (auto& output : outputs) {
+            output->initialize();
+        }
         initialized = true;
+        publishDeviceList();
     }
 }
 
 // Shutdown the IO system
 void IO::shutdown() {
     if (initialized) {
+        if (InputLog::hasInstance()) {
+            InputLog::getInstance().stop();
+        }
+
         // Shutdown all devices
         for (auto& device : devices) {
             device->shutdown();
         }
+        if (AnalogSampler::hasInstance()) {
+            AnalogSampler::getInstance().shutdown();
+        }
+        for (auto& output : outputs) {
+            output->shutdown();
+        }
         initialized = false;
+        publishDeviceList();
     }
 }
 
@@ -65,15 +83,34 @@ void IO::shutdown() {
 void IO::update() {
     if (!initialized) return;
 
+    // Collect finished ADC DMA frames before analog devices read their batches
+    if (AnalogSampler::hasInstance()) {
+        AnalogSampler::getInstance().update();
+    }
+
+    // Timestamp this pass for a recording, or apply the logged input due by now
+    if (InputLog::hasInstance()) {
+        InputLog::getInstance().update();
+    }
+
     // Update all devices and check for new input
     for (auto& device : devices) {
+        uint32_t inputCount = device->getInputCount();
         device->update();
 
+        // Remember when the last real input event happened
+        if (device->getInputCount() != inputCount) {
+            lastInputTime = device->getLastInputTime();
+        }
+
         // Call global callback if device has new input
-        if (device->hasNewInput() && globalCallback) {
-            globalCallback(device->getId(), device->getType());
+        if (device->hasNewInput() && !globalCallbacks.empty()) {
+            globalCallbacks(device->getId(), device->getType());
         }
     }
+
+    // Retry frames that found their transmitter busy
+    updateOutputs();
 }
 
 // Device management methods
@@ -86,67 +123,85 @@ T* IO::addDevice(std::unique_ptr<T> device) {
         return nullptr;  // Device ID must be unique
     }
 
-    T* rawPtr = device.get();
-    size_t index = devices.size();
+    // A cut-off id could collide with another device's, or not match what the caller looks up
+    if (device->getId().isTruncated()) {
+        // The id text dies with the device, so log its hash rather than a pointer into it
+        LOG_ERROR("IO: Device id %08lx is longer than %u characters", (unsigned long)device->getId().hash(),
+                  (unsigned)DeviceId::MAX_LENGTH);
+        return nullptr;
+    }
 
+    T* rawPtr = device.get();
     devices.push_back(std::move(device));
-    deviceMap[rawPtr->getId()] = index;
+    deviceRevision++;
 
     // If already initialized, initialize the new device
     if (initialized) {
         rawPtr->initialize();
     }
+    publishDeviceList();
 
     return rawPtr;
 }
 
-InputDevice* IO::getDevice(const String& deviceId) {
-    auto it = deviceMap.find(deviceId);
-    if (it != deviceMap.end()) {
-        return devices[it->second].get();
-    }
-    return nullptr;
+InputDevice* IO::getDevice(const DeviceId& deviceId) {
+    size_t index = findDeviceIndex(deviceId);
+    return index != SIZE_MAX ? devices[index].get() : nullptr;
 }
 
-bool IO::removeDevice(const String& deviceId) {
-    auto it = deviceMap.find(deviceId);
-    if (it != deviceMap.end()) {
-        size_t indexToRemove = it->second;
+bool IO::removeDevice(const DeviceId& deviceId) {
+    size_t indexToRemove = findDeviceIndex(deviceId);
+    if (indexToRemove != SIZE_MAX) {
 
         // Shutdown device before removal
         devices[indexToRemove]->shutdown();
 
-        // Remove from vector (this invalidates indices)
         devices.erase(devices.begin() + indexToRemove);
-
-        // Rebuild deviceMap since indices changed
-        deviceMap.clear();
-        for (size_t i = 0; i < devices.size(); ++i) {
-            deviceMap[devices[i]->getId()] = i;
-        }
+        deviceRevision++;
+        publishDeviceList();
 
         return true;
     }
     return false;
 }
 
-bool IO::hasDevice(const String& deviceId) {
-    return deviceMap.find(deviceId) != deviceMap.end();
+bool IO::hasDevice(const DeviceId& deviceId) {
+    return findDeviceIndex(deviceId) != SIZE_MAX;
 }
 
 // Convenience methods for common device types
-RotaryEncoder* IO::addRotaryEncoder(const String& deviceId, const RotaryEncoder::Config& config) {
+RotaryEncoder* IO::addRotaryEncoder(const DeviceId& deviceId, const RotaryEncoder::Config& config) {
     return addDevice(std::unique_ptr<RotaryEncoder>(new RotaryEncoder(deviceId, config)));
 }
 
-Button* IO::addButton(const String& deviceId, const Button::Config& config) {
+Button* IO::addButton(const DeviceId& deviceId, const Button::Config& config) {
     return addDevice(std::unique_ptr<Button>(new Button(deviceId, config)));
 }
 
-RotaryEncoder* IO::getRotaryEncoder(const String& deviceId) {
-    auto it = deviceMap.find(deviceId);
-    if (it != deviceMap.end()) {
-        InputDevice* device = devices[it->second].get();
+Potentiometer* IO::addPotentiometer(const DeviceId& deviceId, const Potentiometer::Config& config) {
+    return addDevice(std::unique_ptr<Potentiometer>(new Potentiometer(deviceId, config)));
+}
+
+Joystick* IO::addJoystick(const DeviceId& deviceId, const Joystick::Config& config) {
+    return addDevice(std::unique_ptr<Joystick>(new Joystick(deviceId, config)));
+}
+
+ButtonMatrix* IO::addButtonMatrix(const DeviceId& deviceId, const ButtonMatrix::Config& config) {
+    return addDevice(std::unique_ptr<ButtonMatrix>(new ButtonMatrix(deviceId, config)));
+}
+
+RotaryEncoder* IO::addExpanderEncoder(const DeviceId& deviceId, Mcp23017& expander, const RotaryEncoder::Config& config) {
+    return addDevice(std::unique_ptr<RotaryEncoder>(new ExpanderEncoder(deviceId, expander, config)));
+}
+
+Button* IO::addExpanderButton(const DeviceId& deviceId, Mcp23017& expander, const Button::Config& config) {
+    return addDevice(std::unique_ptr<Button>(new ExpanderButton(deviceId, expander, config)));
+}
+
+RotaryEncoder* IO::getRotaryEncoder(const DeviceId& deviceId) {
+    size_t index = findDeviceIndex(deviceId);
+    if (index != SIZE_MAX) {
+        InputDevice* device = devices[index].get();
         if (device->getType() == InputDevice::DeviceType::ENCODER) {
             return static_cast<RotaryEncoder*>(device);
         }
@@ -154,10 +209,10 @@ RotaryEncoder* IO::getRotaryEncoder(const String& deviceId) {
     return nullptr;
 }
 
-Button* IO::getButton(const String& deviceId) {
-    auto it = deviceMap.find(deviceId);
-    if (it != deviceMap.end()) {
-        InputDevice* device = devices[it->second].get();
+Button* IO::getButton(const DeviceId& deviceId) {
+    size_t index = findDeviceIndex(deviceId);
+    if (index != SIZE_MAX) {
+        InputDevice* device = devices[index].get();
         if (device->getType() == InputDevice::DeviceType::BUTTON) {
             return static_cast<Button*>(device);
         }
@@ -165,6 +220,99 @@ Button* IO::getButton(const String& deviceId) {
     return nullptr;
 }
 
+Potentiometer* IO::getPotentiometer(const DeviceId& deviceId) {
+    size_t index = findDeviceIndex(deviceId);
+    if (index != SIZE_MAX) {
+        InputDevice* device = devices[index].get();
+        if (device->getType() == InputDevice::DeviceType::POTENTIOMETER) {
+            return static_cast<Potentiometer*>(device);
+        }
+    }
+    return nullptr;
+}
+
+Joystick* IO::getJoystick(const DeviceId& deviceId) {
+    size_t index = findDeviceIndex(deviceId);
+    if (index != SIZE_MAX) {
+        InputDevice* device = devices[index].get();
+        if (device->getType() == InputDevice::DeviceType::JOYSTICK) {
+            return static_cast<Joystick*>(device);
+        }
+    }
+    return nullptr;
+}
+
+ButtonMatrix* IO::getButtonMatrix(const DeviceId& deviceId) {
+    size_t index = findDeviceIndex(deviceId);
+    if (index != SIZE_MAX) {
+        InputDevice* device = devices[index].get();
+        if (device->getType() == InputDevice::DeviceType::KEYPAD) {
+            return static_cast<ButtonMatrix*>(device);
+        }
+    }
+    return nullptr;
+}
+
+// Output devices
+template <typename T>
+T* IO::addOutputDevice(std::unique_ptr<T> device) {
+    if (!device) return nullptr;
+
+    // Output IDs must be unique among outputs, and whole
+    if (getOutputDevice(device->getId()) || device->getId().isTruncated()) {
+        return nullptr;
+    }
+
+    T* rawPtr = device.get();
+    outputs.push_back(std::move(device));
+
+    // If already initialized, initialize the new device
+    if (initialized) {
+        rawPtr->initialize();
+    }
+
+    return rawPtr;
+}
+
+OutputDevice* IO::getOutputDevice(const DeviceId& deviceId) {
+    for (auto& output : outputs) {
+        if (output->getId() == deviceId) {
+            return output.get();
+        }
+    }
+    return nullptr;
+}
+
+LedRing* IO::addLedRing(const DeviceId& deviceId, FrameSink& sink, const LedRing::Config& config) {
+    return addOutputDevice(LedRing::create(deviceId, sink, config));
+}
+
+LedRing* IO::getLedRing(const DeviceId& deviceId) {
+    OutputDevice* output = getOutputDevice(deviceId);
+    if (output && output->getType() == OutputDevice::DeviceType::LED_RING) {
+        return static_cast<LedRing*>(output);
+    }
+    return nullptr;
+}
+
+std::vector<OutputDevice*> IO::getOutputDevices() {
+    std::vector<OutputDevice*> result;
+    for (auto& output : outputs) {
+        result.push_back(output.get());
+    }
+    return result;
+}
+
+void IO::updateOutputs() {
+    if (!initialized) return;
+
+    for (auto& output : outputs) {
+        if (output->hasPendingOutput()) {
+            output->update();
+        }
+    }
+}
+
 // Get devices by type
 std::vector<RotaryEncoder*> IO::getRotaryEncoders() {
     std::vector<RotaryEncoder*> result;
@@ -186,6 +334,36 @@ std::vector<Button*> IO::getButtons() {
     return result;
 }
 
+std::vector<Potentiometer*> IO::getPotentiometers() {
+    std::vector<Potentiometer*> result;
+    for (auto& device : devices) {
+        if (device->getType() == InputDevice::DeviceType::POTENTIOMETER) {
+            result.push_back(static_cast<Potentiometer*>(device.get()));
+        }
+    }
+    return result;
+}
+
+std::vector<Joystick*> IO::getJoysticks() {
+    std::vector<Joystick*> result;
+    for (auto& device : devices) {
+        if (device->getType() == InputDevice::DeviceType::JOYSTICK) {
+            result.push_back(static_cast<Joystick*>(device.get()));
+        }
+    }
+    return result;
+}
+
+std::vector<ButtonMatrix*> IO::getButtonMatrices() {
+    std::vector<ButtonMatrix*> result;
+    for (auto& device : devices) {
+        if (device->getType() == InputDevice::DeviceType::KEYPAD) {
+            result.push_back(static_cast<ButtonMatrix*>(device.get()));
+        }
+    }
+    return result;
+}
+
 // Template method for getting devices of specific type
 template <typename T>
 std::vector<T*> IO::getDevicesOfType() {
@@ -215,6 +393,16 @@ void IO::clearAllInputFlags() {
     }
 }
 
+// Activity tracking
+unsigned long IO::getLastInputTime() const {
+    return lastInputTime;
+}
+
+unsigned long IO::getIdleTime() const {
+    // Input times come from the device clock, which runs ahead of millis() after a fast replay
+    return InputLog::now() - lastInputTime;
+}
+
 // Device iteration
 std::vector<InputDevice*> IO::getAllDevices() {
     std::vector<InputDevice*> result;
@@ -224,27 +412,68 @@ std::vector<InputDevice*> IO::getAllDevices() {
     return result;
 }
 
-std::vector<String> IO::getDeviceIds() {
-    std::vector<String> result;
+std::vector<DeviceId> IO::getDeviceIds() {
+    std::vector<DeviceId> result;
+    result.reserve(devices.size());
     for (auto& device : devices) {
         result.push_back(device->getId());
     }
     return result;
 }
 
+uint32_t IO::getDeviceRevision() const {
+    return deviceRevision;
+}
+
+bool IO::readDeviceList(DeviceList& list) const {
+    return deviceList.read(list);
+}
+
+uint32_t IO::getDeviceListVersion() const {
+    return deviceList.getVersion();
+}
+
 // Event system
 void IO::setGlobalInputCallback(GlobalInputCallback callback) {
-    globalCallback = callback;
+    globalCallbacks.set(callback);
+}
+
+int IO::addGlobalInputCallback(GlobalInputCallback callback) {
+    return globalCallbacks.add(callback);
+}
+
+bool IO::removeGlobalInputCallback(int handle) {
+    return globalCallbacks.remove(handle);
 }
 
 // Private helper methods
-size_t IO::findDeviceIndex(const String& deviceId) {
-    auto it = deviceMap.find(deviceId);
-    return (it != deviceMap.end()) ? it->second : SIZE_MAX;
+size_t IO::findDeviceIndex(const DeviceId& deviceId) {
+    // A handful of devices: a scan comparing precomputed hashes beats a map and allocates nothing
+    for (size_t i = 0; i < devices.size(); ++i) {
+        if (devices[i]->getId() == deviceId) {
+            return i;
+        }
+    }
+    return SIZE_MAX;
+}
+
+// Control task only: Seqlock has a single writer
+void IO::publishDeviceList() {
+    DeviceList list = {};
+    for (auto& device : devices) {
+        if (list.count == MAX_LISTED_DEVICES) break;
+
+        DeviceInfo& info = list.devices[list.count++];
+        memcpy(info.id, device->getId().c_str(), device->getId().length() + 1);
+        info.type = device->getType();
+        info.initialized = device->isInitialized();
+    }
+    deviceList.write(list);
 }
 
 // Explicit template instantiations for common types
 template RotaryEncoder* IO::addDevice<RotaryEncoder>(std::unique_ptr<RotaryEncoder> device);
 template Button* IO::addDevice<Button>(std::unique_ptr<Button> device);
+template LedRing* IO::addOutputDevice<LedRing>(std::unique_ptr<LedRing> device);
 template std::vector<RotaryEncoder*> IO::getDevicesOfType<RotaryEncoder>();
 template std::vector<Button*> IO::getDevicesOfType<Button>();
@@ -3,10 +3,17 @@
 #include "InputDevice.hpp"
 #include "RotaryEncoder.hpp"
 #include "Button.hpp"
+#include "Potentiometer.hpp"
+#include "Joystick.hpp"
+#include "ButtonMatrix.hpp"
+#include "ExpanderButton.hpp"
+#include "ExpanderEncoder.hpp"
+#include "OutputDevice.hpp"
+#include "LedRing.hpp"
 #include <vector>
 #include <memory>
-#include <map>
-#include <functional>
+#include "../core/InplaceFunction.hpp"
+#include "../core/Seqlock.hpp"
 
 class IO {
    private:
@@ -42,20 +49,40 @@ class IO {
     template <typename T>
     T* addDevice(std::unique_ptr<T> device);
 
-    InputDevice* getDevice(const String& deviceId);
-    bool removeDevice(const String& deviceId);
-    bool hasDevice(const String& deviceId);
+    InputDevice* getDevice(const DeviceId& deviceId);
+    bool removeDevice(const DeviceId& deviceId);
+    bool hasDevice(const DeviceId& deviceId);
 
     // Convenience methods for common device types
-    RotaryEncoder* addRotaryEncoder(const String& deviceId, const RotaryEncoder::Config& config = {});
-    Button* addButton(const String& deviceId, const Button::Config& config);
-
-    RotaryEncoder* getRotaryEncoder(const String& deviceId);
-    Button* getButton(const String& deviceId);
+    RotaryEncoder* addRotaryEncoder(const DeviceId& deviceId, const RotaryEncoder::Config& config = {});
+    Button* addButton(const DeviceId& deviceId, const Button::Config& config);
+    Potentiometer* addPotentiometer(const DeviceId& deviceId, const Potentiometer::Config& config);
+    Joystick* addJoystick(const DeviceId& deviceId, const Joystick::Config& config);
+    ButtonMatrix* addButtonMatrix(const DeviceId& deviceId, const ButtonMatrix::Config& config);
+    RotaryEncoder* addExpanderEncoder(const DeviceId& deviceId, Mcp23017& expander, const RotaryEncoder::Config& config);
+    Button* addExpanderButton(const DeviceId& deviceId, Mcp23017& expander, const Button::Config& config);
+
+    RotaryEncoder* getRotaryEncoder(const DeviceId& deviceId);
+    Button* getButton(const DeviceId& deviceId);
+    Potentiometer* getPotentiometer(const DeviceId& deviceId);
+    Joystick* getJoystick(const DeviceId& deviceId);
+    ButtonMatrix* getButtonMatrix(const DeviceId& deviceId);
+
+    // Output devices (pushed from update(), and from updateOutputs() right after drawing)
+    template <typename T>
+    T* addOutputDevice(std::unique_ptr<T> device);
+    OutputDevice* getOutputDevice(const DeviceId& deviceId);
+    LedRing* addLedRing(const DeviceId& deviceId, FrameSink& sink, const LedRing::Config& config = {});
+    LedRing* getLedRing(const DeviceId& deviceId);
+    std::vector<OutputDevice*> getOutputDevices();
+    void updateOutputs();
 
     // Get devices by type
     std::vector<RotaryEncoder*> getRotaryEncoders();
     std::vector<Button*> getButtons();
+    std::vector<Potentiometer*> getPotentiometers();
+    std::vector<Joystick*> getJoysticks();
+    std::vector<ButtonMatrix*> getButtonMatrices();
 
     // Template method for getting devices of specific type
     template <typename T>
@@ -65,22 +92,49 @@ class IO {
     bool hasNewInput();
     void clearAllInputFlags();
 
+    // Activity tracking (InputLog::now() of the most recent input event on any device)
+    unsigned long getLastInputTime() const;
+    unsigned long getIdleTime() const;
+
     // Device iteration
     std::vector<InputDevice*> getAllDevices();
-    std::vector<String> getDeviceIds();
+    std::vector<DeviceId> getDeviceIds();
+    uint32_t getDeviceRevision() const;  // Changes whenever devices are added or removed
+
+    // Copy of the device table for other tasks, which must not touch the
+    // devices themselves: the control task may free one at any time. It is
+    // republished on every add, remove, initialize and shutdown.
+    static const uint8_t MAX_LISTED_DEVICES = 16;
+    struct DeviceInfo {
+        char id[DeviceId::MAX_LENGTH + 1];
+        InputDevice::DeviceType type;
+        bool initialized;
+    };
+    struct DeviceList {
+        uint8_t count;
+        DeviceInfo devices[MAX_LISTED_DEVICES];
+    };
+    bool readDeviceList(DeviceList& list) const;  // Any task; false if a publish kept overlapping the copy
+    uint32_t getDeviceListVersion() const;        // Any task; changes with every publish
 
     // Event system
-    using GlobalInputCallback = std::function<void(const String& deviceId, InputDevice::DeviceType type)>;
-    void setGlobalInputCallback(GlobalInputCallback callback);
+    using GlobalInputCallback = InplaceFunction<void(const DeviceId& deviceId, InputDevice::DeviceType type)>;
+    void setGlobalInputCallback(GlobalInputCallback callback);  // Replaces all subscribers
+    int addGlobalInputCallback(GlobalInputCallback callback);  // Handle for remove, -1 when full
+    bool removeGlobalInputCallback(int handle);
 
    private:
     // Device storage
-    std::vector<std::unique_ptr<InputDevice>> devices;
-    std::map<String, size_t> deviceMap;  // deviceId -> index in devices vector
+    std::vector<std::unique_ptr<InputDevice>> devices;  // Looked up by id hash, see findDeviceIndex
+    std::vector<std::unique_ptr<OutputDevice>> outputs;
 
     bool initialized;
-    GlobalInputCallback globalCallback;
+    CallbackList<void(const DeviceId& deviceId, InputDevice::DeviceType type), InputDevice::MAX_CALLBACKS> globalCallbacks;
+    unsigned long lastInputTime;
+    uint32_t deviceRevision;
+    Seqlock<DeviceList> deviceList;
 
     // Helper methods
-    size_t findDeviceIndex(const String& deviceId);
+    size_t findDeviceIndex(const DeviceId& deviceId);
+    void publishDeviceList();
 };
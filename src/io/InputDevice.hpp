@@ -1,22 +1,27 @@
 #pragma once
 
 #include <Arduino.h>
+#include "DeviceId.hpp"
+#include "InputLog.hpp"
 #include <functional>
 #include <memory>
 
 // Base class for all input devices
 class InputDevice {
    public:
+    static const uint8_t MAX_CALLBACKS = 4;  // Subscribers per device event
+
     enum class DeviceType {
         ENCODER,
         BUTTON,
         JOYSTICK,
         POTENTIOMETER,
+        KEYPAD,
         CUSTOM
     };
 
-    InputDevice(const String& deviceId, DeviceType type)
-        : id(deviceId), type(type), initialized(false) {}
+    InputDevice(const DeviceId& deviceId, DeviceType type)
+        : id(deviceId), type(type), initialized(false), inputCount(0), lastInputTime(0), logSlot(InputLog::NO_SLOT) {}
 
     virtual ~InputDevice() = default;
 
@@ -28,21 +33,50 @@ class InputDevice {
     virtual void clearInputFlags() = 0;
 
     // Common interface methods
-    const String& getId() const { return id; }
+    const DeviceId& getId() const { return id; }
     DeviceType getType() const { return type; }
     bool isInitialized() const { return initialized; }
 
+    // Activity tracking (incremented on every input event, never cleared)
+    uint32_t getInputCount() const { return inputCount; }
+    unsigned long getLastInputTime() const { return lastInputTime; }
+
+    // GPIOs whose level change means new input (used to arm light sleep wake sources)
+    virtual uint8_t getWakePins(int* pins, uint8_t maxPins) const { return 0; }
+
+    // Record/replay slot, assigned by InputLog while a session runs
+    void setLogSlot(uint8_t slot) { logSlot = slot; }
+
    protected:
-    String id;
+    DeviceId id;
     DeviceType type;
     bool initialized;
+    uint32_t inputCount;
+    unsigned long lastInputTime;
+    uint8_t logSlot;
+
+    // Call from derived classes whenever they produce an input event
+    void markInput(unsigned long timestamp) {
+        inputCount++;
+        lastInputTime = timestamp;
+    }
+
+    // Raw hardware readings go through here so InputLog can record them, or
+    // substitute logged ones during a replay. Relative channels (counts) are
+    // replayed as an offset from the live value at the start of the replay.
+    template <typename Read>
+    int64_t tapRaw(uint8_t channel, bool relative, Read read) const {
+        InputLog* log = InputLog::getActive();
+        if (!log || logSlot == InputLog::NO_SLOT) return read();
+        return log->tap(logSlot, channel, relative, read);
+    }
 };
 
 // Template for type-safe device access
 template <typename T>
 class TypedInputDevice : public InputDevice {
    public:
-    TypedInputDevice(const String& deviceId, DeviceType type)
+    TypedInputDevice(const DeviceId& deviceId, DeviceType type)
         : InputDevice(deviceId, type) {}
 
     virtual ~TypedInputDevice() = default;
@@ -0,0 +1,450 @@
+#include "InputLog.hpp"
+#include "IO.hpp"
+#include "../core/Log.hpp"
+#include "../core/PowerManager.hpp"
+#include <Preferences.h>
+
+namespace {
+const char* const NAMESPACE = "inputlog";
+const char* const LOG_KEY = "log";
+
+const uint8_t MAGIC[3] = {'U', 'I', 'L'};
+const uint8_t VERSION = 1;
+const size_t MAX_RECORD_BYTES = 10 + 1 + 10;  // Two 64-bit varints and the key
+const uint8_t END_KEY = 0xFC;                 // Slot 63: no device, marks when the recording was stopped
+
+size_t writeVarint(uint8_t* out, uint64_t value) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (uint8_t)value;
+    return length;
+}
+
+// Returns false if the varint runs past end
+bool readVarint(const uint8_t* data, size_t end, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (uint8_t shift = 0; shift < 64 && pos < end; shift += 7) {
+        uint8_t byte = data[pos++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+uint64_t zigzag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+}
+
+// Initialize static members
+InputLog* InputLog::instance = nullptr;
+InputLog* InputLog::active = nullptr;
+unsigned long InputLog::clockOffset = 0;
+
+// Private constructor
+InputLog::InputLog() : mode(Mode::IDLE),
+                       fastReplay(false),
+                       buffer(nullptr),
+                       capacity(0),
+                       size(0),
+                       readPos(0),
+                       bodyStart(0),
+                       startMillis(0),
+                       replayBase(0),
+                       logTime(0),
+                       lastRecordTime(0),
+                       seenMask(0),
+                       loadedMask(0) {
+    memset(&stats, 0, sizeof(stats));
+    resetChannels();
+}
+
+// Destructor
+InputLog::~InputLog() {
+    stop();
+    free(buffer);
+}
+
+// Get singleton instance
+InputLog& InputLog::getInstance() {
+    if (instance == nullptr) {
+        instance = new InputLog();
+    }
+    return *instance;
+}
+
+// Check if instance exists
+bool InputLog::hasInstance() {
+    return instance != nullptr;
+}
+
+// Destroy the singleton instance
+void InputLog::destroyInstance() {
+    if (instance != nullptr) {
+        delete instance;
+        instance = nullptr;
+    }
+}
+
+// Session control
+bool InputLog::startRecording(size_t bufferSize) {
+    stop();
+    if (!reserve(bufferSize)) {
+        LOG_ERROR("InputLog: No memory for a %u byte recording", (unsigned)bufferSize);
+        return false;
+    }
+
+    size = 0;
+    memset(&stats, 0, sizeof(stats));
+    resetChannels();
+    writeHeader();
+
+    logTime = 0;
+    lastRecordTime = 0;
+    startMillis = millis();
+    mode = Mode::RECORDING;
+    active = this;
+
+    LOG_INFO("InputLog: Recording");
+    return true;
+}
+
+bool InputLog::startReplay() {
+    stop();
+    if (!attachDevices()) return false;
+
+    resetChannels();
+    readPos = bodyStart;
+    logTime = 0;
+    lastRecordTime = 0;
+    startMillis = millis();
+    replayBase = now();
+    stats.updates = 0;
+    stats.busyMicros = 0;
+    stats.maxUpdateMicros = 0;
+
+    // Devices should see the values logged at time 0 on their first pass
+    applyDueRecords();
+
+    // Nothing wakes light sleep while input comes from the log
+    PowerManager::getInstance().holdAwake();
+    fastReplay = false;
+    mode = Mode::REPLAYING;
+    active = this;
+
+    LOG_INFO("InputLog: Replaying %u records over %lu ms", stats.records, (unsigned long)stats.durationMs);
+    return true;
+}
+
+bool InputLog::runReplayFast() {
+    if (!startReplay()) return false;
+    fastReplay = true;
+
+    IO& io = IO::getInstance();
+    while (mode == Mode::REPLAYING) {
+        uint32_t start = micros();
+        io.update();
+        uint32_t elapsed = micros() - start;
+
+        stats.updates++;
+        stats.busyMicros += elapsed;
+        if (elapsed > stats.maxUpdateMicros) {
+            stats.maxUpdateMicros = elapsed;
+        }
+
+        if (replayDone()) {
+            finishReplay();
+            break;
+        }
+
+        logTime += REPLAY_STEP;
+        applyDueRecords();
+
+        // Let the idle task and watchdog run on long logs
+        if (stats.updates % FAST_REPLAY_YIELD == 0) {
+            delay(1);
+        }
+    }
+    return true;
+}
+
+void InputLog::stop() {
+    if (mode == Mode::RECORDING) {
+        // Replays run to the end of the session, not just to the last change
+        logTime = millis() - startMillis;
+        append(END_KEY, 0);
+        mode = Mode::IDLE;
+        active = nullptr;
+        detachDevices();
+        LOG_INFO("InputLog: Recorded %u records, %u bytes, %lu ms%s", stats.records, (unsigned)size,
+                 (unsigned long)stats.durationMs, stats.overflowed ? " (buffer full)" : "");
+    } else if (mode == Mode::REPLAYING) {
+        finishReplay();
+    }
+}
+
+void InputLog::update() {
+    if (mode == Mode::RECORDING) {
+        // One timestamp per IO pass
+        logTime = millis() - startMillis;
+    } else if (mode == Mode::REPLAYING && !fastReplay) {
+        logTime = millis() - startMillis;
+        if (replayDone()) {
+            finishReplay();
+            return;
+        }
+        applyDueRecords();
+    }
+}
+
+// Storage
+bool InputLog::save() {
+    if (mode == Mode::RECORDING || size == 0) return false;
+    if (size > MAX_SAVED_BYTES) {
+        LOG_WARN("InputLog: %u bytes is too large for NVS", (unsigned)size);
+        return false;
+    }
+
+    Preferences preferences;
+    if (!preferences.begin(NAMESPACE, false)) return false;
+    bool ok = preferences.putBytes(LOG_KEY, buffer, size) == size;
+    preferences.end();
+    return ok;
+}
+
+bool InputLog::load() {
+    stop();
+
+    Preferences preferences;
+    if (!preferences.begin(NAMESPACE, true)) return false;
+
+    size_t length = preferences.getBytesLength(LOG_KEY);
+    bool ok = length > 0 && reserve(length) && preferences.getBytes(LOG_KEY, buffer, length) == length;
+    preferences.end();
+
+    // Validates the header and counts the records
+    return ok && loadData(buffer, length);
+}
+
+const uint8_t* InputLog::getData() const {
+    return buffer;
+}
+
+size_t InputLog::getSize() const {
+    return size;
+}
+
+bool InputLog::loadData(const uint8_t* data, size_t length) {
+    stop();
+
+    // Validate everything before taking the log, so a bad one leaves nothing half loaded
+    if (length < sizeof(MAGIC) + 2 || memcmp(data, MAGIC, sizeof(MAGIC)) != 0 || data[3] != VERSION) {
+        LOG_ERROR("InputLog: Not an input log");
+        size = 0;
+        return false;
+    }
+
+    // Skip the device table
+    size_t pos = 5;
+    for (uint8_t i = 0; i < data[4] && pos < length; i++) {
+        pos += 1 + data[pos];
+    }
+    size_t start = pos;
+
+    // Count records and find the duration
+    Stats counted;
+    memset(&counted, 0, sizeof(counted));
+    bool valid = pos <= length;
+    uint64_t dt;
+    uint64_t delta;
+    while (valid && pos < length) {
+        valid = readVarint(data, length, pos, dt) && pos < length;
+        pos++;  // Key
+        valid = valid && readVarint(data, length, pos, delta);
+        counted.records++;
+        counted.durationMs += (uint32_t)dt;
+    }
+    if (!valid) {
+        LOG_ERROR("InputLog: Input log is truncated");
+        size = 0;
+        return false;
+    }
+
+    if (data != buffer) {
+        if (!reserve(length)) {
+            size = 0;
+            return false;
+        }
+        memcpy(buffer, data, length);
+    }
+    size = length;
+    bodyStart = start;
+    stats = counted;
+    return true;
+}
+
+InputLog::Mode InputLog::getMode() const {
+    return mode;
+}
+
+const InputLog::Stats& InputLog::getStats() const {
+    return stats;
+}
+
+// Private methods
+
+bool InputLog::reserve(size_t bytes) {
+    if (buffer && capacity >= bytes) return true;
+
+    uint8_t* grown = (uint8_t*)realloc(buffer, bytes);
+    if (!grown) return false;
+    buffer = grown;
+    capacity = bytes;
+    return true;
+}
+
+void InputLog::writeHeader() {
+    memcpy(buffer, MAGIC, sizeof(MAGIC));
+    buffer[3] = VERSION;
+    buffer[4] = 0;
+    size = 5;
+
+    // Slots follow IO's device order
+    uint8_t slot = 0;
+    for (InputDevice* device : IO::getInstance().getAllDevices()) {
+        if (slot >= MAX_DEVICES) break;
+
+        const DeviceId& id = device->getId();
+        size_t length = id.length();
+        if (size + 1 + length > capacity) break;
+
+        buffer[size++] = (uint8_t)length;
+        memcpy(buffer + size, id.c_str(), length);
+        size += length;
+        device->setLogSlot(slot++);
+    }
+    buffer[4] = slot;
+    bodyStart = size;
+}
+
+bool InputLog::attachDevices() {
+    if (size == 0) {
+        LOG_WARN("InputLog: Nothing to replay");
+        return false;
+    }
+
+    IO& io = IO::getInstance();
+    size_t pos = 5;
+    char id[256];
+    for (uint8_t slot = 0; slot < buffer[4]; slot++) {
+        uint8_t length = buffer[pos++];
+        memcpy(id, buffer + pos, length);
+        id[length] = '\0';
+        pos += length;
+
+        // Devices missing from this build stay live
+        InputDevice* device = io.getDevice(DeviceId(id));
+        if (device) {
+            device->setLogSlot(slot);
+        } else {
+            // id is gone by the time the record prints
+            LOG_WARN("InputLog: No device for slot %u to replay into", slot);
+        }
+    }
+    return true;
+}
+
+void InputLog::detachDevices() {
+    for (InputDevice* device : IO::getInstance().getAllDevices()) {
+        device->setLogSlot(NO_SLOT);
+    }
+}
+
+void InputLog::resetChannels() {
+    memset(values, 0, sizeof(values));
+    memset(offsets, 0, sizeof(offsets));
+    seenMask = 0;
+    loadedMask = 0;
+}
+
+void InputLog::record(uint8_t slot, uint8_t channel, int64_t value) {
+    // Always leave room for the end marker
+    if (size + 2 * MAX_RECORD_BYTES > capacity) {
+        // Keep what fits; the log stays valid up to the last whole record
+        stats.overflowed = true;
+        stop();
+        return;
+    }
+
+    append((uint8_t)(slot << 2 | channel), zigzag(value - values[slot][channel]));
+    values[slot][channel] = value;
+}
+
+void InputLog::append(uint8_t key, uint64_t delta) {
+    size += writeVarint(buffer + size, logTime - lastRecordTime);
+    buffer[size++] = key;
+    size += writeVarint(buffer + size, delta);
+
+    lastRecordTime = logTime;
+    stats.records++;
+    stats.durationMs = logTime;
+}
+
+void InputLog::applyDueRecords() {
+    while (readPos < size) {
+        size_t pos = readPos;
+        uint64_t dt;
+        uint64_t delta;
+        if (!readVarint(buffer, size, pos, dt) || pos >= size) break;
+        if (lastRecordTime + dt > logTime) return;
+
+        uint8_t key = buffer[pos++];
+        if (!readVarint(buffer, size, pos, delta)) break;
+
+        uint8_t slot = key >> 2;
+        uint8_t channel = key & (MAX_CHANNELS - 1);
+        if (slot < MAX_DEVICES) {
+            values[slot][channel] += unzigzag(delta);
+            loadedMask |= 1ULL << (slot * MAX_CHANNELS + channel);
+        }
+        lastRecordTime += dt;
+        readPos = pos;
+    }
+
+    // A cut-off record ends the replay rather than being read past the end
+    readPos = size;
+}
+
+bool InputLog::replayDone() const {
+    return readPos >= size && logTime >= stats.durationMs + REPLAY_TAIL;
+}
+
+void InputLog::finishReplay() {
+    // Keep now() monotonic: a fast replay leaves log time ahead of millis(), and devices
+    // hold timestamps from it that a step back would put in the future
+    unsigned long replayEnd = replayBase + logTime;
+    if ((long)(replayEnd - (millis() + clockOffset)) > 0) {
+        clockOffset = replayEnd - millis();
+    }
+
+    mode = Mode::IDLE;
+    active = nullptr;
+    detachDevices();
+
+    // Encoders were positioned from logged counts; move the live counters to match
+    for (RotaryEncoder* encoder : IO::getInstance().getRotaryEncoders()) {
+        encoder->setPosition(encoder->getPosition());
+    }
+
+    PowerManager::getInstance().releaseAwake();
+
+    LOG_INFO("InputLog: Replay done, %u passes, %u us busy, %u us max", stats.updates, stats.busyMicros,
+             stats.maxUpdateMicros);
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Records the raw readings of input devices and replays them through the
+// same device code, to reproduce field sessions and benchmark them.
+//
+// Devices pass their raw hardware readings (encoder counts, button levels)
+// through InputDevice::tapRaw(), which hands them to the active log. While
+// recording, each change is appended to a RAM buffer as one record:
+//
+//   dt:varint  key:u8 (slot << 2 | channel)  delta:zigzag varint
+//
+// dt is in ms since the previous record and is taken once per IO pass, so
+// all readings of one pass share a timestamp. delta is the change from the
+// channel's previous value. A short header maps slots to device ids, and a
+// record for slot 63 marks the end of the session. A busy encoder costs
+// about 3 bytes per count change.
+//
+// During replay the taps return logged values instead of reading the
+// hardware, and now() returns log time. Debounce, detents, gestures and
+// callbacks therefore behave as they did in the recorded session. Counts
+// are replayed relative to the live count when replay starts, so positions
+// do not jump. now() never goes backwards: a fast replay runs log time
+// ahead of millis(), and afterwards now() carries on from where the replay
+// ended, so device timestamps stay in the past. Replay runs either in real
+// time from the IO job, or as fast as possible from runReplayFast(), which
+// times every IO pass. That pass time is the figure to compare between
+// builds.
+//
+// A log can be kept in NVS (save/load) or moved as bytes (getData/loadData),
+// e.g. into a host build.
+class InputLog {
+   public:
+    enum class Mode : uint8_t {
+        IDLE,
+        RECORDING,
+        REPLAYING
+    };
+
+    static const uint8_t MAX_DEVICES = 16;
+    static const uint8_t MAX_CHANNELS = 4;             // Raw channels per device (key has 2 bits)
+    static const uint8_t NO_SLOT = 0xFF;
+    static const size_t DEFAULT_CAPACITY = 32768;      // Bytes of RAM for a recording
+    static const size_t MAX_SAVED_BYTES = 12288;       // Largest log save() puts into NVS
+    static const unsigned long REPLAY_STEP = 1;        // ms of log time per IO pass in a fast replay
+    static const unsigned long REPLAY_TAIL = 500;      // ms the last values are held so debounce and gestures settle
+    static const uint16_t FAST_REPLAY_YIELD = 100;     // IO passes between yields in a fast replay
+
+    struct Stats {
+        uint32_t records;
+        uint32_t durationMs;   // Length of the recorded session
+        bool overflowed;       // Recording stopped because the buffer was full
+        uint32_t updates;      // IO passes during the last replay
+        uint32_t busyMicros;   // Time spent in those passes
+        uint32_t maxUpdateMicros;
+    };
+
+   private:
+    // Private constructor to prevent direct instantiation
+    InputLog();
+
+    // Static instance pointer
+    static InputLog* instance;
+
+    // Log that device taps go to, null while idle
+    static InputLog* active;
+
+    // How far now() runs ahead of millis() after a fast replay
+    static unsigned long clockOffset;
+
+    // Delete copy constructor and assignment operator
+    InputLog(const InputLog&) = delete;
+    InputLog& operator=(const InputLog&) = delete;
+
+   public:
+    // Public destructor
+    ~InputLog();
+
+    // Get singleton instance
+    static InputLog& getInstance();
+
+    // Check if instance exists
+    static bool hasInstance();
+
+    // Destroy the singleton instance
+    static void destroyInstance();
+
+    // Session control
+    bool startRecording(size_t capacity = DEFAULT_CAPACITY);
+    bool startReplay();    // Real time, driven by IO::update()
+    bool runReplayFast();  // Blocks until the log is replayed
+    void stop();
+
+    // Called by IO::update() before the devices
+    void update();
+
+    // Storage
+    bool save();
+    bool load();
+    const uint8_t* getData() const;
+    size_t getSize() const;
+    bool loadData(const uint8_t* data, size_t size);
+
+    Mode getMode() const;
+    const Stats& getStats() const;
+
+    // Clock for device timing: millis() plus the lead left by past replays, or log time during a replay
+    static unsigned long now() {
+        return (active && active->mode == Mode::REPLAYING) ? active->replayBase + active->logTime
+                                                          : millis() + clockOffset;
+    }
+
+    static InputLog* getActive() { return active; }
+
+    // Device tap; relative channels (counts) replay as offsets from the live value
+    template <typename Read>
+    int64_t tap(uint8_t slot, uint8_t channel, bool relative, Read read) {
+        uint64_t bit = 1ULL << (slot * MAX_CHANNELS + channel);
+        if (mode == Mode::REPLAYING) {
+            // Live until the log reaches the channel's first value
+            if (!(loadedMask & bit)) return read();
+            if (!(seenMask & bit)) {
+                seenMask |= bit;
+                offsets[slot][channel] = relative ? read() - values[slot][channel] : 0;
+            }
+            return values[slot][channel] + offsets[slot][channel];
+        }
+
+        int64_t value = read();
+        if (!(seenMask & bit) || value != values[slot][channel]) {
+            seenMask |= bit;
+            record(slot, channel, value);
+        }
+        return value;
+    }
+
+   private:
+    Mode mode;
+    bool fastReplay;
+
+    uint8_t* buffer;
+    size_t capacity;
+    size_t size;
+    size_t readPos;    // Next record during replay
+    size_t bodyStart;  // First record after the header
+
+    unsigned long startMillis;
+    unsigned long replayBase;  // now() during replay is replayBase + logTime
+    unsigned long logTime;     // ms since the session started
+    unsigned long lastRecordTime;
+
+    int64_t values[MAX_DEVICES][MAX_CHANNELS];
+    int64_t offsets[MAX_DEVICES][MAX_CHANNELS];
+    uint64_t seenMask;    // Channels with a first value (recorded, or offset taken in replay)
+    uint64_t loadedMask;  // Channels the replay has applied a record for
+
+    Stats stats;
+
+    // Internal methods
+    bool reserve(size_t bytes);
+    void writeHeader();
+    bool attachDevices();
+    void detachDevices();
+    void resetChannels();
+    void record(uint8_t slot, uint8_t channel, int64_t value);
+    void append(uint8_t key, uint64_t delta);
+    void applyDueRecords();
+    bool replayDone() const;
+    void finishReplay();
+};
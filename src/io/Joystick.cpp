@@ -0,0 +1,326 @@
+#include "Joystick.hpp"
+#include "AnalogSampler.hpp"
+#include "../core/Log.hpp"
+
+namespace {
+const uint8_t FRACTION_BITS = AnalogSampler::MEAN_FRACTION_BITS;
+const int32_t CURVE_STEP = Joystick::UNIT / (Joystick::CURVE_POINTS - 1);
+}
+
+Joystick::Joystick(const DeviceId& deviceId, const Config& config)
+    : TypedInputDevice<Joystick>(deviceId, DeviceType::JOYSTICK),
+      config(config),
+      channelX(-1),
+      channelY(-1),
+      filteredX(0),
+      filteredY(0),
+      primed(false),
+      x(0),
+      y(0),
+      reportedX(0),
+      reportedY(0),
+      lastEvent(0),
+      newAxisInput(false),
+      buttonState(false),
+      lastButtonReading(false),
+      lastButtonChange(0),
+      newButtonInput(false) {
+    setCurve(config.curve);
+}
+
+Joystick::~Joystick() {
+    if (initialized) {
+        shutdown();
+    }
+}
+
+bool Joystick::initialize() {
+    if (initialized) return true;
+
+    channelX = digitalPinToAnalogChannel(config.pinX);
+    channelY = digitalPinToAnalogChannel(config.pinY);
+    if (channelX < 0 || channelX >= AnalogSampler::MAX_CHANNELS || channelY < 0 ||
+        channelY >= AnalogSampler::MAX_CHANNELS) {
+        LOG_ERROR("Joystick: GPIO %d/%d are not both ADC1 pins", config.pinX, config.pinY);
+        return false;
+    }
+
+    AnalogSampler& sampler = AnalogSampler::getInstance();
+    sampler.addChannel(channelX, config.attenuation);
+    sampler.addChannel(channelY, config.attenuation);
+
+    if (config.hasButton) {
+        pinMode(config.buttonPin, config.enablePullup ? INPUT_PULLUP : INPUT);
+        buttonState = readButtonRaw();
+        lastButtonReading = buttonState;
+        lastButtonChange = InputLog::now();
+    }
+
+    primed = false;
+    initialized = true;
+    return true;
+}
+
+void Joystick::shutdown() {
+    if (initialized) {
+        AnalogSampler& sampler = AnalogSampler::getInstance();
+        sampler.removeChannel(channelX);
+        sampler.removeChannel(channelY);
+        initialized = false;
+    }
+}
+
+void Joystick::update() {
+    if (!initialized) return;
+
+    updateAxes();
+    if (config.hasButton) {
+        updateButton();
+    }
+}
+
+bool Joystick::hasNewInput() {
+    return newAxisInput || newButtonInput;
+}
+
+void Joystick::clearInputFlags() {
+    newAxisInput = false;
+    newButtonInput = false;
+}
+
+uint8_t Joystick::getWakePins(int* pins, uint8_t maxPins) const {
+    if (!config.hasButton || maxPins == 0) return 0;
+    pins[0] = config.buttonPin;
+    return 1;
+}
+
+int Joystick::getX() const {
+    return reportedX;
+}
+
+int Joystick::getY() const {
+    return reportedY;
+}
+
+uint16_t Joystick::getRawX() const {
+    return (uint16_t)(filteredX >> FRACTION_BITS);
+}
+
+uint16_t Joystick::getRawY() const {
+    return (uint16_t)(filteredY >> FRACTION_BITS);
+}
+
+bool Joystick::isButtonPressed() const {
+    return config.hasButton ? buttonState : false;
+}
+
+// Calibration
+void Joystick::setCalibration(const AxisCalibration& calibrationX, const AxisCalibration& calibrationY) {
+    config.calibrationX = calibrationX;
+    config.calibrationY = calibrationY;
+}
+
+void Joystick::calibrateCenter() {
+    if (!primed) return;
+    config.calibrationX.center = getRawX();
+    config.calibrationY.center = getRawY();
+}
+
+// Configuration methods
+void Joystick::setDeadzone(uint8_t percent) {
+    config.deadzonePercent = percent > 100 ? 100 : percent;
+}
+
+void Joystick::setCurve(Curve curve) {
+    config.curve = curve;
+    for (uint8_t i = 0; i < CURVE_POINTS; i++) {
+        int32_t t = i * CURVE_STEP;
+        switch (curve) {
+            case Curve::QUADRATIC:
+                curveTable[i] = (uint16_t)(t * t / UNIT);
+                break;
+            case Curve::CUBIC:
+                curveTable[i] = (uint16_t)((int64_t)t * t * t / ((int64_t)UNIT * UNIT));
+                break;
+            case Curve::LINEAR:
+            default:
+                curveTable[i] = (uint16_t)t;
+                break;
+        }
+    }
+}
+
+void Joystick::setCurveTable(const uint16_t* table) {
+    if (!table) return;
+    for (uint8_t i = 0; i < CURVE_POINTS; i++) {
+        curveTable[i] = table[i] > UNIT ? UNIT : table[i];
+    }
+}
+
+void Joystick::setEventRate(uint16_t hz) {
+    config.eventRateHz = hz;
+}
+
+void Joystick::setAxisCallback(AxisCallback callback) {
+    axisCallbacks.set(callback);
+}
+
+int Joystick::addAxisCallback(AxisCallback callback) {
+    return axisCallbacks.add(callback);
+}
+
+bool Joystick::removeAxisCallback(int handle) {
+    return axisCallbacks.remove(handle);
+}
+
+void Joystick::setButtonCallback(ButtonCallback callback) {
+    buttonCallbacks.set(callback);
+}
+
+int Joystick::addButtonCallback(ButtonCallback callback) {
+    return buttonCallbacks.add(callback);
+}
+
+bool Joystick::removeButtonCallback(int handle) {
+    return buttonCallbacks.remove(handle);
+}
+
+std::unique_ptr<Joystick> Joystick::create(const DeviceId& deviceId, const Config& config) {
+    return std::unique_ptr<Joystick>(new Joystick(deviceId, config));
+}
+
+// Private methods
+
+void Joystick::updateAxes() {
+    unsigned long now = InputLog::now();
+
+    // Both axes come from the same DMA frames, so they arrive together
+    AnalogSampler& sampler = AnalogSampler::getInstance();
+    uint16_t meanX, meanY;
+    bool hasX = sampler.takeBatch(channelX, meanX);
+    bool hasY = sampler.takeBatch(channelY, meanY);
+
+    if (hasX && hasY) {
+        if (!primed) {
+            filteredX = meanX;
+            filteredY = meanY;
+            primed = true;
+        } else {
+            filteredX += ((int32_t)meanX - filteredX) >> config.filterShift;
+            filteredY += ((int32_t)meanY - filteredY) >> config.filterShift;
+        }
+
+        int32_t nx = normalize(filteredX, config.calibrationX);
+        int32_t ny = normalize(filteredY, config.calibrationY);
+
+        // Radial deadzone, then rescale what is left to 0..UNIT and shape it
+        int32_t magnitude = (int32_t)isqrt((uint32_t)(nx * nx + ny * ny));
+        int32_t deadzone = UNIT * config.deadzonePercent / 100;
+        int32_t shaped = 0;
+        if (magnitude > deadzone && deadzone < UNIT) {
+            int32_t beyond = magnitude > UNIT ? UNIT - deadzone : magnitude - deadzone;
+            shaped = applyCurve(beyond * UNIT / (UNIT - deadzone));
+        }
+
+        // Keep the direction, replace the length
+        if (shaped == 0) {
+            x = 0;
+            y = 0;
+        } else {
+            x = (int)((int64_t)nx * shaped / magnitude * config.range / UNIT);
+            y = (int)((int64_t)ny * shaped / magnitude * config.range / UNIT);
+        }
+        if (config.invertX) x = -x;
+        if (config.invertY) y = -y;
+    }
+
+    emitAxes(now);
+}
+
+void Joystick::emitAxes(unsigned long now) {
+    if (x == reportedX && y == reportedY) return;
+
+    // A change waits here until the interval has passed; later changes overwrite it
+    if (config.eventRateHz != 0 && now - lastEvent < 1000UL / config.eventRateHz) return;
+
+    reportedX = x;
+    reportedY = y;
+    lastEvent = now;
+    newAxisInput = true;
+    markInput(now);
+
+    // Notify subscribers
+    axisCallbacks(x, y);
+}
+
+void Joystick::updateButton() {
+    unsigned long currentTime = InputLog::now();
+    bool currentReading = readButtonRaw();
+
+    // Debouncing logic
+    if (currentReading != lastButtonReading) {
+        lastButtonChange = currentTime;
+    }
+    lastButtonReading = currentReading;
+
+    if ((currentTime - lastButtonChange) > config.debounceTime && currentReading != buttonState) {
+        buttonState = currentReading;
+        newButtonInput = true;
+        markInput(currentTime);
+
+        // Notify subscribers
+        buttonCallbacks(buttonState);
+    }
+}
+
+bool Joystick::readButtonRaw() {
+    // Click is active LOW when using the pullup
+    return config.enablePullup ? !digitalRead(config.buttonPin) : digitalRead(config.buttonPin);
+}
+
+int32_t Joystick::normalize(int32_t filtered, const AxisCalibration& calibration) const {
+    int32_t reading = filtered >> FRACTION_BITS;
+
+    // Each side of the centre has its own span, so an off-centre rest still reaches both ends
+    int32_t result;
+    if (reading >= calibration.center) {
+        int32_t span = calibration.max - calibration.center;
+        result = span > 0 ? (reading - calibration.center) * UNIT / span : 0;
+    } else {
+        int32_t span = calibration.center - calibration.min;
+        result = span > 0 ? -((calibration.center - reading) * UNIT / span) : 0;
+    }
+
+    if (result > UNIT) return UNIT;
+    if (result < -UNIT) return -UNIT;
+    return result;
+}
+
+int32_t Joystick::applyCurve(int32_t magnitude) const {
+    if (magnitude <= 0) return 0;
+    if (magnitude >= UNIT) return curveTable[CURVE_POINTS - 1];
+
+    // Linear interpolation between table points
+    int32_t index = magnitude / CURVE_STEP;
+    int32_t fraction = magnitude % CURVE_STEP;
+    int32_t low = curveTable[index];
+    int32_t high = curveTable[index + 1];
+    return low + (high - low) * fraction / CURVE_STEP;
+}
+
+uint32_t Joystick::isqrt(uint32_t value) {
+    uint32_t result = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > value) bit >>= 2;
+
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return result;
+}
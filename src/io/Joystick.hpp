@@ -0,0 +1,143 @@
+#pragma once
+
+#include "InputDevice.hpp"
+#include "../core/InplaceFunction.hpp"
+#include <memory>
+
+// Two-axis analog stick with an optional click, sampled by AnalogSampler
+// alongside the other analog devices.
+//
+// Each axis is calibrated by its low, centre and high readings and
+// normalized to -1..1 on either side of the centre. The deadzone is radial:
+// it is applied to the length of the (x, y) vector, so it is round and
+// diagonals are not clipped. The length beyond the deadzone is then rescaled
+// and shaped by a response curve lookup table.
+//
+// Axis events are rate limited. An event fires only when the output has
+// changed, and never more often than eventRateHz. A stick held still
+// off-centre therefore sends nothing, and a moving stick sends at most
+// eventRateHz events, the last one always carrying the final position.
+class Joystick : public TypedInputDevice<Joystick> {
+   public:
+    // Callback types
+    using AxisCallback = InplaceFunction<void(int x, int y)>;
+    using ButtonCallback = InplaceFunction<void(bool pressed)>;
+
+    enum class Curve : uint8_t {
+        LINEAR,
+        QUADRATIC,  // Fine control near the centre
+        CUBIC       // Finer still, full speed only at the edge
+    };
+
+    static const uint8_t CURVE_POINTS = 17;  // Lookup table entries over 0..1
+    static const int32_t UNIT = 4096;        // Fixed-point 1.0 for normalized axes
+
+    struct AxisCalibration {
+        uint16_t min;
+        uint16_t center;
+        uint16_t max;
+
+        AxisCalibration() : min(0), center(2048), max(4095) {}
+    };
+
+    struct Config {
+        int pinX;  // ADC1 pins (GPIO 32-39)
+        int pinY;
+        int buttonPin;
+        bool hasButton;
+        bool enablePullup;  // Click is active low with the pullup
+        unsigned long debounceTime;
+        uint8_t attenuation;      // adc_atten_t, 3 = 11 dB
+        AxisCalibration calibrationX;
+        AxisCalibration calibrationY;
+        uint8_t deadzonePercent;  // Radius of the dead centre, as a percent of full deflection
+        Curve curve;
+        int range;                // Output is -range..range on each axis
+        bool invertX;
+        bool invertY;
+        uint8_t filterShift;      // IIR weight 1/2^filterShift per sample batch
+        uint16_t eventRateHz;     // Most axis events per second, 0 for no limit
+
+        Config() : pinX(34), pinY(35), buttonPin(-1), hasButton(false), enablePullup(true), debounceTime(50),
+                   attenuation(3), deadzonePercent(8), curve(Curve::LINEAR), range(100), invertX(false),
+                   invertY(false), filterShift(2), eventRateHz(20) {}
+    };
+
+    Joystick(const DeviceId& deviceId, const Config& config);
+    ~Joystick() override;
+
+    // InputDevice interface
+    bool initialize() override;
+    void shutdown() override;
+    void update() override;
+    bool hasNewInput() override;
+    void clearInputFlags() override;
+    uint8_t getWakePins(int* pins, uint8_t maxPins) const override;
+
+    // Joystick-specific methods
+    int getX() const;  // Last reported position
+    int getY() const;
+    uint16_t getRawX() const;  // Filtered 12-bit readings
+    uint16_t getRawY() const;
+    bool isButtonPressed() const;
+
+    // Calibration
+    void setCalibration(const AxisCalibration& x, const AxisCalibration& y);
+    void calibrateCenter();  // Take the current resting position as the centre
+
+    // Configuration methods
+    void setDeadzone(uint8_t percent);
+    void setCurve(Curve curve);
+    void setCurveTable(const uint16_t* table);  // CURVE_POINTS values over 0..UNIT
+    void setEventRate(uint16_t hz);
+
+    // Callback methods (set replaces all subscribers; add returns a handle for remove, -1 when full)
+    void setAxisCallback(AxisCallback callback);
+    int addAxisCallback(AxisCallback callback);
+    bool removeAxisCallback(int handle);
+    void setButtonCallback(ButtonCallback callback);
+    int addButtonCallback(ButtonCallback callback);
+    bool removeButtonCallback(int handle);
+
+    // Static factory method
+    static std::unique_ptr<Joystick> create(const DeviceId& deviceId, const Config& config);
+
+   private:
+    Config config;
+    int channelX;
+    int channelY;
+
+    // Filtered readings, 12-bit scaled by AnalogSampler::MEAN_FRACTION_BITS
+    int32_t filteredX;
+    int32_t filteredY;
+    bool primed;
+
+    uint16_t curveTable[CURVE_POINTS];
+
+    // Output and rate limiting
+    int x;
+    int y;
+    int reportedX;
+    int reportedY;
+    unsigned long lastEvent;
+    bool newAxisInput;
+
+    // Click state
+    bool buttonState;
+    bool lastButtonReading;
+    unsigned long lastButtonChange;
+    bool newButtonInput;
+
+    // Callbacks
+    CallbackList<void(int x, int y), MAX_CALLBACKS> axisCallbacks;
+    CallbackList<void(bool pressed), MAX_CALLBACKS> buttonCallbacks;
+
+    // Private methods
+    void updateAxes();
+    void updateButton();
+    void emitAxes(unsigned long now);
+    bool readButtonRaw();
+    int32_t normalize(int32_t filtered, const AxisCalibration& calibration) const;
+    int32_t applyCurve(int32_t magnitude) const;
+    static uint32_t isqrt(uint32_t value);
+};
@@ -0,0 +1,120 @@
+#include "LedRing.hpp"
+
+LedRing::LedRing(const DeviceId& deviceId, FrameSink& sink, const Config& config)
+    : OutputDevice(deviceId, DeviceType::LED_RING),
+      sink(sink),
+      config(config),
+      front(0),
+      pending(false),
+      level(0),
+      muted(false) {
+    if (this->config.ledCount > MAX_LEDS) this->config.ledCount = MAX_LEDS;
+    if (this->config.ledCount == 0) this->config.ledCount = 1;
+    if (this->config.maxLevel < 1) this->config.maxLevel = 1;
+    memset(frames, 0, sizeof(frames));
+}
+
+LedRing::~LedRing() {
+    if (initialized) {
+        shutdown();
+    }
+}
+
+bool LedRing::initialize() {
+    if (initialized) return true;
+
+    // Send the current drawing even if it is dark, so LEDs left lit by a reset go out
+    draw();
+    pending = true;
+    initialized = true;
+    update();
+    return true;
+}
+
+void LedRing::shutdown() {
+    if (initialized) {
+        // Best effort: a busy sink means the ring keeps its last frame
+        level = 0;
+        draw();
+        update();
+        initialized = false;
+    }
+}
+
+void LedRing::update() {
+    if (!initialized || !pending || sink.isBusy()) return;
+
+    uint8_t back = 1 - front;
+    if (!sink.write(frames[back], frameBytes())) return;
+
+    front = back;
+    pending = false;
+    frameCount++;
+}
+
+bool LedRing::hasPendingOutput() const {
+    return pending;
+}
+
+// LedRing-specific methods
+void LedRing::setLevel(int level, bool muted) {
+    if (level < 0) level = 0;
+    if (level > config.maxLevel) level = config.maxLevel;
+    if (level == this->level && muted == this->muted) return;
+
+    this->level = level;
+    this->muted = muted;
+    draw();
+}
+
+int LedRing::getLevel() const {
+    return level;
+}
+
+bool LedRing::isMuted() const {
+    return muted;
+}
+
+// Configuration methods
+void LedRing::setBrightness(uint8_t brightness) {
+    if (config.brightness == brightness) return;
+
+    config.brightness = brightness;
+    draw();
+}
+
+// Static factory method
+std::unique_ptr<LedRing> LedRing::create(const DeviceId& deviceId, FrameSink& sink, const Config& config) {
+    return std::unique_ptr<LedRing>(new LedRing(deviceId, sink, config));
+}
+
+// Private methods
+void LedRing::draw() {
+    uint8_t* pixels = frames[1 - front];
+    uint32_t color = muted ? config.mutedColor : config.color;
+    uint8_t red = (color >> 16) & 0xFF;
+    uint8_t green = (color >> 8) & 0xFF;
+    uint8_t blue = color & 0xFF;
+
+    // Arc length in 1/256 of an LED
+    uint32_t lit = (uint32_t)level * config.ledCount * 256 / config.maxLevel;
+
+    for (uint8_t i = 0; i < config.ledCount; i++) {
+        uint32_t start = (uint32_t)i * 256;
+        uint32_t fill = lit >= start + 256 ? 256 : (lit > start ? lit - start : 0);
+        uint32_t scale = fill * config.brightness;  // Out of 256 * 255
+
+        uint8_t step = config.reversed ? config.ledCount - 1 - i : i;
+        uint8_t* pixel = pixels + ((config.firstLed + step) % config.ledCount) * 3;
+        pixel[0] = green * scale / (256 * 255);
+        pixel[1] = red * scale / (256 * 255);
+        pixel[2] = blue * scale / (256 * 255);
+    }
+
+    // A pending frame is replaced outright; only a real difference from the sent one needs a push
+    pending = memcmp(pixels, frames[front], frameBytes()) != 0;
+}
+
+size_t LedRing::frameBytes() const {
+    return (size_t)config.ledCount * 3;
+}
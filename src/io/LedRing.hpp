@@ -0,0 +1,68 @@
+#pragma once
+
+#include "OutputDevice.hpp"
+#include "FrameSink.hpp"
+#include <memory>
+
+// WS2812 ring around a knob that shows a level as an arc of lit LEDs.
+//
+// setLevel() draws into the back frame only when the level or mute state
+// changed, and the frame is pushed only when it differs from the one last
+// sent. The sink reads the front frame while it transmits, so drawing never
+// touches a frame in flight. If the sink is still busy, the new frame stays
+// pending and update() sends it on a later pass. The LED at the end of the
+// arc is lit in proportion, so small steps and animations show as a fade
+// rather than a jump.
+class LedRing : public OutputDevice {
+   public:
+    static const uint8_t MAX_LEDS = 64;
+
+    struct Config {
+        uint8_t ledCount;     // LEDs on the ring
+        uint8_t firstLed;     // Index of the LED where the arc starts
+        bool reversed;        // Arc grows toward lower indices
+        int maxLevel;         // Level that lights the whole ring
+        uint8_t brightness;   // 0-255, applied to every color
+        uint32_t color;       // 0xRRGGBB of the arc
+        uint32_t mutedColor;  // 0xRRGGBB of the arc while muted
+
+        Config() : ledCount(12), firstLed(0), reversed(false), maxLevel(100), brightness(64), color(0x00FF40),
+                   mutedColor(0xFF0000) {}
+    };
+
+    LedRing(const DeviceId& deviceId, FrameSink& sink, const Config& config);
+    ~LedRing() override;
+
+    // OutputDevice interface
+    bool initialize() override;
+    void shutdown() override;
+    void update() override;
+    bool hasPendingOutput() const override;
+
+    // LedRing-specific methods
+    void setLevel(int level, bool muted = false);
+    int getLevel() const;
+    bool isMuted() const;
+
+    // Configuration methods
+    void setBrightness(uint8_t brightness);
+
+    // Static factory method
+    static std::unique_ptr<LedRing> create(const DeviceId& deviceId, FrameSink& sink, const Config& config);
+
+   private:
+    FrameSink& sink;
+    Config config;
+
+    // Double buffer of GRB bytes; front is owned by the sink until it is idle
+    uint8_t frames[2][MAX_LEDS * 3];
+    uint8_t front;
+    bool pending;
+
+    int level;
+    bool muted;
+
+    // Private methods
+    void draw();
+    size_t frameBytes() const;
+};
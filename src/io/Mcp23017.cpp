@@ -0,0 +1,170 @@
+#include "Mcp23017.hpp"
+#include "../core/Log.hpp"
+
+namespace {
+// Register addresses with IOCON.BANK = 0 (A/B pairs are adjacent)
+const uint8_t REG_IODIRA = 0x00;
+const uint8_t REG_GPINTENA = 0x04;
+const uint8_t REG_INTCONA = 0x08;
+const uint8_t REG_IOCON = 0x0A;
+const uint8_t REG_GPPUA = 0x0C;
+const uint8_t REG_INTCAPA = 0x10;
+const uint8_t REG_GPIOA = 0x12;
+
+const uint8_t IOCON_MIRROR = 0x40;  // INTA and INTB both report either port
+const uint8_t IOCON_ODR = 0x04;     // Open-drain INT, so several expanders can share a line
+}
+
+Mcp23017::Mcp23017(I2CBus& bus, uint8_t address, int interruptPin)
+    : bus(bus),
+      address(address),
+      interruptPin(interruptPin),
+      started(false),
+      inputMask(0),
+      pullupMask(0),
+      pins(0),
+      sampleCount(0),
+      scanId(0),
+      pollInterval(interruptPin >= 0 ? DEFAULT_POLL_INTERVAL : 0),
+      lastScan(0),
+      interruptPending(false),
+      interruptMicros(0) {
+    samples[0] = 0;
+    samples[1] = 0;
+    memset(&stats, 0, sizeof(stats));
+}
+
+Mcp23017::~Mcp23017() {
+    if (started && interruptPin >= 0) {
+        detachInterrupt(interruptPin);
+    }
+}
+
+bool Mcp23017::begin() {
+    if (started) return true;
+
+    uint8_t iocon = IOCON_MIRROR | IOCON_ODR;
+    if (!bus.write(address, REG_IOCON, &iocon, 1) ||
+        !writeRegisterPair(REG_IODIRA, 0xFFFF) ||
+        !writeRegisterPair(REG_GPINTENA, 0x0000) ||
+        !writeRegisterPair(REG_INTCONA, 0x0000)) {
+        LOG_ERROR("Expander: No MCP23017 at 0x%02x", address);
+        return false;
+    }
+
+    if (interruptPin >= 0) {
+        // INT is open drain and active low
+        pinMode(interruptPin, INPUT_PULLUP);
+        attachInterruptArg(interruptPin, onInterrupt, this, FALLING);
+    }
+
+    started = true;
+
+    // Seed the port state; this also clears any stale interrupt
+    scan(false);
+    return true;
+}
+
+bool Mcp23017::configureInputs(uint16_t mask, bool pullup) {
+    if (!begin()) return false;
+
+    inputMask |= mask;
+    if (pullup) {
+        pullupMask |= mask;
+    } else {
+        pullupMask &= ~mask;
+    }
+
+    // Compare against the previous value, i.e. interrupt on any change
+    bool ok = writeRegisterPair(REG_GPPUA, pullupMask) && writeRegisterPair(REG_GPINTENA, inputMask);
+
+    // Pullups change the levels just read, so take a fresh copy
+    scan(false);
+    return ok;
+}
+
+void Mcp23017::service() {
+    if (!started) return;
+
+    // The line stays low until the port is read, so the level is the reliable signal
+    bool asserted = interruptPin >= 0 && digitalRead(interruptPin) == LOW;
+    bool edgeSeen = interruptPending.exchange(false, std::memory_order_acquire);
+
+    if (!asserted && !edgeSeen && millis() - lastScan < pollInterval) return;
+
+    scan(asserted);
+
+    if (edgeSeen) {
+        uint32_t latency = micros() - interruptMicros.load(std::memory_order_relaxed);
+        stats.lastLatencyUs = latency;
+        if (latency > stats.maxLatencyUs) {
+            stats.maxLatencyUs = latency;
+        }
+    }
+}
+
+uint16_t Mcp23017::getPins() const {
+    return pins;
+}
+
+uint32_t Mcp23017::getScanId() const {
+    return scanId;
+}
+
+uint8_t Mcp23017::getScanSamples(uint16_t* out) const {
+    for (uint8_t i = 0; i < sampleCount; i++) {
+        out[i] = samples[i];
+    }
+    return sampleCount;
+}
+
+int Mcp23017::getInterruptPin() const {
+    return interruptPin;
+}
+
+void Mcp23017::setPollInterval(unsigned long intervalMs) {
+    pollInterval = intervalMs;
+}
+
+const Mcp23017::Stats& Mcp23017::getStats() const {
+    return stats;
+}
+
+// Private methods
+
+bool Mcp23017::writeRegisterPair(uint8_t reg, uint16_t value) {
+    uint8_t data[2] = {(uint8_t)(value & 0xFF), (uint8_t)(value >> 8)};
+    return bus.write(address, reg, data, 2);
+}
+
+void Mcp23017::scan(bool captured) {
+    lastScan = millis();
+
+    // INTCAPA, INTCAPB, GPIOA, GPIOB are consecutive: one burst covers both snapshots
+    uint8_t data[4];
+    bool ok = captured ? bus.read(address, REG_INTCAPA, data, 4) : bus.read(address, REG_GPIOA, data + 2, 2);
+    if (!ok) {
+        stats.failedReads++;
+        return;
+    }
+
+    sampleCount = 0;
+    if (captured) {
+        uint16_t capturedPins = data[0] | (data[1] << 8);
+        if (capturedPins != pins) {
+            samples[sampleCount++] = capturedPins;
+        }
+        stats.interruptScans++;
+    }
+
+    pins = data[2] | (data[3] << 8);
+    samples[sampleCount++] = pins;
+    scanId++;
+    stats.scans++;
+}
+
+void IRAM_ATTR Mcp23017::onInterrupt(void* arg) {
+    Mcp23017* expander = static_cast<Mcp23017*>(arg);
+    expander->interruptMicros.store(micros(), std::memory_order_relaxed);
+    expander->interruptPending.store(true, std::memory_order_release);
+}
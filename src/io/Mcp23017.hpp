@@ -0,0 +1,85 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include "I2CBus.hpp"
+
+// MCP23017 16-bit I2C GPIO expander used as an input port.
+//
+// Pins that devices claim with configureInputs() get interrupt-on-change.
+// Both INT outputs are mirrored onto one open-drain line. service() does
+// nothing until that line is asserted. It then reads INTCAPA..GPIOB in one
+// 4-byte burst, giving the port state when the first pin changed and the
+// state now, so a fast second edge is not lost. The read also clears the
+// interrupt. A slow safety scan runs every pollInterval in case an edge
+// was missed. Without an INT pin, every service() call scans.
+//
+// Devices on the same expander all call service(). Only the first call after
+// an interrupt touches the bus; the rest see the same scan through
+// getScanId() and getScanSamples().
+class Mcp23017 {
+   public:
+    static const uint8_t DEFAULT_ADDRESS = 0x20;
+    static const unsigned long DEFAULT_POLL_INTERVAL = 50;  // ms between safety scans while INT is idle
+    static const uint8_t MAX_SAMPLES = 2;                   // Port states one scan can yield
+
+    struct Stats {
+        uint32_t scans;
+        uint32_t interruptScans;  // Scans started by the INT line
+        uint32_t failedReads;
+        uint32_t lastLatencyUs;   // INT edge to decoded port state
+        uint32_t maxLatencyUs;
+    };
+
+    Mcp23017(I2CBus& bus, uint8_t address = DEFAULT_ADDRESS, int interruptPin = -1);
+    ~Mcp23017();
+
+    // Configure the chip (idempotent; devices call it before claiming pins)
+    bool begin();
+
+    // Make pins inputs with interrupt-on-change; mask bit n = GPA0..GPB7
+    bool configureInputs(uint16_t mask, bool pullup);
+
+    // Scan if the INT line is asserted or a safety scan is due
+    void service();
+
+    // Port state after the last scan (bit n = level of pin n)
+    uint16_t getPins() const;
+
+    // Incremented by every scan
+    uint32_t getScanId() const;
+
+    // Port states seen by the last scan, oldest first; returns how many
+    uint8_t getScanSamples(uint16_t* samples) const;
+
+    int getInterruptPin() const;
+    void setPollInterval(unsigned long intervalMs);
+    const Stats& getStats() const;
+
+   private:
+    I2CBus& bus;
+    uint8_t address;
+    int interruptPin;
+    bool started;
+
+    uint16_t inputMask;
+    uint16_t pullupMask;
+
+    uint16_t pins;
+    uint16_t samples[MAX_SAMPLES];
+    uint8_t sampleCount;
+    uint32_t scanId;
+    unsigned long pollInterval;
+    unsigned long lastScan;
+
+    std::atomic<bool> interruptPending;
+    std::atomic<uint32_t> interruptMicros;
+
+    Stats stats;
+
+    // Internal methods
+    bool writeRegisterPair(uint8_t reg, uint16_t value);
+    void scan(bool captured);
+
+    static void IRAM_ATTR onInterrupt(void* arg);
+};
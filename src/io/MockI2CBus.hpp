@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string.h>
+#include "I2CBus.hpp"
+
+// In-memory I2CBus for running expander drivers on a host.
+//
+// Every 7-bit address has its own 256-byte register file that a test can
+// poke directly (e.g. set the GPIO registers to simulate a pin change).
+// Each transaction adds to a simulated bus time using the same framing as
+// real hardware: start, address byte, register byte, data bytes, stop, with
+// 9 clocks per byte. Reading getBusMicros() around a scan gives its latency
+// at the configured clock without any hardware.
+class MockI2CBus : public I2CBus {
+   public:
+    static const uint32_t DEFAULT_CLOCK = 400000;
+
+    struct Stats {
+        uint32_t writes;
+        uint32_t reads;
+        uint32_t bytes;  // Data bytes moved, excluding address and register bytes
+    };
+
+    explicit MockI2CBus(uint32_t clockHz = DEFAULT_CLOCK) : clockHz(clockHz), busNanos(0), failNext(false) {
+        memset(registers, 0, sizeof(registers));
+        memset(&stats, 0, sizeof(stats));
+    }
+
+    bool write(uint8_t address, uint8_t reg, const uint8_t* data, size_t length) override {
+        stats.writes++;
+        addBusTime(2 + length);  // Address, register, data
+        if (takeFailure()) return false;
+
+        for (size_t i = 0; i < length; i++) {
+            registers[address & 0x7F][(uint8_t)(reg + i)] = data[i];
+        }
+        stats.bytes += length;
+        return true;
+    }
+
+    bool read(uint8_t address, uint8_t reg, uint8_t* data, size_t length) override {
+        stats.reads++;
+        addBusTime(3 + length);  // Address, register, repeated-start address, data
+        if (takeFailure()) return false;
+
+        for (size_t i = 0; i < length; i++) {
+            data[i] = registers[address & 0x7F][(uint8_t)(reg + i)];
+        }
+        stats.bytes += length;
+        return true;
+    }
+
+    // Direct register access for tests
+    uint8_t getRegister(uint8_t address, uint8_t reg) const { return registers[address & 0x7F][reg]; }
+    void setRegister(uint8_t address, uint8_t reg, uint8_t value) { registers[address & 0x7F][reg] = value; }
+
+    // Make the next transaction fail (NACK)
+    void failNextTransaction() { failNext = true; }
+
+    // Simulated time spent on the wire
+    uint32_t getBusMicros() const { return (uint32_t)(busNanos / 1000); }
+    const Stats& getStats() const { return stats; }
+
+   private:
+    uint8_t registers[128][256];
+    uint32_t clockHz;
+    uint64_t busNanos;
+    bool failNext;
+    Stats stats;
+
+    void addBusTime(size_t bytes) {
+        // 9 clocks per byte plus roughly one clock each for start and stop
+        busNanos += (uint64_t)(bytes * 9 + 2) * 1000000000ULL / clockHz;
+    }
+
+    bool takeFailure() {
+        bool fail = failNext;
+        failNext = false;
+        return fail;
+    }
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Arduino.h>
+#include "DeviceId.hpp"
+
+// Base class for all output devices
+//
+// Owners draw into a device whenever their state changes. The device only
+// pushes a frame when the drawing differs from what was last sent, and
+// update() retries a push that found the transmitter busy. Neither ever
+// waits for hardware.
+class OutputDevice {
+   public:
+    enum class DeviceType {
+        LED_RING,
+        CUSTOM
+    };
+
+    OutputDevice(const DeviceId& deviceId, DeviceType type)
+        : id(deviceId), type(type), initialized(false), frameCount(0) {}
+
+    virtual ~OutputDevice() = default;
+
+    // Pure virtual methods that must be implemented by derived classes
+    virtual bool initialize() = 0;
+    virtual void shutdown() = 0;
+    virtual void update() = 0;  // Push the pending frame if the transmitter is free
+    virtual bool hasPendingOutput() const = 0;
+
+    // Common interface methods
+    const DeviceId& getId() const { return id; }
+    DeviceType getType() const { return type; }
+    bool isInitialized() const { return initialized; }
+
+    // Frames actually sent to the hardware
+    uint32_t getFrameCount() const { return frameCount; }
+
+   protected:
+    DeviceId id;
+    DeviceType type;
+    bool initialized;
+    uint32_t frameCount;
+};
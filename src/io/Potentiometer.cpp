@@ -0,0 +1,156 @@
+#include "Potentiometer.hpp"
+#include "AnalogSampler.hpp"
+#include "../core/Log.hpp"
+
+namespace {
+const uint8_t FRACTION_BITS = AnalogSampler::MEAN_FRACTION_BITS;
+}
+
+Potentiometer::Potentiometer(const DeviceId& deviceId, const Config& config)
+    : TypedInputDevice<Potentiometer>(deviceId, DeviceType::POTENTIOMETER),
+      config(config),
+      channel(-1),
+      filtered(0),
+      held(0),
+      primed(false),
+      value(0),
+      reportedValue(0),
+      newInput(false) {
+    if (this->config.step < 1) this->config.step = 1;
+}
+
+Potentiometer::~Potentiometer() {
+    if (initialized) {
+        shutdown();
+    }
+}
+
+bool Potentiometer::initialize() {
+    if (initialized) return true;
+
+    // Continuous mode only drives ADC1, which owns channels 0-7
+    channel = digitalPinToAnalogChannel(config.pin);
+    if (channel < 0 || channel >= AnalogSampler::MAX_CHANNELS) {
+        LOG_ERROR("Potentiometer: GPIO %d is not an ADC1 pin", config.pin);
+        channel = -1;
+        return false;
+    }
+
+    if (!AnalogSampler::getInstance().addChannel(channel, config.attenuation)) {
+        return false;
+    }
+
+    primed = false;
+    newInput = false;
+    initialized = true;
+    return true;
+}
+
+void Potentiometer::shutdown() {
+    if (initialized) {
+        AnalogSampler::getInstance().removeChannel(channel);
+        initialized = false;
+    }
+}
+
+void Potentiometer::update() {
+    if (!initialized) return;
+
+    // One step of the signal chain per batch of DMA samples
+    uint16_t mean;
+    if (!AnalogSampler::getInstance().takeBatch(channel, mean)) return;
+    int32_t reading = mean;
+
+    if (!primed) {
+        // Start where the fader is instead of sweeping up from zero
+        filtered = reading;
+        held = reading;
+        value = toValue(held);
+        reportedValue = value;
+        primed = true;
+        return;
+    }
+
+    // IIR low-pass; arithmetic shift keeps the sign of the difference
+    filtered += (reading - filtered) >> config.filterShift;
+
+    // Hysteresis: ignore wander inside the band, except near the ends so both stops are reachable
+    int32_t band = (int32_t)config.hysteresis << FRACTION_BITS;
+    int32_t low = ((int32_t)config.rawMin << FRACTION_BITS) + band;
+    int32_t high = ((int32_t)config.rawMax << FRACTION_BITS) - band;
+    if (filtered > held + band || filtered < held - band || filtered <= low || filtered >= high) {
+        held = filtered;
+    }
+
+    value = toValue(held);
+    if (value == reportedValue) return;
+
+    int change = value > reportedValue ? value - reportedValue : reportedValue - value;
+    if (change >= config.step || value == 0 || value == config.range) {
+        reportedValue = value;
+        newInput = true;
+        markInput(InputLog::now());
+
+        // Notify subscribers
+        callbacks(value);
+    }
+}
+
+bool Potentiometer::hasNewInput() {
+    return newInput;
+}
+
+void Potentiometer::clearInputFlags() {
+    newInput = false;
+}
+
+int Potentiometer::getValue() const {
+    return reportedValue;
+}
+
+uint16_t Potentiometer::getRaw() const {
+    return (uint16_t)(held >> FRACTION_BITS);
+}
+
+int Potentiometer::getChannel() const {
+    return channel;
+}
+
+void Potentiometer::setStep(int step) {
+    config.step = step < 1 ? 1 : step;
+}
+
+void Potentiometer::setCalibration(uint16_t rawMin, uint16_t rawMax) {
+    config.rawMin = rawMin;
+    config.rawMax = rawMax;
+}
+
+void Potentiometer::setCallback(ValueCallback callback) {
+    callbacks.set(callback);
+}
+
+int Potentiometer::addCallback(ValueCallback callback) {
+    return callbacks.add(callback);
+}
+
+bool Potentiometer::removeCallback(int handle) {
+    return callbacks.remove(handle);
+}
+
+std::unique_ptr<Potentiometer> Potentiometer::create(const DeviceId& deviceId, const Config& config) {
+    return std::unique_ptr<Potentiometer>(new Potentiometer(deviceId, config));
+}
+
+int Potentiometer::toValue(int32_t reading) const {
+    int32_t low = (int32_t)config.rawMin << FRACTION_BITS;
+    int32_t high = (int32_t)config.rawMax << FRACTION_BITS;
+    if (high <= low) return 0;
+
+    if (reading < low) reading = low;
+    if (reading > high) reading = high;
+
+    // Rounded so the top of travel maps exactly to range
+    int32_t span = high - low;
+    int result = (int)(((int64_t)(reading - low) * config.range + span / 2) / span);
+    return config.inverted ? config.range - result : result;
+}
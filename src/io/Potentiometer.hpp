@@ -0,0 +1,78 @@
+#pragma once
+
+#include "InputDevice.hpp"
+#include "../core/InplaceFunction.hpp"
+#include <memory>
+
+// Fader or pot on an ADC1 pin, sampled in the background by AnalogSampler.
+//
+// Each update() takes the oversampled mean of every sample DMA delivered
+// since the last one, runs it through a one-pole IIR filter and a hysteresis
+// band, and maps it onto 0..range. An event fires only when the value has
+// moved by at least step, or has reached either end of its travel.
+class Potentiometer : public TypedInputDevice<Potentiometer> {
+   public:
+    // Callback type
+    using ValueCallback = InplaceFunction<void(int value)>;
+
+    struct Config {
+        int pin;                // Must map to an ADC1 channel (GPIO 32-39)
+        uint8_t attenuation;    // adc_atten_t, 3 = 11 dB for the full 0-3.3 V travel
+        uint16_t rawMin;        // 12-bit reading at the low end of travel
+        uint16_t rawMax;        // 12-bit reading at the high end of travel
+        int range;              // Value at rawMax
+        int step;               // Smallest value change that produces an event
+        uint16_t hysteresis;    // 12-bit counts the filtered reading must move before it is used
+        uint8_t filterShift;    // IIR weight 1/2^filterShift for each new batch, 0 disables filtering
+        bool inverted;          // Swap the ends of travel
+
+        Config() : pin(36), attenuation(3), rawMin(0), rawMax(4095), range(100), step(1), hysteresis(8),
+                   filterShift(2), inverted(false) {}
+    };
+
+    Potentiometer(const DeviceId& deviceId, const Config& config);
+    ~Potentiometer() override;
+
+    // InputDevice interface
+    bool initialize() override;
+    void shutdown() override;
+    void update() override;
+    bool hasNewInput() override;
+    void clearInputFlags() override;
+
+    // Potentiometer-specific methods
+    int getValue() const;
+    uint16_t getRaw() const;  // Filtered 12-bit reading
+    int getChannel() const;   // ADC1 channel, -1 if the pin has none
+
+    // Configuration methods
+    void setStep(int step);
+    void setCalibration(uint16_t rawMin, uint16_t rawMax);
+
+    // Callback methods (set replaces all subscribers; add returns a handle for remove, -1 when full)
+    void setCallback(ValueCallback callback);
+    int addCallback(ValueCallback callback);
+    bool removeCallback(int handle);
+
+    // Static factory method
+    static std::unique_ptr<Potentiometer> create(const DeviceId& deviceId, const Config& config);
+
+   private:
+    Config config;
+    int channel;
+
+    // Signal chain state, 12-bit readings scaled by AnalogSampler::MEAN_FRACTION_BITS
+    int32_t filtered;
+    int32_t held;  // Filtered value after hysteresis
+    bool primed;   // First batch seeds the filter instead of ramping to it
+
+    int value;
+    int reportedValue;
+    bool newInput;
+
+    // Callbacks
+    CallbackList<void(int value), MAX_CALLBACKS> callbacks;
+
+    // Private methods
+    int toValue(int32_t reading) const;
+};
@@ -1,9 +1,19 @@
 #include "RotaryEncoder.hpp"
+#include "../core/Log.hpp"
+#include "../core/PowerManager.hpp"
 
-RotaryEncoder::RotaryEncoder(const String& deviceId, const Config& config)
+namespace {
+const uint32_t APB_CYCLES_PER_US = 80;  // PCNT filter clock
+}
+
+RotaryEncoder::RotaryEncoder(const DeviceId& deviceId, const Config& config)
     : TypedInputDevice<RotaryEncoder>(deviceId, DeviceType::ENCODER),
       config(config),
-      lastPosition(0),
+      benchMode(false),
+      benchRawEdges(0),
+      benchGlitches(0),
+      benchSteps(0),
+      detentPosition(0),
       delta(0),
       newEncoderInput(false),
       buttonState(false),
@@ -11,7 +21,10 @@ RotaryEncoder::RotaryEncoder(const String& deviceId, const Config& config)
       buttonPressed(false),
       buttonReleased(false),
       lastButtonChange(0),
-      newButtonInput(false) {
+      newButtonInput(false),
+      glitchCycles(0) {
+    if (this->config.countsPerDetent == 0) this->config.countsPerDetent = 1;
+    if (this->config.filterNs > MAX_FILTER_NS) this->config.filterNs = MAX_FILTER_NS;
 }
 
 RotaryEncoder::~RotaryEncoder() {
@@ -34,6 +47,7 @@ bool RotaryEncoder::initialize() {
 
 void RotaryEncoder::shutdown() {
     if (initialized) {
+        setBenchMode(false);
         initialized = false;
     }
 }
@@ -59,12 +73,16 @@ void RotaryEncoder::clearInputFlags() {
     delta = 0;
 }
 
-long RotaryEncoder::getPosition() const {
-    if (!initialized) return 0;
+uint8_t RotaryEncoder::getWakePins(int* pins, uint8_t maxPins) const {
+    uint8_t count = 0;
+    if (count < maxPins) pins[count++] = config.pinA;
+    if (count < maxPins) pins[count++] = config.pinB;
+    if (config.hasButton && count < maxPins) pins[count++] = config.buttonPin;
+    return count;
+}
 
-    // Need to cast away const for ESP32Encoder API
-    long position = const_cast<ESP32Encoder&>(encoder).getCount();
-    return config.reversed ? -position : position;
+int64_t RotaryEncoder::getPosition() const {
+    return initialized ? detentPosition : 0;
 }
 
 int RotaryEncoder::getDelta() const {
@@ -74,17 +92,21 @@ int RotaryEncoder::getDelta() const {
 void RotaryEncoder::resetPosition() {
     if (!initialized) return;
 
-    encoder.clearCount();
-    lastPosition = 0;
+    writeHardwareCount(0);
+    detentPosition = 0;
     delta = 0;
 }
 
-void RotaryEncoder::setPosition(long position) {
+void RotaryEncoder::setPosition(int64_t position) {
     if (!initialized) return;
 
-    long actualPosition = config.reversed ? -position : position;
-    encoder.setCount(actualPosition);
-    lastPosition = actualPosition;
+    int64_t count = position * config.countsPerDetent;
+    writeHardwareCount(config.reversed ? -count : count);
+    detentPosition = position;
+}
+
+int64_t RotaryEncoder::getRawCount() const {
+    return initialized ? readCount() : 0;
 }
 
 bool RotaryEncoder::isButtonPressed() const {
@@ -108,26 +130,120 @@ bool RotaryEncoder::wasButtonReleased() {
 }
 
 void RotaryEncoder::setReversed(bool reversed) {
+    if (reversed == config.reversed) return;
+
+    // The count flips sign, so flip the detent position with it
     config.reversed = reversed;
+    detentPosition = -detentPosition;
+}
+
+bool RotaryEncoder::isReversed() const {
+    return config.reversed;
 }
 
 void RotaryEncoder::setButtonDebounceTime(unsigned long debounceMs) {
     config.debounceTime = debounceMs;
 }
 
+void RotaryEncoder::setFilter(uint16_t filterNs) {
+    config.filterNs = filterNs > MAX_FILTER_NS ? MAX_FILTER_NS : filterNs;
+    if (initialized) {
+        applyFilter();
+    }
+}
+
+uint16_t RotaryEncoder::getFilter() const {
+    return config.filterNs;
+}
+
+void RotaryEncoder::setBenchMode(bool enable) {
+    if (!initialized || enable == benchMode) return;
+
+    int pins[2] = {config.pinA, config.pinB};
+    if (enable) {
+        resetBenchStats();
+        for (uint8_t i = 0; i < 2; i++) {
+            benchPins[i].owner = this;
+            benchPins[i].pin = pins[i];
+            benchPins[i].lastEdgeCycles = ESP.getCycleCount();
+            attachInterruptArg(pins[i], onBenchEdge, &benchPins[i], CHANGE);
+        }
+
+        // Light sleep stops the clocks and would drop edges from the count
+        PowerManager::getInstance().holdAwake();
+        benchMode = true;
+    } else {
+        for (uint8_t i = 0; i < 2; i++) {
+            detachInterrupt(pins[i]);
+        }
+        PowerManager::getInstance().releaseAwake();
+        benchMode = false;
+
+        BenchStats bench = getBenchStats();
+        LOG_INFO("Encoder: %08lx bench %u edges, %u glitches rejected, %u steps", (unsigned long)getId().hash(),
+                 bench.rawEdges, bench.glitchCount, bench.detentSteps);
+    }
+}
+
+bool RotaryEncoder::isBenchMode() const {
+    return benchMode;
+}
+
+RotaryEncoder::BenchStats RotaryEncoder::getBenchStats() const {
+    BenchStats bench;
+    bench.rawEdges = benchRawEdges.load(std::memory_order_relaxed);
+    bench.glitchCount = benchGlitches.load(std::memory_order_relaxed);
+    bench.detentSteps = benchSteps;
+    return bench;
+}
+
+void RotaryEncoder::resetBenchStats() {
+    benchRawEdges.store(0, std::memory_order_relaxed);
+    benchGlitches.store(0, std::memory_order_relaxed);
+    benchSteps = 0;
+}
+
 void RotaryEncoder::setEncoderCallback(EncoderCallback callback) {
-    encoderCallback = callback;
+    encoderCallbacks.set(callback);
+}
+
+int RotaryEncoder::addEncoderCallback(EncoderCallback callback) {
+    return encoderCallbacks.add(callback);
+}
+
+bool RotaryEncoder::removeEncoderCallback(int handle) {
+    return encoderCallbacks.remove(handle);
 }
 
 void RotaryEncoder::setButtonCallback(ButtonCallback callback) {
-    buttonCallback = callback;
+    buttonCallbacks.set(callback);
+}
+
+int RotaryEncoder::addButtonCallback(ButtonCallback callback) {
+    return buttonCallbacks.add(callback);
+}
+
+bool RotaryEncoder::removeButtonCallback(int handle) {
+    return buttonCallbacks.remove(handle);
+}
+
+GestureRecognizer& RotaryEncoder::getButtonGestures() {
+    return buttonGestures;
 }
 
-std::unique_ptr<RotaryEncoder> RotaryEncoder::create(const String& deviceId, const Config& config) {
+std::unique_ptr<RotaryEncoder> RotaryEncoder::create(const DeviceId& deviceId, const Config& config) {
     return std::unique_ptr<RotaryEncoder>(new RotaryEncoder(deviceId, config));
 }
 
 void RotaryEncoder::setupEncoder() {
+    attachCounter();
+
+    detentPosition = 0;
+    delta = 0;
+    newEncoderInput = false;
+}
+
+void RotaryEncoder::attachCounter() {
     // Setup pins
     if (config.enablePullups) {
         pinMode(config.pinA, INPUT_PULLUP);
@@ -139,60 +255,98 @@ void RotaryEncoder::setupEncoder() {
 
     // Initialize ESP32Encoder
     ESP32Encoder::useInternalWeakPullResistors = config.enablePullups ? puType::up : puType::none;
-    encoder.attachFullQuad(config.pinA, config.pinB);
+    switch (config.countMode) {
+        case CountMode::HALF_QUAD:
+            encoder.attachHalfQuad(config.pinA, config.pinB);
+            break;
+        case CountMode::SINGLE_EDGE:
+            encoder.attachSingleEdge(config.pinA, config.pinB);
+            break;
+        case CountMode::FULL_QUAD:
+        default:
+            encoder.attachFullQuad(config.pinA, config.pinB);
+            break;
+    }
+    applyFilter();
     encoder.clearCount();
+}
 
-    lastPosition = 0;
-    delta = 0;
-    newEncoderInput = false;
+void RotaryEncoder::applyFilter() {
+    // The filter counts APB cycles; 0 turns it off
+    encoder.setFilter((uint16_t)((uint32_t)config.filterNs * APB_CYCLES_PER_US / 1000));
+
+    // Bench mode compares raw edge spacing against the same width in CPU cycles
+    glitchCycles = (uint32_t)config.filterNs * getCpuFrequencyMhz() / 1000;
+}
+
+int64_t RotaryEncoder::readHardwareCount() const {
+    // Need to cast away const for ESP32Encoder API
+    return const_cast<ESP32Encoder&>(encoder).getCount();
+}
+
+void RotaryEncoder::writeHardwareCount(int64_t count) {
+    encoder.setCount(count);
+}
+
+int64_t RotaryEncoder::readCount() const {
+    int64_t count = tapRaw(0, true, [this] { return readHardwareCount(); });
+    return config.reversed ? -count : count;
 }
 
 void RotaryEncoder::setupButton() {
     if (!config.hasButton) return;
 
-    if (config.enablePullups) {
-        pinMode(config.buttonPin, INPUT_PULLUP);
-    } else {
-        pinMode(config.buttonPin, INPUT);
-    }
+    configureButtonPin();
 
     // Initialize button state
     buttonState = readButtonRaw();
     lastButtonState = buttonState;
     buttonPressed = false;
     buttonReleased = false;
-    lastButtonChange = millis();
+    lastButtonChange = InputLog::now();
     newButtonInput = false;
 }
 
 void RotaryEncoder::updateEncoder() {
-    long currentPosition = encoder.getCount();
-
-    // Apply direction reversal if needed
-    if (config.reversed) {
-        currentPosition = -currentPosition;
+    int64_t count = readCount();
+
+    // Step only once the count is a whole detent away from the current one
+    int64_t countsPerDetent = config.countsPerDetent;
+    int64_t anchor = detentPosition * countsPerDetent;
+    int64_t steps = 0;
+    if (count >= anchor + countsPerDetent) {
+        steps = (count - anchor) / countsPerDetent;
+    } else if (count <= anchor - countsPerDetent) {
+        steps = -((anchor - count) / countsPerDetent);
     }
 
-    // Calculate delta
-    int currentDelta = (int)(currentPosition - lastPosition);
+    if (steps != 0) {
+        detentPosition += steps;
+
+        // Callbacks take an int; a jump that large only happens after setCount() misuse
+        if (steps > INT32_MAX) steps = INT32_MAX;
+        if (steps < -INT32_MAX) steps = -INT32_MAX;
+        int currentDelta = (int)steps;
+
+        if (benchMode) {
+            benchSteps += currentDelta < 0 ? -currentDelta : currentDelta;
+        }
 
-    if (currentDelta != 0) {
         delta = currentDelta;
-        lastPosition = currentPosition;
         newEncoderInput = true;
+        markInput(InputLog::now());
 
-        // Call callback if set
-        if (encoderCallback) {
-            encoderCallback(currentDelta);
-        }
+        // Notify subscribers
+        encoderCallbacks(currentDelta);
     }
 }
 
 void RotaryEncoder::updateButton() {
     if (!config.hasButton) return;
 
-    unsigned long currentTime = millis();
-    bool currentReading = readButtonRaw();
+    unsigned long currentTime = InputLog::now();
+    bool currentReading = tapRaw(1, false, [this] { return readButtonRaw(); }) != 0;
+    buttonGestures.tick(currentTime);
 
     // Debouncing logic
     if (currentReading != lastButtonState) {
@@ -204,6 +358,7 @@ void RotaryEncoder::updateButton() {
         if (currentReading != buttonState) {
             buttonState = currentReading;
             newButtonInput = true;
+            markInput(currentTime);
 
             if (buttonState) {
                 buttonPressed = true;
@@ -211,16 +366,23 @@ void RotaryEncoder::updateButton() {
                 buttonReleased = true;
             }
 
-            // Call callback if set
-            if (buttonCallback) {
-                buttonCallback(buttonState);
-            }
+            // Notify subscribers
+            buttonCallbacks(buttonState);
+            buttonGestures.onTransition(buttonState, currentTime);
         }
     }
 
     lastButtonState = currentReading;
 }
 
+void RotaryEncoder::configureButtonPin() {
+    if (config.enablePullups) {
+        pinMode(config.buttonPin, INPUT_PULLUP);
+    } else {
+        pinMode(config.buttonPin, INPUT);
+    }
+}
+
 bool RotaryEncoder::readButtonRaw() {
     if (!config.hasButton) return false;
 
@@ -230,4 +392,17 @@ bool RotaryEncoder::readButtonRaw() {
     } else {
         return digitalRead(config.buttonPin);
     }
-}
\ No newline at end of file
+}
+
+void IRAM_ATTR RotaryEncoder::onBenchEdge(void* arg) {
+    BenchPin* benchPin = static_cast<BenchPin*>(arg);
+    RotaryEncoder* owner = benchPin->owner;
+    uint32_t now = ESP.getCycleCount();
+
+    // A second edge inside the filter width closes a pulse PCNT never counted
+    if (now - benchPin->lastEdgeCycles < owner->glitchCycles) {
+        owner->benchGlitches.fetch_add(1, std::memory_order_relaxed);
+    }
+    benchPin->lastEdgeCycles = now;
+    owner->benchRawEdges.fetch_add(1, std::memory_order_relaxed);
+}
@@ -1,15 +1,43 @@
 #pragma once
 
 #include "InputDevice.hpp"
+#include "GestureRecognizer.hpp"
 #include <ESP32Encoder.h>
-#include <functional>
+#include <atomic>
+#include "../core/InplaceFunction.hpp"
 #include <memory>
 
+// Quadrature encoder counted by the PCNT peripheral.
+//
+// The PCNT input filter drops pulses narrower than Config::filterNs before
+// they reach the counter, so contact bounce never costs CPU time. Counts are
+// quantized to detents: the position only moves once the count has travelled
+// a full detent from the last one, so a count rocking on a detent edge does
+// not produce +1/-1 pairs. Positions are 64-bit and never wrap.
+//
+// Bench mode additionally timestamps every raw edge on A and B in a GPIO
+// interrupt and counts the pulses the filter rejected. It costs an interrupt
+// per edge, so leave it off in normal use.
 class RotaryEncoder : public TypedInputDevice<RotaryEncoder> {
    public:
+    enum class CountMode : uint8_t {
+        FULL_QUAD,   // Every edge on A and B (4 counts per quadrature cycle)
+        HALF_QUAD,   // Both edges of A (2 counts per cycle)
+        SINGLE_EDGE  // Rising edge of A (1 count per cycle)
+    };
+
+    static const uint16_t DEFAULT_FILTER_NS = 10000;  // Pulses shorter than this are ignored by PCNT
+    static const uint16_t MAX_FILTER_NS = 12787;      // 1023 APB cycles, the widest PCNT filter
+
+    struct BenchStats {
+        uint32_t rawEdges;     // Edges seen on A and B
+        uint32_t glitchCount;  // Pulses narrower than the filter (rejected by PCNT)
+        uint32_t detentSteps;  // Accepted detent steps
+    };
+
     // Callback types
-    using EncoderCallback = std::function<void(int delta)>;
-    using ButtonCallback = std::function<void(bool pressed)>;
+    using EncoderCallback = InplaceFunction<void(int delta)>;
+    using ButtonCallback = InplaceFunction<void(bool pressed)>;
 
     struct Config {
         int pinA;
@@ -19,11 +47,15 @@ class RotaryEncoder : public TypedInputDevice<RotaryEncoder> {
         bool enablePullups;
         unsigned long debounceTime;
         bool hasButton;
+        CountMode countMode;
+        uint8_t countsPerDetent;  // Counts (in countMode) between two detents
+        uint16_t filterNs;        // PCNT glitch filter width, 0 disables it
 
-        Config() : pinA(32), pinB(33), buttonPin(25), reversed(false), enablePullups(true), debounceTime(50), hasButton(true) {}
+        Config() : pinA(32), pinB(33), buttonPin(25), reversed(false), enablePullups(true), debounceTime(50), hasButton(true),
+                   countMode(CountMode::FULL_QUAD), countsPerDetent(1), filterNs(DEFAULT_FILTER_NS) {}
     };
 
-    RotaryEncoder(const String& deviceId, const Config& config);
+    RotaryEncoder(const DeviceId& deviceId, const Config& config);
     ~RotaryEncoder() override;
 
     // InputDevice interface
@@ -32,12 +64,14 @@ class RotaryEncoder : public TypedInputDevice<RotaryEncoder> {
     void update() override;
     bool hasNewInput() override;
     void clearInputFlags() override;
+    uint8_t getWakePins(int* pins, uint8_t maxPins) const override;
 
-    // Encoder-specific methods
-    long getPosition() const;
+    // Encoder-specific methods (positions are in detents)
+    int64_t getPosition() const;
     int getDelta() const;
     void resetPosition();
-    void setPosition(long position);
+    void setPosition(int64_t position);
+    int64_t getRawCount() const;  // Hardware count, before detent quantization
 
     // Button methods (if enabled)
     bool isButtonPressed() const;
@@ -46,21 +80,53 @@ class RotaryEncoder : public TypedInputDevice<RotaryEncoder> {
 
     // Configuration methods
     void setReversed(bool reversed);
+    bool isReversed() const;
     void setButtonDebounceTime(unsigned long debounceMs);
+    void setFilter(uint16_t filterNs);
+    uint16_t getFilter() const;
+
+    // Bench mode (raw edge timing to count rejected glitches)
+    virtual void setBenchMode(bool enable);
+    bool isBenchMode() const;
+    BenchStats getBenchStats() const;
+    void resetBenchStats();
 
-    // Callback methods
+    // Callback methods (set replaces all subscribers; add returns a handle for remove, -1 when full)
     void setEncoderCallback(EncoderCallback callback);
+    int addEncoderCallback(EncoderCallback callback);
+    bool removeEncoderCallback(int handle);
     void setButtonCallback(ButtonCallback callback);
+    int addButtonCallback(ButtonCallback callback);
+    bool removeButtonCallback(int handle);
+
+    // Gestures of the push button (if enabled)
+    GestureRecognizer& getButtonGestures();
 
     // Static factory method for easy creation
-    static std::unique_ptr<RotaryEncoder> create(const String& deviceId, const Config& config);
+    static std::unique_ptr<RotaryEncoder> create(const DeviceId& deviceId, const Config& config);
 
-   private:
+   protected:
     Config config;
+
+    // Bench counters, also fed by software-decoded subclasses
+    bool benchMode;
+    std::atomic<uint32_t> benchRawEdges;
+    std::atomic<uint32_t> benchGlitches;
+    uint32_t benchSteps;
+
+    // Hardware hooks, overridden by encoders that are not counted by PCNT
+    virtual void attachCounter();
+    virtual void applyFilter();
+    virtual int64_t readHardwareCount() const;  // Before direction reversal
+    virtual void writeHardwareCount(int64_t count);
+    virtual void configureButtonPin();
+    virtual bool readButtonRaw();
+
+   private:
     ESP32Encoder encoder;
 
     // Encoder state
-    long lastPosition;
+    int64_t detentPosition;  // In detents, direction already applied
     int delta;
     bool newEncoderInput;
 
@@ -72,14 +138,26 @@ class RotaryEncoder : public TypedInputDevice<RotaryEncoder> {
     unsigned long lastButtonChange;
     bool newButtonInput;
 
+    // Bench mode; one edge timer per encoder pin, written only from the GPIO interrupt
+    struct BenchPin {
+        RotaryEncoder* owner;
+        int pin;
+        uint32_t lastEdgeCycles;
+    };
+    BenchPin benchPins[2];
+    uint32_t glitchCycles;  // Filter width in CPU cycles
+
     // Callbacks
-    EncoderCallback encoderCallback;
-    ButtonCallback buttonCallback;
+    CallbackList<void(int delta), MAX_CALLBACKS> encoderCallbacks;
+    CallbackList<void(bool pressed), MAX_CALLBACKS> buttonCallbacks;
+    GestureRecognizer buttonGestures;
 
     // Private methods
     void setupEncoder();
+    int64_t readCount() const;
     void setupButton();
     void updateEncoder();
     void updateButton();
-    bool readButtonRaw();
+
+    static void IRAM_ATTR onBenchEdge(void* arg);
 };
\ No newline at end of file
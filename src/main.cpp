@@ -1,33 +1,116 @@
 #include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+#include <freertos/task.h>
+#include "core/BootProfiler.hpp"
+#include "core/Log.hpp"
+#include "core/PerfCounters.hpp"
+#include "core/PowerManager.hpp"
+#include "core/Scheduler.hpp"
+#include "core/StateStore.hpp"
 #include "io/IO.hpp"
+#include "mixer/Mixer.hpp"
+#include "network/ApiServer.hpp"
+#include "network/MqttPublisher.hpp"
+#include "network/Network.hpp"
+#include "network/StatePushServer.hpp"
+#include "protocol/SerialLink.hpp"
 #include "ui/UI.hpp"
 
-// Progress bar state
-int targetProgressValue = 50;        // Target value from encoder
-float currentProgressValue = 50.0f;  // Current animated value
-bool needsDisplayUpdate = true;
-unsigned long lastDisplayUpdate = 0;
+// Mixer channel shown on the progress bar screen
+int progressChannel = 0;
+
+// WS2812 ring around the encoder, mirroring the channel level
+const int LED_RING_PIN = 26;
+RmtFrameSink ringSink(LED_RING_PIN);
+LedRing* progressRing = nullptr;
+
 unsigned long lastAnimationUpdate = 0;
+const unsigned long INPUT_UPDATE_INTERVAL = 1;       // Poll input devices every 1ms
+const unsigned long INPUT_IDLE_INTERVAL = 50;        // Poll rate while light sleep is allowed (pin edges wake us)
+const unsigned long NETWORK_UPDATE_INTERVAL = 10;    // Wake the network task to service WiFi and endpoints every 10ms
+const unsigned long SERIAL_UPDATE_INTERVAL = 10;     // Batch channel changes into one host frame every 10ms
 const unsigned long DISPLAY_UPDATE_INTERVAL = 100;   // Update display every 100ms for better responsiveness
 const unsigned long ANIMATION_UPDATE_INTERVAL = 16;  // Update animation every 16ms (60 FPS)
-const float ANIMATION_SPEED = 12.0f;                 // Progress units per animation frame (much faster)
+const unsigned long STORAGE_UPDATE_INTERVAL = 250;   // Check whether changed state has settled enough to save
+const unsigned long BOOT_CHECK_INTERVAL = 100;       // Poll for the end of boot to print the profile
+const unsigned long PERF_REFRESH_INTERVAL = 1000;    // Partial refresh of the performance screen
+const int PROGRESS_SCREEN = 7;                       // UI SCREEN_PROGRESS_BAR
+const int PERFORMANCE_SCREEN = 8;                    // UI SCREEN_PERFORMANCE
+
+// Boot runs display, WiFi and IO setup in parallel; these bits are their dependencies
+EventGroupHandle_t bootEvents = nullptr;
+const EventBits_t BOOT_STATE_READY = 1 << 0;    // IO initialized and mixer state restored
+const EventBits_t BOOT_FIRST_FRAME = 1 << 1;    // Progress screen drawn
+const EventBits_t BOOT_NETWORK_READY = 1 << 2;  // WiFi initialized, first connect attempt finished, endpoints up
+const EventBits_t BOOT_ALL = BOOT_STATE_READY | BOOT_FIRST_FRAME | BOOT_NETWORK_READY;
+int bootReportJob = Scheduler::INVALID_JOB;
+
+// Input and every scheduler job run on core 0 (beside the WiFi stack). WiFi
+// and the network endpoints get their own task on core 0 below the control
+// task, because connecting and broker reconnects block for seconds. E-paper
+// rendering runs on core 1. Both only read Mixer snapshots.
+const BaseType_t CONTROL_CORE = 0;
+const BaseType_t NETWORK_CORE = 0;
+const BaseType_t UI_CORE = 1;
+const uint32_t CONTROL_TASK_STACK_SIZE = 8192;
+const uint32_t NETWORK_TASK_STACK_SIZE = 8192;
+const uint32_t UI_TASK_STACK_SIZE = 6144;
+const UBaseType_t CONTROL_TASK_PRIORITY = 2;  // Above the UI so input never waits for a refresh
+const UBaseType_t NETWORK_TASK_PRIORITY = 1;  // Below control so a blocking connect never delays input
+const UBaseType_t UI_TASK_PRIORITY = 1;
+
+// Network task and its pass in flight (the scheduler job kicks it, the task clears this when done)
+TaskHandle_t networkHandle = nullptr;
+std::atomic<bool> networkBusy(false);
 
 // Forward declarations
 void updateDisplay();
-void updateAnimation();
+void updateAnimation(unsigned long elapsedMs);
+void publishChanges();
+void scheduleJobs();
+void controlTask(void* parameter);
+void uiTask(void* parameter);
+void networkTask(void* parameter);
+void serviceNetwork();
+void reportBoot();
+bool bootReached(EventBits_t bits);
 
 void setup() {
     Serial.begin(115200);
-    delay(1000);
 
-    Serial.println("Starting Progress Bar Controller with E-Paper Display");
+    BootProfiler& profiler = BootProfiler::getInstance();
+    profiler.mark("setup");
 
-    // Initialize UI system first
-    UI& ui = UI::getInstance();
-    ui.initialize();
+    // Logging first so every later module can use it
+    Log::getInstance().initialize();
 
-    // Get the IO manager instance
+    // Tasks whose stack headroom the performance screen shows
+    PerfCounters& perf = PerfCounters::getInstance();
+    perf.registerTask("log", Log::getInstance().getTaskHandle());
+
+    LOG_INFO("Starting Progress Bar Controller with E-Paper Display");
+
+    // Create every singleton the boot tasks use before they start
     IO& io = IO::getInstance();
+    Mixer& mixer = Mixer::getInstance();
+    UI::getInstance();
+    Network::getInstance();
+    SerialLink::getInstance();
+    PowerManager::getInstance();
+
+    // Display and WiFi bring-up block for a long time; run them beside IO setup.
+    // The UI and network tasks keep running after boot.
+    bootEvents = xEventGroupCreate();
+    TaskHandle_t uiHandle = nullptr;
+    xTaskCreatePinnedToCore(uiTask, "ui", UI_TASK_STACK_SIZE, nullptr, UI_TASK_PRIORITY, &uiHandle, UI_CORE);
+    xTaskCreatePinnedToCore(networkTask, "network", NETWORK_TASK_STACK_SIZE, nullptr, NETWORK_TASK_PRIORITY,
+                            &networkHandle, NETWORK_CORE);
+    perf.registerTask("ui", uiHandle);
+    perf.registerTask("net", networkHandle);
+
+    progressChannel = mixer.addChannel(50);
 
     // Configure single rotary encoder
     RotaryEncoder::Config encoderConfig;
@@ -40,124 +123,313 @@ void setup() {
 
     RotaryEncoder* encoder = io.addRotaryEncoder("progress_encoder", encoderConfig);
 
-    // Set up encoder callbacks
+    // Encoder rotation drives the channel target, the button resets it
     if (encoder) {
-        encoder->setEncoderCallback([](int delta) {
-            // Update target progress value with encoder movement
-            targetProgressValue += delta;
-
-            // Clamp to 0-100 range
-            if (targetProgressValue < 0) targetProgressValue = 0;
-            if (targetProgressValue > 100) targetProgressValue = 100;
-
-            Serial.printf("Target Progress: %d%% (delta: %d)\n", targetProgressValue, delta);
-        });
+        mixer.bindEncoder(progressChannel, encoder);
 
         encoder->setButtonCallback([](bool pressed) {
             if (pressed) {
                 // Reset to 50% when button is pressed
-                targetProgressValue = 50;
-                Serial.println("Target progress reset to 50%");
+                Mixer::getInstance().setTarget(progressChannel, 50);
             }
         });
     }
 
+    // The ring shows the animated level; it is drawn from publishChanges()
+    if (ringSink.begin()) {
+        progressRing = io.addLedRing("progress_ring", ringSink);
+    } else {
+        LOG_WARN("LED ring: RMT channel unavailable");
+    }
+
     // Initialize the IO system
     io.initialize();
+    profiler.mark("io ready");
+
+    // Restore the saved levels; the display task waits for this before its first frame
+    StateStore& store = StateStore::getInstance();
+    store.initialize();
+    store.restore();
+    mixer.publish();
+    profiler.mark("state restored");
+    xEventGroupSetBits(bootEvents, BOOT_STATE_READY);
+
+    // Binary channel to the PC host
+    SerialLink::getInstance().initialize();
+
+    // Hand the initial channel state to every consumer
+    publishChanges();
+
+    LOG_INFO("Progress bar controller initialized");
+    LOG_INFO("- Turn encoder to adjust progress (0-100%%)");
+    LOG_INFO("- Press encoder button to reset to 50%%");
+    LOG_INFO("- Progress displayed on e-paper screen");
+
+    scheduleJobs();
+    profiler.mark("scheduler ready");
+
+    // From here on the Mixer and every scheduler job belong to the control task
+    TaskHandle_t controlHandle = nullptr;
+    xTaskCreatePinnedToCore(controlTask, "control", CONTROL_TASK_STACK_SIZE, nullptr, CONTROL_TASK_PRIORITY,
+                            &controlHandle, CONTROL_CORE);
+    perf.registerTask("ctrl", controlHandle);
+}
+
+void loop() {
+    // Work runs in the pinned control and UI tasks; the Arduino loop task is not needed
+    vTaskDelete(nullptr);
+}
 
-    // Set to progress bar screen
-    ui.setCurrentScreen(7);  // SCREEN_PROGRESS_BAR
+void controlTask(void* parameter) {
+    uint32_t lastPass = micros();
 
-    Serial.println("Progress bar controller initialized");
-    Serial.println("- Turn encoder to adjust progress (0-100%)");
-    Serial.println("- Press encoder button to reset to 50%");
-    Serial.println("- Progress displayed on e-paper screen");
+    for (;;) {
+        // Time between passes, including any light sleep
+        uint32_t now = micros();
+        PerfCounters::getInstance().recordLoopPeriod(now - lastPass);
+        lastPass = now;
 
-    // Initial display update
-    updateDisplay();
+        // Run every job that is due, then sleep until the next one
+        Scheduler::getInstance().run();
+        PowerManager::getInstance().idle();
+    }
 }
 
-void loop() {
-    // Update all input devices
-    IO::getInstance().update();
+void scheduleJobs() {
+    Scheduler& scheduler = Scheduler::getInstance();
 
-    unsigned long currentTime = millis();
+    // Update all input devices and forward mixer changes to the UI, serial and LED consumers
+    int inputJob = scheduler.addPeriodic("io", INPUT_UPDATE_INTERVAL, [](void*) {
+        static bool firstPoll = true;
+        if (firstPoll) {
+            firstPoll = false;
+            BootProfiler::getInstance().mark("first input accepted");
+        }
 
-    // Update animation at regular intervals
-    if ((currentTime - lastAnimationUpdate) >= ANIMATION_UPDATE_INTERVAL) {
-        updateAnimation();
+        uint32_t start = micros();
+        IO::getInstance().update();
+        PerfCounters::getInstance().recordIOUpdate(micros() - start);
+
+        publishChanges();
+    });
+
+    // Light sleep between jobs once input goes quiet (held off until boot finishes)
+    PowerManager& power = PowerManager::getInstance();
+    power.initialize();
+    power.setInputJob(inputJob, INPUT_UPDATE_INTERVAL, INPUT_IDLE_INTERVAL);
+    power.setEnabled(false);
+
+    // Keep WiFi alive and serve state to WebSocket/MQTT/HTTP clients. The work runs on the network
+    // task; this only wakes it, and holds off light sleep until its pass is done. A pass still
+    // running (a reconnect blocks for seconds) is not queued up again.
+    scheduler.addPeriodic("network", NETWORK_UPDATE_INTERVAL, [](void*) {
+        if (!bootReached(BOOT_NETWORK_READY) || networkBusy.exchange(true)) return;
+
+        PowerManager::getInstance().holdAwake();
+        xTaskNotifyGive(networkHandle);
+    });
+
+    // Exchange binary frames with the PC host
+    scheduler.addPeriodic("serial", SERIAL_UPDATE_INTERVAL, [](void*) {
+        SerialLink::getInstance().update();
+    });
+
+    // Update animation, integrating however much time really passed, and publish the new levels
+    lastAnimationUpdate = millis();
+    scheduler.addPeriodic("animation", ANIMATION_UPDATE_INTERVAL, [](void*) {
+        unsigned long currentTime = millis();
+        updateAnimation(currentTime - lastAnimationUpdate);
         lastAnimationUpdate = currentTime;
-    }
+        publishChanges();
+    });
+
+    // Save mixer state once it has stopped changing
+    scheduler.addPeriodic("storage", STORAGE_UPDATE_INTERVAL, [](void*) {
+        StateStore::getInstance().update();
+    });
+
+    // Print the boot profile once every boot task has finished
+    bootReportJob = scheduler.addOneShot("boot", BOOT_CHECK_INTERVAL, [](void*) {
+        if (!bootReached(BOOT_ALL)) {
+            Scheduler::getInstance().reschedule(bootReportJob, BOOT_CHECK_INTERVAL);
+            return;
+        }
+        reportBoot();
+    });
+}
+
+void uiTask(void* parameter) {
+    BootProfiler& profiler = BootProfiler::getInstance();
 
-    // Update display if needed and enough time has passed
-    if (needsDisplayUpdate && (currentTime - lastDisplayUpdate) >= DISPLAY_UPDATE_INTERVAL) {
+    UI& ui = UI::getInstance();
+    ui.initialize();
+    profiler.mark("display ready");
+
+    // The first frame shows the restored level, so no second refresh is needed
+    xEventGroupWaitBits(bootEvents, BOOT_STATE_READY, pdFALSE, pdTRUE, portMAX_DELAY);
+    Mixer::Snapshot state;
+    Mixer::getInstance().readSnapshot(state);
+    ui.setProgressValue(state.current[progressChannel]);
+    ui.setCurrentScreen(PROGRESS_SCREEN);
+    profiler.mark("first frame");
+
+    xEventGroupSetBits(bootEvents, BOOT_FIRST_FRAME);
+
+    TickType_t lastWake = xTaskGetTickCount();
+    for (;;) {
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(DISPLAY_UPDATE_INTERVAL));
         updateDisplay();
-        needsDisplayUpdate = false;
-        lastDisplayUpdate = currentTime;
     }
-
-    delay(1);  // Small delay for stability
 }
 
-void updateAnimation() {
-    // Smoothly animate current value toward target value
-    float difference = targetProgressValue - currentProgressValue;
+void networkTask(void* parameter) {
+    BootProfiler& profiler = BootProfiler::getInstance();
 
-    if (abs(difference) > 0.1f) {
-        // Use adaptive speed - faster for larger differences
-        float adaptiveSpeed = ANIMATION_SPEED;
+    Network& network = Network::getInstance();
+    network.initialize();
+    profiler.mark("wifi started");
 
-        // Scale speed based on distance (faster for big jumps)
-        float distance = abs(difference);
-        if (distance > 20) {
-            adaptiveSpeed *= 2.0f;  // Double speed for large changes
-        } else if (distance > 10) {
-            adaptiveSpeed *= 1.5f;  // 1.5x speed for medium changes
-        }
+    // Blocks until associated or timed out; auto-reconnect takes over after that
+    bool connected = network.connect();
+    profiler.mark(connected ? "wifi connected" : "wifi connect failed");
 
-        // Calculate movement direction and amount
-        float direction = (difference > 0) ? 1.0f : -1.0f;
-        float movement = min(adaptiveSpeed, abs(difference)) * direction;
+    // The live state endpoints only start listening once WiFi is connected
+    StatePushServer::getInstance().initialize();
+    MqttPublisher::getInstance().initialize();
+    ApiServer::getInstance().initialize();
 
-        // Move toward target
-        currentProgressValue += movement;
+    xEventGroupSetBits(bootEvents, BOOT_NETWORK_READY);
 
-        // Snap to target if very close (prevents endless tiny movements)
-        if (abs(targetProgressValue - currentProgressValue) < 0.5f) {
-            currentProgressValue = targetProgressValue;
-        }
+    // Network and the endpoints belong to this task from here on; the network job paces it
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        serviceNetwork();
 
-        // Flag for display update
-        needsDisplayUpdate = true;
+        networkBusy = false;
+        PowerManager::getInstance().releaseAwake();
+    }
+}
 
-        // Reduced debug output (only for significant changes)
-        if (abs(movement) > 1.0f) {
-            Serial.printf("Animating: %.1f%% -> %d%% (speed: %.1f)\n",
-                          currentProgressValue, targetProgressValue, adaptiveSpeed);
+void serviceNetwork() {
+    Network& network = Network::getInstance();
+    network.update();
+    const NetworkTelemetry& telemetry = network.getTelemetry();
+    PerfCounters::getInstance().recordNetwork(network.getReconnectAttempts(), telemetry.getFailedAttempts(),
+                                              telemetry.getConnectAttempts().size());
+
+    // Channel targets come from the published snapshot, so the Mixer stays with the control task
+    static Mixer::Snapshot state;
+    static uint32_t stateVersion = 0;
+    static uint8_t sentTarget[Mixer::MAX_CHANNELS];
+    static uint8_t sentCount = 0;
+
+    Mixer& mixer = Mixer::getInstance();
+    uint32_t version = mixer.getSnapshotVersion();
+    if (version != stateVersion && mixer.readSnapshot(state)) {
+        stateVersion = version;
+        for (uint8_t channel = 0; channel < state.channelCount; channel++) {
+            if (channel < sentCount && state.target[channel] == sentTarget[channel]) continue;
+
+            int level = state.target[channel];
+            StatePushServer::getInstance().setChannelValue(channel, level, state.changedAt[channel]);
+            MqttPublisher::getInstance().setChannelValue(channel, level);
+            ApiServer::getInstance().setChannelValue(channel, level);
+            sentTarget[channel] = state.target[channel];
         }
+        sentCount = state.channelCount;
+    }
+
+    StatePushServer::getInstance().update();
+    MqttPublisher::getInstance().update();
+    ApiServer::getInstance().update();
+}
+
+void reportBoot() {
+    BootProfiler& profiler = BootProfiler::getInstance();
+    profiler.mark("boot complete");
+    profiler.report();
+
+    LOG_INFO("Boot: time to first input %u us, time to first frame %u us",
+             profiler.getMarkTime("first input accepted"), profiler.getMarkTime("first frame"));
+
+    PowerManager::getInstance().setEnabled(true);
+}
+
+bool bootReached(EventBits_t bits) {
+    return (xEventGroupGetBits(bootEvents) & bits) == bits;
+}
+
+void publishChanges() {
+    Mixer& mixer = Mixer::getInstance();
+
+    // UI consumer (renders on the other core from the published snapshot)
+    if (mixer.takeDirty(Mixer::CONSUMER_UI) != 0) {
+        mixer.publish();
+    }
+
+    // Serial consumer (sent as one batched frame by the serial job)
+    SerialLink::getInstance().markDirty(mixer.takeDirty(Mixer::CONSUMER_SERIAL));
+
+    // Network endpoints read the published snapshot on the network task (see serviceNetwork)
+
+    // LED consumer (pushed at once if the RMT channel is free, otherwise by the next IO pass)
+    uint32_t dirty = mixer.takeDirty(Mixer::CONSUMER_LEDS);
+    if (progressRing && (dirty & (1UL << progressChannel))) {
+        progressRing->setLevel(mixer.getCurrent(progressChannel), mixer.isMuted(progressChannel));
+        progressRing->update();
     }
 }
 
+void updateAnimation(unsigned long elapsedMs) {
+    // Advance all animating channels by the real elapsed time (marks them dirty for the UI)
+    Mixer::getInstance().animate(elapsedMs);
+}
+
 void updateDisplay() {
-    // Update the e-paper display progress bar
+    // Runs on the UI task; everything it knows about the mixer comes from the snapshot
     UI& ui = UI::getInstance();
+    Mixer& mixer = Mixer::getInstance();
+
+    static Mixer::Snapshot state;
+    static uint32_t stateVersion = 0;
+    static unsigned long lastPerfRefresh = 0;
 
     // Use partial update for fast refresh (if supported)
     // Force full update every 30 updates to prevent ghosting (increased frequency)
     static int updateCount = 0;
-    static int lastDisplayedValue = -1;
-    updateCount++;
 
-    // Convert float to int for display
-    int displayValue = (int)round(currentProgressValue);
+    // A read that keeps colliding with publishes keeps the last good copy and retries next frame
+    uint32_t version = mixer.getSnapshotVersion();
+    if (version != stateVersion && mixer.readSnapshot(state)) {
+        stateVersion = version;
+    }
+    int displayValue = state.current[progressChannel];
+
+    // Hold off light sleep while SPI and the panel are busy
+    PowerManager& power = PowerManager::getInstance();
+    power.holdAwake();
+
+    // Screen switch requested by the host over serial
+    int screen = SerialLink::getInstance().takeScreenRequest();
+    if (screen >= 0) {
+        ui.setProgressValue(displayValue);
+        ui.setCurrentScreen(screen);
+    }
 
-    // Only update if value actually changed (reduces unnecessary updates)
-    if (displayValue != lastDisplayedValue) {
+    if (ui.getCurrentScreen() == PERFORMANCE_SCREEN) {
+        if (millis() - lastPerfRefresh >= PERF_REFRESH_INTERVAL) {
+            lastPerfRefresh = millis();
+            ui.updatePerformanceScreen();
+        }
+    } else if (ui.getCurrentScreen() == PROGRESS_SCREEN && displayValue != ui.getProgressValue()) {
+        // Only update if value actually changed (reduces unnecessary updates)
+        updateCount++;
         bool forceFullUpdate = (updateCount % 30 == 0);
         ui.updateProgressBar(displayValue, forceFullUpdate);
-        lastDisplayedValue = displayValue;
 
         // Reduced debug output
-        Serial.printf("Display: %d%%\n", displayValue);
+        LOG_DEBUG("Display: %d%%", displayValue);
     }
-}
\ No newline at end of file
+
+    power.releaseAwake();
+}
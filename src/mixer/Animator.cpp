@@ -0,0 +1,125 @@
+#include "Animator.hpp"
+#include <math.h>
+
+Animator::Animator() : omega(0), activeMask(0) {
+    for (uint8_t i = 0; i < MAX_CHANNELS; i++) {
+        value[i] = 0;
+        target[i] = 0;
+        velocity[i] = 0;
+    }
+    buildDecayTable();
+}
+
+Animator::Animator(const Config& config) : Animator() {
+    setConfig(config);
+}
+
+// Configuration
+void Animator::setConfig(const Config& config) {
+    this->config = config;
+    if (this->config.timeConstantMs == 0) {
+        this->config.timeConstantMs = 1;
+    }
+    buildDecayTable();
+}
+
+const Animator::Config& Animator::getConfig() const {
+    return config;
+}
+
+// Per-channel control
+void Animator::setTarget(uint8_t channel, q16_t newTarget) {
+    if (channel >= MAX_CHANNELS) return;
+
+    target[channel] = newTarget;
+    if (value[channel] != newTarget || velocity[channel] != 0) {
+        activeMask |= 1UL << channel;
+    }
+}
+
+void Animator::jumpTo(uint8_t channel, q16_t newValue) {
+    if (channel >= MAX_CHANNELS) return;
+
+    value[channel] = newValue;
+    target[channel] = newValue;
+    velocity[channel] = 0;
+    activeMask &= ~(1UL << channel);
+}
+
+Animator::q16_t Animator::getValue(uint8_t channel) const {
+    return channel < MAX_CHANNELS ? value[channel] : 0;
+}
+
+Animator::q16_t Animator::getTarget(uint8_t channel) const {
+    return channel < MAX_CHANNELS ? target[channel] : 0;
+}
+
+bool Animator::isAnimating(uint8_t channel) const {
+    return channel < MAX_CHANNELS && (activeMask & (1UL << channel));
+}
+
+uint32_t Animator::update(uint32_t elapsedMs) {
+    if (activeMask == 0 || elapsedMs == 0) return 0;
+
+    uint32_t moved = activeMask;
+    uint32_t pending = activeMask;
+    while (pending) {
+        uint8_t channel = __builtin_ctz(pending);
+        pending &= pending - 1;
+
+        // Long stalls are integrated in table-sized chunks; past ~8 time constants we are done
+        uint32_t remaining = elapsedMs;
+        if (remaining > 8UL * config.timeConstantMs) {
+            jumpTo(channel, target[channel]);
+            continue;
+        }
+        while (remaining > 0 && (activeMask & (1UL << channel))) {
+            uint32_t dt = remaining < DECAY_TABLE_SIZE ? remaining : DECAY_TABLE_SIZE - 1;
+            step(channel, dt);
+            remaining -= dt;
+        }
+    }
+    return moved;
+}
+
+uint32_t Animator::getActiveMask() const {
+    return activeMask;
+}
+
+// Private methods
+
+void Animator::buildDecayTable() {
+    // Only done on configuration changes, never per frame
+    for (uint8_t t = 0; t < DECAY_TABLE_SIZE; t++) {
+        decayTable[t] = (q16_t)lroundf(expf(-(float)t / config.timeConstantMs) * ONE);
+    }
+    omega = (q16_t)(ONE / config.timeConstantMs);
+}
+
+void Animator::step(uint8_t channel, uint32_t dt) {
+    int64_t e = decayTable[dt];
+    int64_t offset = (int64_t)value[channel] - target[channel];
+
+    if (config.mode == Mode::EXPONENTIAL) {
+        // x(t) = target + (x0 - target) * e^(-t/tau)
+        offset = (offset * e) >> 16;
+        velocity[channel] = 0;
+    } else {
+        // Critically damped spring:
+        //   x(t) = target + (c1 + c2 t) e^(-wt),  c1 = x0 - target,  c2 = v0 + w c1
+        //   v(t) = (c2 - w (c1 + c2 t)) e^(-wt)
+        int64_t c2 = velocity[channel] + ((omega * offset) >> 16);
+        int64_t sum = offset + c2 * dt;
+        offset = (sum * e) >> 16;
+        velocity[channel] = (q16_t)(((c2 - ((omega * sum) >> 16)) * e) >> 16);
+    }
+
+    value[channel] = (q16_t)(target[channel] + offset);
+
+    // Snap once close enough and (for springs) nearly at rest
+    q16_t distance = offset < 0 ? -offset : offset;
+    q16_t speed = velocity[channel] < 0 ? -velocity[channel] : velocity[channel];
+    if (distance <= config.snapThreshold && speed <= config.snapThreshold) {
+        jumpTo(channel, target[channel]);
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Batched Q16.16 fixed-point animation engine.
+//
+// Each channel moves its value toward a target either by exponential easing or
+// by a critically damped spring. Both are solved in closed form for the real
+// elapsed time, so a late update covers more distance instead of slowing the
+// animation down. Only channels still in motion are visited by update(), so a
+// finished animation costs nothing.
+class Animator {
+   public:
+    typedef int32_t q16_t;
+
+    static const uint8_t MAX_CHANNELS = 16;
+    static const q16_t ONE = 1L << 16;
+
+    enum class Mode {
+        EXPONENTIAL,  // Velocity jumps, no overshoot, simplest
+        SPRING        // Critically damped, velocity carries over when the target moves
+    };
+
+    struct Config {
+        Mode mode;
+        uint16_t timeConstantMs;  // Time to cover ~63% of the remaining distance
+        q16_t snapThreshold;      // Distance at which the value snaps to the target
+
+        Config() : mode(Mode::SPRING), timeConstantMs(20), snapThreshold(ONE / 64) {}
+    };
+
+    Animator();
+    explicit Animator(const Config& config);
+
+    // Configuration
+    void setConfig(const Config& config);
+    const Config& getConfig() const;
+
+    // Per-channel control
+    void setTarget(uint8_t channel, q16_t target);
+    void jumpTo(uint8_t channel, q16_t value);
+    q16_t getValue(uint8_t channel) const;
+    q16_t getTarget(uint8_t channel) const;
+    bool isAnimating(uint8_t channel) const;
+
+    // Advance every animating channel by the elapsed time; returns the mask of channels that moved
+    uint32_t update(uint32_t elapsedMs);
+    uint32_t getActiveMask() const;
+
+    // Q16 helpers
+    static q16_t fromInt(int value) { return (q16_t)value << 16; }
+    static int toInt(q16_t value) { return (int)((value + (ONE / 2)) >> 16); }
+
+   private:
+    // exp(-t / timeConstant) for t = 0..DECAY_TABLE_SIZE-1 ms, in Q16
+    static const uint8_t DECAY_TABLE_SIZE = 64;
+
+    Config config;
+    q16_t omega;  // 1 / timeConstant, Q16 per ms
+    q16_t decayTable[DECAY_TABLE_SIZE];
+
+    // Channel state, structure-of-arrays
+    q16_t value[MAX_CHANNELS];
+    q16_t target[MAX_CHANNELS];
+    q16_t velocity[MAX_CHANNELS];  // Q16 units per ms, spring mode only
+    uint32_t activeMask;
+
+    void buildDecayTable();
+    void step(uint8_t channel, uint32_t dt);
+};
@@ -0,0 +1,236 @@
+#include "Mixer.hpp"
+
+// Initialize static member
+Mixer* Mixer::instance = nullptr;
+
+// Private constructor
+Mixer::Mixer() : channelCount(0), muteMask(0) {
+    for (uint8_t i = 0; i < MAX_CHANNELS; i++) {
+        targetLevel[i] = 0;
+        boundEncoder[i] = nullptr;
+        encoderHandle[i] = -1;
+        changedAt[i] = 0;
+    }
+    for (uint8_t i = 0; i < CONSUMER_COUNT; i++) {
+        dirtyMask[i] = 0;
+    }
+}
+
+// Destructor
+Mixer::~Mixer() {
+    for (uint8_t i = 0; i < channelCount; i++) {
+        unbindEncoder(i);
+    }
+}
+
+// Get singleton instance
+Mixer& Mixer::getInstance() {
+    if (instance == nullptr) {
+        instance = new Mixer();
+    }
+    return *instance;
+}
+
+// Check if instance exists
+bool Mixer::hasInstance() {
+    return instance != nullptr;
+}
+
+// Destroy the singleton instance
+void Mixer::destroyInstance() {
+    if (instance != nullptr) {
+        delete instance;
+        instance = nullptr;
+    }
+}
+
+// Channel management
+int Mixer::addChannel(int initialLevel) {
+    if (channelCount >= MAX_CHANNELS) return -1;
+
+    uint8_t channel = channelCount++;
+    targetLevel[channel] = clampLevel(initialLevel);
+    animator.jumpTo(channel, Animator::fromInt(targetLevel[channel]));
+    boundEncoder[channel] = nullptr;
+    muteMask &= ~(1UL << channel);
+
+    noteChange(channel);
+    return channel;
+}
+
+uint8_t Mixer::getChannelCount() const {
+    return channelCount;
+}
+
+bool Mixer::isValidChannel(uint8_t channel) const {
+    return channel < channelCount;
+}
+
+// Encoder binding
+bool Mixer::bindEncoder(uint8_t channel, RotaryEncoder* encoder) {
+    if (!isValidChannel(channel) || !encoder) return false;
+
+    unbindEncoder(channel);
+    // Subscribe alongside other listeners rather than replacing them
+    int handle = encoder->addEncoderCallback([this, channel](int delta) {
+        adjustTarget(channel, delta);
+    });
+    if (handle < 0) return false;
+
+    boundEncoder[channel] = encoder;
+    encoderHandle[channel] = (int8_t)handle;
+    return true;
+}
+
+void Mixer::unbindEncoder(uint8_t channel) {
+    if (!isValidChannel(channel) || !boundEncoder[channel]) return;
+
+    boundEncoder[channel]->removeEncoderCallback(encoderHandle[channel]);
+    boundEncoder[channel] = nullptr;
+    encoderHandle[channel] = -1;
+}
+
+RotaryEncoder* Mixer::getBoundEncoder(uint8_t channel) const {
+    return isValidChannel(channel) ? boundEncoder[channel] : nullptr;
+}
+
+// Target level
+void Mixer::setTarget(uint8_t channel, int level) {
+    if (!isValidChannel(channel)) return;
+
+    int16_t clamped = clampLevel(level);
+    if (targetLevel[channel] != clamped) {
+        targetLevel[channel] = clamped;
+        animator.setTarget(channel, Animator::fromInt(clamped));
+        noteChange(channel);
+    }
+}
+
+void Mixer::adjustTarget(uint8_t channel, int delta) {
+    if (!isValidChannel(channel)) return;
+    setTarget(channel, targetLevel[channel] + delta);
+}
+
+int Mixer::getTarget(uint8_t channel) const {
+    return isValidChannel(channel) ? targetLevel[channel] : 0;
+}
+
+void Mixer::jumpTo(uint8_t channel, int level) {
+    if (!isValidChannel(channel)) return;
+
+    targetLevel[channel] = clampLevel(level);
+    animator.jumpTo(channel, Animator::fromInt(targetLevel[channel]));
+    noteChange(channel);
+}
+
+// Current level
+int Mixer::getCurrent(uint8_t channel) const {
+    return isValidChannel(channel) ? Animator::toInt(animator.getValue(channel)) : 0;
+}
+
+Animator::q16_t Mixer::getCurrentQ16(uint8_t channel) const {
+    return isValidChannel(channel) ? animator.getValue(channel) : 0;
+}
+
+// Animation
+uint32_t Mixer::animate(uint32_t elapsedMs) {
+    uint32_t moved = animator.update(elapsedMs);
+    dirtyMask[CONSUMER_UI] |= moved;
+    dirtyMask[CONSUMER_LEDS] |= moved;
+    return moved;
+}
+
+bool Mixer::isAnimating() const {
+    return animator.getActiveMask() != 0;
+}
+
+void Mixer::setAnimationConfig(const Animator::Config& config) {
+    animator.setConfig(config);
+}
+
+const Animator::Config& Mixer::getAnimationConfig() const {
+    return animator.getConfig();
+}
+
+// Mute
+void Mixer::setMuted(uint8_t channel, bool muted) {
+    if (!isValidChannel(channel)) return;
+
+    uint32_t bit = 1UL << channel;
+    if (((muteMask & bit) != 0) != muted) {
+        muteMask ^= bit;
+        noteChange(channel);
+    }
+}
+
+void Mixer::toggleMute(uint8_t channel) {
+    setMuted(channel, !isMuted(channel));
+}
+
+bool Mixer::isMuted(uint8_t channel) const {
+    return isValidChannel(channel) && (muteMask & (1UL << channel));
+}
+
+uint32_t Mixer::getMuteMask() const {
+    return muteMask;
+}
+
+// Dirty tracking
+uint32_t Mixer::takeDirty(Consumer consumer) {
+    uint32_t mask = dirtyMask[consumer];
+    dirtyMask[consumer] = 0;
+    return mask;
+}
+
+uint32_t Mixer::peekDirty(Consumer consumer) const {
+    return dirtyMask[consumer];
+}
+
+void Mixer::markAllDirty() {
+    for (uint8_t i = 0; i < channelCount; i++) {
+        markDirty(i);
+    }
+}
+
+// Cross-core state
+void Mixer::publish() {
+    Snapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.channelCount = channelCount;
+    snapshot.muteMask = muteMask;
+    for (uint8_t i = 0; i < channelCount; i++) {
+        snapshot.target[i] = (uint8_t)targetLevel[i];
+        snapshot.current[i] = (uint8_t)getCurrent(i);
+        snapshot.changedAt[i] = changedAt[i];
+    }
+    published.write(snapshot);
+}
+
+bool Mixer::readSnapshot(Snapshot& snapshot) const {
+    return published.read(snapshot);
+}
+
+uint32_t Mixer::getSnapshotVersion() const {
+    return published.getVersion();
+}
+
+// Private methods
+void Mixer::markDirty(uint8_t channel) {
+    uint32_t bit = 1UL << channel;
+    for (uint8_t i = 0; i < CONSUMER_COUNT; i++) {
+        dirtyMask[i] |= bit;
+    }
+}
+
+// A target or mute change, usually straight from an input callback; the time lets
+// consumers measure how long the change took to reach them
+void Mixer::noteChange(uint8_t channel) {
+    changedAt[channel] = micros();
+    markDirty(channel);
+}
+
+int Mixer::clampLevel(int level) {
+    if (level < LEVEL_MIN) return LEVEL_MIN;
+    if (level > LEVEL_MAX) return LEVEL_MAX;
+    return level;
+}
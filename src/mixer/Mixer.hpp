@@ -0,0 +1,125 @@
+#pragma once
+
+#include <Arduino.h>
+#include "../core/Seqlock.hpp"
+#include "../io/RotaryEncoder.hpp"
+#include "Animator.hpp"
+
+// Fixed-capacity channel table for the mixer, stored structure-of-arrays so
+// consumers that only care about one field walk a single contiguous array.
+//
+// Every change sets a per-consumer dirty bit for its channel. Consumers call
+// takeDirty() to fetch and clear their own bits and only look at those
+// channels. Target and mute changes are reported to every consumer. Animated
+// level changes are reported to the UI and LED consumers only.
+//
+// The Mixer itself belongs to the control task on core 0. Tasks on other
+// cores read a Snapshot, which the owner publishes with publish().
+class Mixer {
+   private:
+    // Private constructor to prevent direct instantiation
+    Mixer();
+
+    // Static instance pointer
+    static Mixer* instance;
+
+    // Delete copy constructor and assignment operator
+    Mixer(const Mixer&) = delete;
+    Mixer& operator=(const Mixer&) = delete;
+
+   public:
+    static const uint8_t MAX_CHANNELS = 16;
+    static const int LEVEL_MIN = 0;
+    static const int LEVEL_MAX = 100;
+
+    // Copy of the channel table that other cores may read
+    struct Snapshot {
+        uint8_t channelCount;
+        uint32_t muteMask;
+        uint8_t target[MAX_CHANNELS];
+        uint8_t current[MAX_CHANNELS];
+        uint32_t changedAt[MAX_CHANNELS];  // micros() of the latest target or mute change
+    };
+
+    enum Consumer : uint8_t {
+        CONSUMER_UI,
+        CONSUMER_SERIAL,
+        CONSUMER_STORAGE,
+        CONSUMER_LEDS,
+        CONSUMER_COUNT
+    };
+
+    // Public destructor
+    ~Mixer();
+
+    // Static method to get the singleton instance
+    static Mixer& getInstance();
+
+    // Static method to check if instance exists
+    static bool hasInstance();
+
+    // Static method to destroy the instance
+    static void destroyInstance();
+
+    // Channel management
+    int addChannel(int initialLevel = LEVEL_MAX / 2);  // Returns the channel index, -1 when full
+    uint8_t getChannelCount() const;
+    bool isValidChannel(uint8_t channel) const;
+
+    // Encoder binding (rotation adjusts the channel target)
+    bool bindEncoder(uint8_t channel, RotaryEncoder* encoder);
+    void unbindEncoder(uint8_t channel);
+    RotaryEncoder* getBoundEncoder(uint8_t channel) const;
+
+    // Target level (what the user asked for)
+    void setTarget(uint8_t channel, int level);
+    void adjustTarget(uint8_t channel, int delta);
+    int getTarget(uint8_t channel) const;
+    void jumpTo(uint8_t channel, int level);  // Set target and current at once, without animating
+
+    // Current level (what is shown, driven toward target by the animation)
+    int getCurrent(uint8_t channel) const;
+    Animator::q16_t getCurrentQ16(uint8_t channel) const;
+
+    // Animation (advance by real elapsed time; returns the mask of channels that moved)
+    uint32_t animate(uint32_t elapsedMs);
+    bool isAnimating() const;
+    void setAnimationConfig(const Animator::Config& config);
+    const Animator::Config& getAnimationConfig() const;
+
+    // Mute
+    void setMuted(uint8_t channel, bool muted);
+    void toggleMute(uint8_t channel);
+    bool isMuted(uint8_t channel) const;
+    uint32_t getMuteMask() const;
+
+    // Dirty tracking
+    uint32_t takeDirty(Consumer consumer);
+    uint32_t peekDirty(Consumer consumer) const;
+    void markAllDirty();
+
+    // Cross-core state (publish from the owning task, read from any task)
+    void publish();
+    bool readSnapshot(Snapshot& snapshot) const;  // False if a publish kept interrupting; snapshot left as it was
+    uint32_t getSnapshotVersion() const;
+
+   private:
+    uint8_t channelCount;
+
+    // Channel table
+    int16_t targetLevel[MAX_CHANNELS];
+    Animator animator;  // Owns the animated current level per channel
+    RotaryEncoder* boundEncoder[MAX_CHANNELS];
+    int8_t encoderHandle[MAX_CHANNELS];  // Our subscription on the bound encoder
+    uint32_t muteMask;
+    uint32_t changedAt[MAX_CHANNELS];
+
+    // One dirty bitmask per consumer, bit n = channel n
+    uint32_t dirtyMask[CONSUMER_COUNT];
+
+    Seqlock<Snapshot> published;
+
+    void markDirty(uint8_t channel);
+    void noteChange(uint8_t channel);
+    static int clampLevel(int level);
+};
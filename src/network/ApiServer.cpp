@@ -0,0 +1,286 @@
+#include "ApiServer.hpp"
+#include "Network.hpp"
+#include "../core/Log.hpp"
+#include <stdarg.h>
+
+// Initialize static instance pointer
+ApiServer* ApiServer::instance = nullptr;
+
+namespace {
+
+const char* deviceTypeToString(InputDevice::DeviceType type) {
+    switch (type) {
+        case InputDevice::DeviceType::ENCODER:
+            return "encoder";
+        case InputDevice::DeviceType::BUTTON:
+            return "button";
+        case InputDevice::DeviceType::JOYSTICK:
+            return "joystick";
+        case InputDevice::DeviceType::POTENTIOMETER:
+            return "potentiometer";
+        case InputDevice::DeviceType::KEYPAD:
+            return "keypad";
+        case InputDevice::DeviceType::CUSTOM:
+        default:
+            return "custom";
+    }
+}
+
+// Bounded append into a response buffer; on overflow nothing is appended and false is returned
+bool appendf(char* buffer, size_t capacity, size_t& length, const char* format, ...) {
+    if (length >= capacity) return false;
+
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(buffer + length, capacity - length, format, args);
+    va_end(args);
+
+    if (written < 0 || (size_t)written >= capacity - length) {
+        buffer[length] = '\0';
+        return false;
+    }
+    length += written;
+    return true;
+}
+
+}  // namespace
+
+// Private constructor
+ApiServer::ApiServer() : server(nullptr),
+                         initialized(false),
+                         listening(false),
+                         port(DEFAULT_PORT),
+                         channelCount(0),
+                         stateResponse{stateBody, sizeof(stateBody), 0, true},
+                         devicesResponse{devicesBody, sizeof(devicesBody), 0, true},
+                         networkResponse{networkBody, sizeof(networkBody), 0, true},
+                         lastDeviceListVersion(0),
+                         lastNetworkStatus(-1),
+                         lastNetworkRefresh(0),
+                         networkRefreshInterval(DEFAULT_NETWORK_REFRESH_INTERVAL),
+                         requestCount(0),
+                         serializeCount(0),
+                         totalServeTime(0) {
+    for (uint8_t i = 0; i < MAX_CHANNELS; i++) {
+        channelValues[i] = 0;
+    }
+}
+
+// Destructor
+ApiServer::~ApiServer() {
+    shutdown();
+}
+
+// Static method to get the singleton instance
+ApiServer& ApiServer::getInstance() {
+    if (instance == nullptr) {
+        instance = new ApiServer();
+    }
+    return *instance;
+}
+
+// Static method to check if instance exists
+bool ApiServer::hasInstance() {
+    return instance != nullptr;
+}
+
+// Static method to destroy the instance
+void ApiServer::destroyInstance() {
+    if (instance != nullptr) {
+        delete instance;
+        instance = nullptr;
+    }
+}
+
+// Initialize the server (listening starts once the network is connected)
+void ApiServer::initialize() {
+    if (initialized) return;
+
+    server = new WebServer(port);
+    server->on("/api/state", HTTP_GET, [this]() { serve(stateResponse); });
+    server->on("/api/devices", HTTP_GET, [this]() { serve(devicesResponse); });
+    server->on("/api/network", HTTP_GET, [this]() { serve(networkResponse); });
+    server->onNotFound([this]() { server->send(404, "text/plain", "Not found"); });
+    initialized = true;
+
+    LOG_INFO("HTTP: Initialized");
+}
+
+// Shutdown the server
+void ApiServer::shutdown() {
+    if (!initialized) return;
+
+    if (listening) {
+        server->stop();
+        listening = false;
+    }
+    delete server;
+    server = nullptr;
+    initialized = false;
+
+    LOG_INFO("HTTP: Shutdown complete");
+}
+
+// Refresh stale bodies and answer pending requests - call this regularly in main loop
+void ApiServer::update() {
+    if (!initialized) return;
+
+    if (!listening) {
+        if (!Network::hasInstance() || !Network::getInstance().isConnected()) return;
+        startListening();
+    }
+
+    refreshCache();
+    server->handleClient();
+}
+
+// Store a channel value; the state body is re-serialized on the next update
+void ApiServer::setChannelValue(uint8_t channel, int value) {
+    if (channel >= MAX_CHANNELS) return;
+
+    if (channel >= channelCount) {
+        channelCount = channel + 1;
+    } else if (channelValues[channel] == value) {
+        return;
+    }
+
+    channelValues[channel] = value;
+    stateResponse.stale = true;
+}
+
+// Set the listening port (takes effect on the next initialize)
+void ApiServer::setPort(uint16_t port) {
+    this->port = port;
+}
+
+// Set how often the network body is refreshed while the link status is unchanged
+void ApiServer::setNetworkRefreshInterval(unsigned long intervalMs) {
+    networkRefreshInterval = intervalMs;
+}
+
+unsigned long ApiServer::getRequestCount() const {
+    return requestCount;
+}
+
+unsigned long ApiServer::getSerializeCount() const {
+    return serializeCount;
+}
+
+unsigned long ApiServer::getAverageServeTime() const {
+    return requestCount ? totalServeTime / requestCount : 0;
+}
+
+void ApiServer::resetStats() {
+    requestCount = 0;
+    serializeCount = 0;
+    totalServeTime = 0;
+}
+
+// Private methods
+
+void ApiServer::startListening() {
+    server->begin();
+    listening = true;
+
+    LOG_INFO("HTTP: Listening on port %u", port);
+}
+
+void ApiServer::refreshCache() {
+    if (IO::hasInstance()) {
+        uint32_t version = IO::getInstance().getDeviceListVersion();
+        if (version != lastDeviceListVersion) {
+            lastDeviceListVersion = version;
+            devicesResponse.stale = true;
+        }
+    }
+
+    if (Network::hasInstance()) {
+        Network& network = Network::getInstance();
+        unsigned long currentTime = millis();
+        if ((int)network.getStatus() != lastNetworkStatus ||
+            (currentTime - lastNetworkRefresh) >= networkRefreshInterval) {
+            lastNetworkStatus = (int)network.getStatus();
+            lastNetworkRefresh = currentTime;
+            networkResponse.stale = true;
+        }
+    }
+
+    if (stateResponse.stale) serializeState();
+    if (devicesResponse.stale) serializeDevices();
+    if (networkResponse.stale) serializeNetwork();
+}
+
+// {"channels":[v0,v1,...]}
+void ApiServer::serializeState() {
+    size_t length = 0;
+    appendf(stateBody, sizeof(stateBody), length, "{\"channels\":[");
+    for (uint8_t i = 0; i < channelCount; i++) {
+        appendf(stateBody, sizeof(stateBody), length, i ? ",%d" : "%d", channelValues[i]);
+    }
+    appendf(stateBody, sizeof(stateBody), length, "]}");
+
+    stateResponse.length = length;
+    stateResponse.stale = false;
+    serializeCount++;
+}
+
+// {"devices":[{"id":"...","type":"...","initialized":true},...]}
+// Runs on the network task, so it works from IO's published copy and never touches a device
+void ApiServer::serializeDevices() {
+    deviceList.count = 0;
+    if (IO::hasInstance() && !IO::getInstance().readDeviceList(deviceList)) {
+        return;  // Control task kept republishing; stays stale and is retried next update
+    }
+
+    size_t length = 0;
+    appendf(devicesBody, sizeof(devicesBody), length, "{\"devices\":[");
+    for (uint8_t i = 0; i < deviceList.count; i++) {
+        const IO::DeviceInfo& device = deviceList.devices[i];
+        // Keep room for the closing brackets so a long list is truncated, not broken
+        if (!appendf(devicesBody, sizeof(devicesBody) - 2, length,
+                     "%s{\"id\":\"%s\",\"type\":\"%s\",\"initialized\":%s}",
+                     i ? "," : "", device.id, deviceTypeToString(device.type),
+                     device.initialized ? "true" : "false")) {
+            break;
+        }
+    }
+    appendf(devicesBody, sizeof(devicesBody), length, "]}");
+
+    devicesResponse.length = length;
+    devicesResponse.stale = false;
+    serializeCount++;
+}
+
+// {"status":"...","ssid":"...","ip":"...","rssi":-60,"mac":"...","reconnects":0}
+void ApiServer::serializeNetwork() {
+    size_t length = 0;
+    if (!Network::hasInstance()) {
+        appendf(networkBody, sizeof(networkBody), length, "{\"status\":\"%s\"}",
+                Network::statusToString(NetworkStatus::DISCONNECTED));
+    } else {
+        Network& network = Network::getInstance();
+        char ssid[33];
+        char ip[16];
+        char mac[18];
+        network.getSSID(ssid, sizeof(ssid));
+        network.getLocalIP(ip, sizeof(ip));
+        network.getMACAddress(mac, sizeof(mac));
+
+        appendf(networkBody, sizeof(networkBody), length,
+                "{\"status\":\"%s\",\"ssid\":\"%s\",\"ip\":\"%s\",\"rssi\":%d,\"mac\":\"%s\",\"reconnects\":%d}",
+                network.getStatusString(), ssid, ip, network.getRSSI(), mac, network.getReconnectAttempts());
+    }
+
+    networkResponse.length = length;
+    networkResponse.stale = false;
+    serializeCount++;
+}
+
+void ApiServer::serve(const CachedResponse& response) {
+    unsigned long startTime = micros();
+
+    server->send_P(200, "application/json", response.body, response.length);
+
+    totalServeTime += micros() - startTime;
+    requestCount++;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <Arduino.h>
+#include <WebServer.h>
+#include "../io/IO.hpp"
+
+// Small read-only HTTP API:
+//   GET /api/state    - mixer channel values
+//   GET /api/devices  - input devices registered with IO
+//   GET /api/network  - WiFi link information
+// Each response body lives in a preallocated buffer that is re-serialized in
+// update() only after its source changed, so serving a request is a plain copy.
+class ApiServer {
+   private:
+    // Private constructor to prevent direct instantiation
+    ApiServer();
+
+    // Static instance pointer
+    static ApiServer* instance;
+
+    // Delete copy constructor and assignment operator
+    ApiServer(const ApiServer&) = delete;
+    ApiServer& operator=(const ApiServer&) = delete;
+
+   public:
+    static const uint8_t MAX_CHANNELS = 16;
+
+    // Public destructor
+    ~ApiServer();
+
+    // Static method to get the singleton instance
+    static ApiServer& getInstance();
+
+    // Static method to check if instance exists
+    static bool hasInstance();
+
+    // Static method to destroy the instance
+    static void destroyInstance();
+
+    // Server lifecycle methods
+    void initialize();
+    void shutdown();
+    void update();
+
+    // Channel state (call from input handlers, only marks the cached body stale)
+    void setChannelValue(uint8_t channel, int value);
+
+    // Configuration
+    void setPort(uint16_t port);
+    void setNetworkRefreshInterval(unsigned long intervalMs);
+
+    // Stats
+    unsigned long getRequestCount() const;
+    unsigned long getSerializeCount() const;
+    unsigned long getAverageServeTime() const;  // microseconds per request
+    void resetStats();
+
+   private:
+    struct CachedResponse {
+        char* body;
+        size_t capacity;
+        size_t length;
+        bool stale;
+    };
+
+    WebServer* server;
+
+    bool initialized;
+    bool listening;
+    uint16_t port;
+
+    // Mixer state
+    int channelValues[MAX_CHANNELS];
+    uint8_t channelCount;
+
+    // Cached response bodies
+    char stateBody[32 + MAX_CHANNELS * 12];
+    char devicesBody[1024];
+    char networkBody[256];
+    CachedResponse stateResponse;
+    CachedResponse devicesResponse;
+    CachedResponse networkResponse;
+
+    // Change tracking for sources owned by other modules
+    uint32_t lastDeviceListVersion;
+    IO::DeviceList deviceList;  // Copy of IO's published table, too big for the task stack
+    int lastNetworkStatus;
+    unsigned long lastNetworkRefresh;
+    unsigned long networkRefreshInterval;
+
+    // Stats
+    unsigned long requestCount;
+    unsigned long serializeCount;
+    unsigned long totalServeTime;
+
+    // Internal methods
+    void startListening();
+    void refreshCache();
+    void serializeState();
+    void serializeDevices();
+    void serializeNetwork();
+    void serve(const CachedResponse& response);
+
+    // Configuration constants
+    static const uint16_t DEFAULT_PORT = 80;
+    static const unsigned long DEFAULT_NETWORK_REFRESH_INTERVAL = 5000;  // RSSI drifts, refresh periodically
+};
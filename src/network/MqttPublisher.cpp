@@ -0,0 +1,206 @@
+#include "MqttPublisher.hpp"
+#include "Network.hpp"
+#include "../core/Log.hpp"
+
+// secret.h is optional here: without it the broker stays unset and MQTT is off
+#if __has_include("../../include/secret.h")
+#include "../../include/secret.h"
+#endif
+
+// Broker defaults, override in secret.h
+#ifndef MQTT_BROKER
+#define MQTT_BROKER ""
+#endif
+#ifndef MQTT_PORT
+#define MQTT_PORT 1883
+#endif
+
+// Initialize static instance pointer
+MqttPublisher* MqttPublisher::instance = nullptr;
+
+// Private constructor
+MqttPublisher::MqttPublisher() : mqttClient(wifiClient),
+                                 initialized(false),
+                                 publishInterval(DEFAULT_PUBLISH_INTERVAL),
+                                 reconnectInterval(DEFAULT_RECONNECT_INTERVAL),
+                                 lastPublish(0),
+                                 lastConnectAttempt(0),
+                                 brokerPort(MQTT_PORT),
+                                 publishCount(0),
+                                 failedCount(0),
+                                 lastFlushDuration(0) {
+    strlcpy(brokerHost, MQTT_BROKER, sizeof(brokerHost));
+    strlcpy(baseTopic, "unimix", sizeof(baseTopic));
+    snprintf(clientId, sizeof(clientId), "unimix-%08lx", (unsigned long)ESP.getEfuseMac());
+}
+
+// Destructor
+MqttPublisher::~MqttPublisher() {
+    shutdown();
+}
+
+// Static method to get the singleton instance
+MqttPublisher& MqttPublisher::getInstance() {
+    if (instance == nullptr) {
+        instance = new MqttPublisher();
+    }
+    return *instance;
+}
+
+// Static method to check if instance exists
+bool MqttPublisher::hasInstance() {
+    return instance != nullptr;
+}
+
+// Static method to destroy the instance
+void MqttPublisher::destroyInstance() {
+    if (instance != nullptr) {
+        delete instance;
+        instance = nullptr;
+    }
+}
+
+// Initialize the publisher (the session is opened once the network is up)
+void MqttPublisher::initialize() {
+    if (initialized) return;
+
+    mqttClient.setServer(brokerHost, brokerPort);
+    initialized = true;
+
+    LOG_INFO("MQTT: Initialized");
+}
+
+// Shutdown the publisher and close the broker session
+void MqttPublisher::shutdown() {
+    if (!initialized) return;
+
+    if (mqttClient.connected()) {
+        mqttClient.disconnect();
+    }
+    initialized = false;
+
+    LOG_INFO("MQTT: Shutdown complete");
+}
+
+// Keep the session alive and flush coalesced changes - call this regularly in main loop
+void MqttPublisher::update() {
+    if (!initialized || brokerHost[0] == '\0') return;
+
+    // Follow the WiFi link: without it changes simply stay queued
+    if (!Network::hasInstance() || !Network::getInstance().isConnected()) return;
+
+    unsigned long currentTime = millis();
+
+    if (!mqttClient.connected()) {
+        if (currentTime - lastConnectAttempt < reconnectInterval && lastConnectAttempt != 0) return;
+        lastConnectAttempt = currentTime;
+
+        if (!connectBroker()) return;
+
+        // Fresh session: publish whatever queued up while offline right away
+        flush();
+        lastPublish = currentTime;
+        return;
+    }
+
+    mqttClient.loop();
+
+    if (queue.hasPending() && (currentTime - lastPublish) >= publishInterval) {
+        flush();
+        lastPublish = currentTime;
+    }
+}
+
+// Store the latest value for a channel and queue it for publishing
+void MqttPublisher::setChannelValue(uint8_t channel, int value) {
+    queue.set(channel, value);
+}
+
+bool MqttPublisher::isConnected() {
+    return mqttClient.connected();
+}
+
+uint8_t MqttPublisher::getPendingCount() const {
+    return queue.getPendingCount();
+}
+
+// Set broker address (takes effect on the next connection attempt)
+void MqttPublisher::setBroker(const char* host, uint16_t port) {
+    strlcpy(brokerHost, host, sizeof(brokerHost));
+    brokerPort = port;
+    mqttClient.setServer(brokerHost, brokerPort);
+}
+
+void MqttPublisher::setBaseTopic(const char* topic) {
+    strlcpy(baseTopic, topic, sizeof(baseTopic));
+}
+
+void MqttPublisher::setClientId(const char* clientId) {
+    strlcpy(this->clientId, clientId, sizeof(this->clientId));
+}
+
+// Set the coalescing window between two flushes
+void MqttPublisher::setPublishInterval(unsigned long intervalMs) {
+    publishInterval = intervalMs;
+}
+
+void MqttPublisher::setReconnectInterval(unsigned long intervalMs) {
+    reconnectInterval = intervalMs;
+}
+
+unsigned long MqttPublisher::getPublishCount() const {
+    return publishCount;
+}
+
+unsigned long MqttPublisher::getCoalescedCount() const {
+    return queue.getCoalescedCount();
+}
+
+unsigned long MqttPublisher::getFailedCount() const {
+    return failedCount;
+}
+
+unsigned long MqttPublisher::getLastFlushDuration() const {
+    return lastFlushDuration;
+}
+
+void MqttPublisher::resetStats() {
+    publishCount = 0;
+    queue.resetStats();
+    failedCount = 0;
+    lastFlushDuration = 0;
+}
+
+// Private methods
+
+bool MqttPublisher::connectBroker() {
+    LOG_INFO("MQTT: Connecting to %s...", brokerHost);
+
+    if (mqttClient.connect(clientId)) {
+        LOG_INFO("MQTT: Connected");
+        return true;
+    }
+
+    LOG_WARN("MQTT: Connection failed, state %d", mqttClient.state());
+    return false;
+}
+
+// Publish every dirty channel once; failed channels stay queued for the next flush
+void MqttPublisher::flush() {
+    unsigned long startTime = micros();
+
+    queue.flush([this](uint8_t channel, int value) {
+        snprintf(topicBuffer, sizeof(topicBuffer), "%s/channel/%u", baseTopic, channel);
+        int length = snprintf(payloadBuffer, sizeof(payloadBuffer), "%d", value);
+
+        if (!mqttClient.publish(topicBuffer, (const uint8_t*)payloadBuffer, length, true)) {
+            failedCount++;
+            return false;  // Session is likely gone, retry after reconnect
+        }
+        publishCount++;
+        Network::getInstance().notePacketSent();
+        return true;
+    });
+
+    lastFlushDuration = micros() - startTime;
+}
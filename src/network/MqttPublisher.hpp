@@ -0,0 +1,102 @@
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include <PubSubClient.h>
+#include "PublishQueue.hpp"
+
+// Publishes mixer channel values as retained MQTT topics (<baseTopic>/channel/<n>).
+// Channel changes go into a PublishQueue, which only keeps the latest value per
+// channel, so a fast spin collapses into one publish per channel per publish
+// interval. While the broker is unreachable it acts as a bounded latest-value
+// queue that is flushed as soon as the session is back.
+class MqttPublisher {
+   private:
+    // Private constructor to prevent direct instantiation
+    MqttPublisher();
+
+    // Static instance pointer
+    static MqttPublisher* instance;
+
+    // Delete copy constructor and assignment operator
+    MqttPublisher(const MqttPublisher&) = delete;
+    MqttPublisher& operator=(const MqttPublisher&) = delete;
+
+   public:
+    static const uint8_t MAX_CHANNELS = PublishQueue::MAX_CHANNELS;
+
+    // Public destructor
+    ~MqttPublisher();
+
+    // Static method to get the singleton instance
+    static MqttPublisher& getInstance();
+
+    // Static method to check if instance exists
+    static bool hasInstance();
+
+    // Static method to destroy the instance
+    static void destroyInstance();
+
+    // Publisher lifecycle methods
+    void initialize();
+    void shutdown();
+    void update();
+
+    // Channel state (call from input handlers, cheap and non-blocking)
+    void setChannelValue(uint8_t channel, int value);
+
+    // Status
+    bool isConnected();
+    uint8_t getPendingCount() const;
+
+    // Configuration
+    void setBroker(const char* host, uint16_t port);
+    void setBaseTopic(const char* topic);
+    void setClientId(const char* clientId);
+    void setPublishInterval(unsigned long intervalMs);
+    void setReconnectInterval(unsigned long intervalMs);
+
+    // Stats
+    unsigned long getPublishCount() const;
+    unsigned long getCoalescedCount() const;
+    unsigned long getFailedCount() const;
+    unsigned long getLastFlushDuration() const;  // microseconds
+    void resetStats();
+
+   private:
+    WiFiClient wifiClient;
+    PubSubClient mqttClient;
+
+    bool initialized;
+    unsigned long publishInterval;
+    unsigned long reconnectInterval;
+    unsigned long lastPublish;
+    unsigned long lastConnectAttempt;
+
+    // Broker settings (fixed-size so reconfiguration never touches the heap)
+    char brokerHost[64];
+    uint16_t brokerPort;
+    char baseTopic[32];
+    char clientId[24];
+
+    // Latest value per channel plus the set still waiting to be published
+    PublishQueue queue;
+
+    // Preallocated publish buffers
+    char topicBuffer[48];
+    char payloadBuffer[12];
+
+    // Stats
+    unsigned long publishCount;
+    unsigned long failedCount;
+    unsigned long lastFlushDuration;
+
+    // Internal methods
+    bool connectBroker();
+    void flush();
+
+    // Configuration constants
+    static const uint16_t DEFAULT_PORT = 1883;
+    static const unsigned long DEFAULT_PUBLISH_INTERVAL = 100;    // Coalescing window
+    static const unsigned long DEFAULT_RECONNECT_INTERVAL = 5000;  // 5 seconds
+};
@@ -1,5 +1,9 @@
-#include "network.hpp"
+#include "Network.hpp"
 #include "../../include/secret.h"
+#include "../core/Log.hpp"
+#include "../io/IO.hpp"
+#include "../io/InputLog.hpp"
+#include <esp_wifi.h>
 
 // Initialize static instance pointer
 Network* Network::instance = nullptr;
@@ -14,6 +18,28 @@ Network::Network() : initialized(false),
                      lastReconnectAttempt(0),
                      connectionStartTime(0),
                      reconnectAttempts(0),
+                     connectedSince(0),
+                     rssiSampleInterval(DEFAULT_RSSI_SAMPLE_INTERVAL),
+                     lastRSSISample(0),
+                     reportedTelemetryVersion(UINT32_MAX),
+                     powerSaveEnabled(true),
+                     powerSaveActive(false),
+                     powerSaveIdleTimeout(DEFAULT_POWER_SAVE_IDLE),
+                     powerModeSince(0),
+                     lastSeenInputTime(0),
+                     fullPowerTime(0),
+                     powerSaveTime(0),
+                     wakeCount(0),
+                     packetPending(false),
+                     pendingFromPowerSave(false),
+                     pendingInputTime(0),
+                     awakeLatencySum(0),
+                     awakeLatencyCount(0),
+                     wakeLatencySum(0),
+                     wakeLatencyCount(0),
+                     wakeLatencyMax(0),
+                     publishedStatus(NetworkStatus::DISCONNECTED),
+                     publishedPowerSave(false),
                      wifiSSID(WIFI_SSID),
                      wifiPassword(WIFI_PASS),
                      eventCallback(nullptr) {
@@ -49,24 +75,24 @@ void Network::destroyInstance() {
 void Network::initialize() {
     if (initialized) return;
 
-    Serial.println("Network: Initializing...");
+    LOG_INFO("Network: Initializing...");
 
     setupWiFi();
     initialized = true;
 
-    Serial.println("Network: Initialized");
+    LOG_INFO("Network: Initialized");
 }
 
 // Shutdown the network system
 void Network::shutdown() {
     if (!initialized) return;
 
-    Serial.println("Network: Shutting down...");
+    LOG_INFO("Network: Shutting down...");
 
     disconnect();
     initialized = false;
 
-    Serial.println("Network: Shutdown complete");
+    LOG_INFO("Network: Shutdown complete");
 }
 
 // Update network status and handle reconnection
@@ -74,18 +100,22 @@ void Network::update() {
     if (!initialized) return;
 
     updateConnectionStatus();
+    updatePowerSave();
+    sampleTelemetry();
 
     // Handle auto-reconnection
     if (autoReconnect && status == NetworkStatus::DISCONNECTED) {
         unsigned long currentTime = millis();
         if (currentTime - lastReconnectAttempt >= reconnectInterval) {
             if (reconnectAttempts < MAX_RECONNECT_ATTEMPTS) {
-                Serial.println("Network: Attempting auto-reconnection...");
+                LOG_INFO("Network: Attempting auto-reconnection...");
                 setNewStatus(NetworkStatus::RECONNECTING);
                 attemptReconnection();
             }
         }
     }
+
+    publishTelemetryReport();
 }
 
 // Connect to WiFi using credentials from secret.h
@@ -97,9 +127,7 @@ bool Network::connect() {
 bool Network::connect(const char* ssid, const char* password) {
     if (!initialized) return false;
 
-    Serial.print("Network: Connecting to ");
-    Serial.print(ssid);
-    Serial.println("...");
+    LOG_INFO("Network: Connecting to %s...", ssid);
 
     setNewStatus(NetworkStatus::CONNECTING);
     lastConnectionAttempt = millis();
@@ -114,21 +142,21 @@ bool Network::connect(const char* ssid, const char* password) {
         delay(100);
     }
 
+    telemetry.recordConnectAttempt(startTime, millis() - startTime, WiFi.status());
+
     if (WiFi.status() == WL_CONNECTED) {
         setNewStatus(NetworkStatus::CONNECTED);
         reconnectAttempts = 0;
 
-        Serial.println("Network: Connected!");
-        Serial.print("Network: IP Address: ");
-        Serial.println(WiFi.localIP());
-        Serial.print("Network: RSSI: ");
-        Serial.print(WiFi.RSSI());
-        Serial.println(" dBm");
+        IPAddress ip = WiFi.localIP();
+        LOG_INFO("Network: Connected!");
+        LOG_INFO("Network: IP Address: %u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+        LOG_INFO("Network: RSSI: %d dBm", WiFi.RSSI());
 
         return true;
     } else {
         setNewStatus(NetworkStatus::FAILED);
-        Serial.println("Network: Connection failed!");
+        LOG_WARN("Network: Connection failed!");
         return false;
     }
 }
@@ -136,7 +164,7 @@ bool Network::connect(const char* ssid, const char* password) {
 // Disconnect from WiFi
 void Network::disconnect() {
     if (WiFi.status() == WL_CONNECTED) {
-        Serial.println("Network: Disconnecting...");
+        LOG_INFO("Network: Disconnecting...");
         WiFi.disconnect();
     }
     setNewStatus(NetworkStatus::DISCONNECTED);
@@ -151,12 +179,17 @@ bool Network::reconnect() {
 
 // Get current network status
 NetworkStatus Network::getStatus() const {
-    return status;
+    return publishedStatus.load(std::memory_order_relaxed);
 }
 
 // Get network status as string
 const char* Network::getStatusString() const {
-    switch (status) {
+    return statusToString(status);
+}
+
+// Status names (static strings, safe to keep in deferred log records)
+const char* Network::statusToString(NetworkStatus value) {
+    switch (value) {
         case NetworkStatus::DISCONNECTED:
             return "Disconnected";
         case NetworkStatus::CONNECTING:
@@ -174,7 +207,7 @@ const char* Network::getStatusString() const {
 
 // Check if connected
 bool Network::isConnected() const {
-    return status == NetworkStatus::CONNECTED && WiFi.status() == WL_CONNECTED;
+    return getStatus() == NetworkStatus::CONNECTED && WiFi.status() == WL_CONNECTED;
 }
 
 // Get local IP address
@@ -206,6 +239,31 @@ String Network::getMACAddress() const {
     return WiFi.macAddress();
 }
 
+void Network::getLocalIP(char* buffer, size_t size) const {
+    if (isConnected()) {
+        IPAddress ip = WiFi.localIP();
+        snprintf(buffer, size, "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+        return;
+    }
+    snprintf(buffer, size, "0.0.0.0");
+}
+
+void Network::getSSID(char* buffer, size_t size) const {
+    // WiFi.SSID() reads the same record, but returns it as a String
+    wifi_ap_record_t info;
+    if (isConnected() && esp_wifi_sta_get_ap_info(&info) == ESP_OK) {
+        snprintf(buffer, size, "%.32s", (const char*)info.ssid);
+        return;
+    }
+    snprintf(buffer, size, "%s", wifiSSID.c_str());
+}
+
+void Network::getMACAddress(char* buffer, size_t size) const {
+    uint8_t mac[6];
+    WiFi.macAddress(mac);
+    snprintf(buffer, size, "%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
 // Get connected time in milliseconds
 unsigned long Network::getConnectedTime() const {
     if (isConnected() && connectionStartTime > 0) {
@@ -224,27 +282,120 @@ int Network::getReconnectAttempts() const {
     return reconnectAttempts;
 }
 
+// Get link history
+const NetworkTelemetry& Network::getTelemetry() const {
+    return telemetry;
+}
+
+// Clear link history
+void Network::clearTelemetry() {
+    telemetry.clear();
+}
+
+// Latest link history report for MSG_TELEMETRY; false if no clean copy could be made
+bool Network::readTelemetryReport(SerialProtocol::Telemetry& report) const {
+    return telemetryReport.read(report);
+}
+
+// Latest RSSI samples for the sparkline; false if no clean copy could be made
+bool Network::readRSSIHistory(RSSIHistory& history) const {
+    return rssiHistory.read(history);
+}
+
+// Check whether the modem is currently in power save
+bool Network::isPowerSaveActive() const {
+    return publishedPowerSave.load(std::memory_order_relaxed);
+}
+
+// Get radio time split and first-packet latency figures for tuning the idle timeout
+Network::PowerSaveStats Network::getPowerSaveStats() const {
+    PowerSaveStats stats;
+    stats.fullPowerTime = fullPowerTime;
+    stats.powerSaveTime = powerSaveTime;
+
+    // Include the time spent in the current mode so far
+    if (status == NetworkStatus::CONNECTED) {
+        unsigned long current = millis() - powerModeSince;
+        if (powerSaveActive) {
+            stats.powerSaveTime += current;
+        } else {
+            stats.fullPowerTime += current;
+        }
+    }
+
+    stats.wakeCount = wakeCount;
+    stats.awakeLatencyAvg = awakeLatencyCount ? awakeLatencySum / awakeLatencyCount : 0;
+    stats.wakeLatencyAvg = wakeLatencyCount ? wakeLatencySum / wakeLatencyCount : 0;
+    stats.wakeLatencyMax = wakeLatencyMax;
+    return stats;
+}
+
+// Reset power save counters
+void Network::resetPowerSaveStats() {
+    powerModeSince = millis();
+    fullPowerTime = 0;
+    powerSaveTime = 0;
+    wakeCount = 0;
+    awakeLatencySum = 0;
+    awakeLatencyCount = 0;
+    wakeLatencySum = 0;
+    wakeLatencyCount = 0;
+    wakeLatencyMax = 0;
+}
+
+// Time the first packet sent after an input event
+void Network::notePacketSent() {
+    if (!packetPending) return;
+    packetPending = false;
+
+    unsigned long latency = InputLog::now() - pendingInputTime;
+    if (pendingFromPowerSave) {
+        wakeLatencySum += latency;
+        wakeLatencyCount++;
+        if (latency > wakeLatencyMax) wakeLatencyMax = latency;
+    } else {
+        awakeLatencySum += latency;
+        awakeLatencyCount++;
+    }
+}
+
 // Set auto-reconnect behavior
 void Network::setAutoReconnect(bool enable) {
     autoReconnect = enable;
-    Serial.print("Network: Auto-reconnect ");
-    Serial.println(enable ? "enabled" : "disabled");
+    LOG_INFO("Network: Auto-reconnect %s", enable ? "enabled" : "disabled");
 }
 
 // Set reconnect interval
 void Network::setReconnectInterval(unsigned long intervalMs) {
     reconnectInterval = intervalMs;
-    Serial.print("Network: Reconnect interval set to ");
-    Serial.print(intervalMs);
-    Serial.println(" ms");
+    LOG_INFO("Network: Reconnect interval set to %lu ms", intervalMs);
 }
 
 // Set connection timeout
 void Network::setTimeout(unsigned long timeoutMs) {
     connectionTimeout = timeoutMs;
-    Serial.print("Network: Connection timeout set to ");
-    Serial.print(timeoutMs);
-    Serial.println(" ms");
+    LOG_INFO("Network: Connection timeout set to %lu ms", timeoutMs);
+}
+
+// Set RSSI sampling interval
+void Network::setRSSISampleInterval(unsigned long intervalMs) {
+    rssiSampleInterval = intervalMs;
+    LOG_INFO("Network: RSSI sample interval set to %lu ms", intervalMs);
+}
+
+// Enable or disable idle modem power save
+void Network::setPowerSaveEnabled(bool enable) {
+    powerSaveEnabled = enable;
+    if (!enable && powerSaveActive) {
+        setPowerSaveMode(false);
+    }
+    LOG_INFO("Network: Power save %s", enable ? "enabled" : "disabled");
+}
+
+// Set how long input must be idle before the modem enters power save
+void Network::setPowerSaveIdleTimeout(unsigned long timeoutMs) {
+    powerSaveIdleTimeout = timeoutMs;
+    LOG_INFO("Network: Power save idle timeout set to %lu ms", timeoutMs);
 }
 
 // Set event callback
@@ -258,8 +409,9 @@ void Network::setEventCallback(NetworkEventCallback callback) {
 void Network::setupWiFi() {
     WiFi.mode(WIFI_STA);
     WiFi.setAutoReconnect(false);  // Handle reconnection manually
+    WiFi.setSleep(WIFI_PS_NONE);   // Full performance until input goes idle
 
-    Serial.println("Network: WiFi setup complete");
+    LOG_INFO("Network: WiFi setup complete");
 }
 
 // Handle WiFi events
@@ -306,17 +458,14 @@ void Network::attemptReconnection() {
     lastReconnectAttempt = millis();
     reconnectAttempts++;
 
-    Serial.print("Network: Reconnection attempt ");
-    Serial.print(reconnectAttempts);
-    Serial.print("/");
-    Serial.println(MAX_RECONNECT_ATTEMPTS);
+    LOG_INFO("Network: Reconnection attempt %d/%d", reconnectAttempts, MAX_RECONNECT_ATTEMPTS);
 
     if (reconnect()) {
-        Serial.println("Network: Reconnection successful!");
+        LOG_INFO("Network: Reconnection successful!");
     } else {
-        Serial.println("Network: Reconnection failed");
+        LOG_WARN("Network: Reconnection failed");
         if (reconnectAttempts >= MAX_RECONNECT_ATTEMPTS) {
-            Serial.println("Network: Max reconnection attempts reached");
+            LOG_WARN("Network: Max reconnection attempts reached");
         }
     }
 }
@@ -327,10 +476,26 @@ void Network::setNewStatus(NetworkStatus newStatus) {
         NetworkStatus oldStatus = status;
         status = newStatus;
 
-        Serial.print("Network: Status changed from ");
-        Serial.print(getStatusString());
-        Serial.print(" to ");
-        Serial.println(getStatusString());
+        // Track session uptime for telemetry and start each session at full power
+        if (newStatus == NetworkStatus::CONNECTED) {
+            connectedSince = millis();
+            powerModeSince = connectedSince;
+            if (powerSaveActive) {
+                powerSaveActive = false;
+                WiFi.setSleep(WIFI_PS_NONE);
+            }
+        } else if (oldStatus == NetworkStatus::CONNECTED) {
+            unsigned long currentTime = millis();
+            telemetry.recordSessionUptime(currentTime - connectedSince);
+            if (powerSaveActive) {
+                powerSaveTime += currentTime - powerModeSince;
+            } else {
+                fullPowerTime += currentTime - powerModeSince;
+            }
+        }
+        publishLinkState();
+
+        LOG_INFO("Network: Status changed from %s to %s", statusToString(oldStatus), statusToString(newStatus));
 
         // Trigger callback if set
         if (eventCallback) {
@@ -338,3 +503,103 @@ void Network::setNewStatus(NetworkStatus newStatus) {
         }
     }
 }
+
+// Sample RSSI into the telemetry history while connected
+void Network::sampleTelemetry() {
+    if (status != NetworkStatus::CONNECTED) return;
+
+    unsigned long currentTime = millis();
+    if (currentTime - lastRSSISample >= rssiSampleInterval) {
+        lastRSSISample = currentTime;
+        telemetry.recordRSSI(WiFi.RSSI());
+    }
+}
+
+// Rebuild the MSG_TELEMETRY report and the RSSI copy when the history changed, for readers on other tasks
+void Network::publishTelemetryReport() {
+    if (telemetry.getVersion() == reportedTelemetryVersion) return;
+    reportedTelemetryVersion = telemetry.getVersion();
+
+    SerialProtocol::Telemetry report = {};
+    const NetworkTelemetry::Series series[3] = {NetworkTelemetry::Series::RSSI,
+                                                NetworkTelemetry::Series::CONNECT_DURATION,
+                                                NetworkTelemetry::Series::SESSION_UPTIME};
+    SerialProtocol::SeriesSummary* summaries[3] = {&report.rssi, &report.connect, &report.sessions};
+    for (uint8_t i = 0; i < 3; i++) {
+        NetworkTelemetry::Summary summary = telemetry.getSummary(series[i]);
+        summaries[i]->count = (uint8_t)summary.count;
+        summaries[i]->min = summary.min;
+        summaries[i]->max = summary.max;
+        summaries[i]->mean = summary.mean;
+    }
+
+    const auto& attempts = telemetry.getConnectAttempts();
+    report.failedAttempts = (uint8_t)telemetry.getFailedAttempts();
+    report.lastResult = attempts.empty() ? SerialProtocol::TELEMETRY_NO_RESULT : attempts.newest().result;
+
+    uint16_t bins[SerialProtocol::TELEMETRY_RSSI_BINS];
+    telemetry.getHistogram(NetworkTelemetry::Series::RSSI, bins, SerialProtocol::TELEMETRY_RSSI_BINS,
+                           SerialProtocol::TELEMETRY_RSSI_MIN, SerialProtocol::TELEMETRY_RSSI_MAX);
+    for (uint8_t i = 0; i < SerialProtocol::TELEMETRY_RSSI_BINS; i++) {
+        report.rssiBins[i] = bins[i] > 0xFF ? 0xFF : (uint8_t)bins[i];
+    }
+
+    telemetryReport.write(report);
+
+    const auto& samples = telemetry.getRSSIHistory();
+    RSSIHistory history = {};
+    history.count = (uint8_t)samples.size();
+    for (size_t i = 0; i < samples.size(); i++) {
+        history.samples[i] = samples[i];
+    }
+    rssiHistory.write(history);
+}
+
+// Switch modem power save based on input activity reported by IO
+void Network::updatePowerSave() {
+    if (!powerSaveEnabled || status != NetworkStatus::CONNECTED || !IO::hasInstance()) return;
+
+    unsigned long inputTime = IO::getInstance().getLastInputTime();
+
+    if (inputTime != lastSeenInputTime) {
+        // New input: time the first packet after it and wake the radio immediately
+        lastSeenInputTime = inputTime;
+        packetPending = true;
+        pendingFromPowerSave = powerSaveActive;
+        pendingInputTime = inputTime;
+
+        if (powerSaveActive) {
+            setPowerSaveMode(false);
+            wakeCount++;
+        }
+        return;
+    }
+
+    if (!powerSaveActive && (InputLog::now() - inputTime) >= powerSaveIdleTimeout) {
+        setPowerSaveMode(true);
+    }
+}
+
+// Apply a modem power save level and account the time spent in the previous one
+void Network::setPowerSaveMode(bool active) {
+    unsigned long currentTime = millis();
+    if (status == NetworkStatus::CONNECTED) {
+        if (powerSaveActive) {
+            powerSaveTime += currentTime - powerModeSince;
+        } else {
+            fullPowerTime += currentTime - powerModeSince;
+        }
+    }
+    powerModeSince = currentTime;
+    powerSaveActive = active;
+    publishLinkState();
+
+    WiFi.setSleep(active ? WIFI_PS_MAX_MODEM : WIFI_PS_NONE);
+}
+
+// Network task only. PowerManager reads these on the control task to decide whether
+// light sleep is safe, so they are stored as soon as they change, even mid-connect.
+void Network::publishLinkState() {
+    publishedStatus.store(status, std::memory_order_relaxed);
+    publishedPowerSave.store(powerSaveActive, std::memory_order_relaxed);
+}
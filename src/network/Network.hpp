@@ -2,6 +2,10 @@
 
 #include <WiFi.h>
 #include <WiFiClient.h>
+#include <atomic>
+#include "NetworkTelemetry.hpp"
+#include "../core/Seqlock.hpp"
+#include "../protocol/SerialProtocol.hpp"
 
 // Network status enumeration
 enum class NetworkStatus {
@@ -48,24 +52,62 @@ class Network {
     void disconnect();
     bool reconnect();
 
-    // Status methods
+    // Status methods (getStatus, isConnected and isPowerSaveActive may be called from any task)
     NetworkStatus getStatus() const;
     const char* getStatusString() const;
+    static const char* statusToString(NetworkStatus value);
     bool isConnected() const;
     String getLocalIP() const;
     String getSSID() const;
     int getRSSI() const;
     String getMACAddress() const;
 
+    // Same values formatted into the caller's buffer, without a heap String
+    void getLocalIP(char* buffer, size_t size) const;
+    void getSSID(char* buffer, size_t size) const;
+    void getMACAddress(char* buffer, size_t size) const;
+
     // Connection monitoring
     unsigned long getConnectedTime() const;
     unsigned long getLastReconnectAttempt() const;
     int getReconnectAttempts() const;
 
+    // Link history (RSSI samples, connect attempts, session uptimes); network task only
+    const NetworkTelemetry& getTelemetry() const;
+    void clearTelemetry();
+
+    // Summaries and RSSI histogram of the link history as sent in MSG_TELEMETRY,
+    // republished by update() after every change (callable from other tasks)
+    bool readTelemetryReport(SerialProtocol::Telemetry& report) const;
+
+    // Copy of the RSSI samples, oldest first, published alongside the report
+    struct RSSIHistory {
+        uint8_t count;
+        int8_t samples[NetworkTelemetry::RSSI_HISTORY];
+    };
+    bool readRSSIHistory(RSSIHistory& history) const;
+
+    // Activity-aware modem power save (input activity comes from IO)
+    struct PowerSaveStats {
+        unsigned long fullPowerTime;     // ms connected at WIFI_PS_NONE
+        unsigned long powerSaveTime;     // ms connected at WIFI_PS_MAX_MODEM
+        unsigned long wakeCount;         // power save -> full power transitions
+        unsigned long awakeLatencyAvg;   // ms input -> first packet, radio already at full power
+        unsigned long wakeLatencyAvg;    // ms input -> first packet, radio woken from power save
+        unsigned long wakeLatencyMax;
+    };
+    bool isPowerSaveActive() const;
+    PowerSaveStats getPowerSaveStats() const;
+    void resetPowerSaveStats();
+    void notePacketSent();  // Call from network consumers after a successful send
+
     // Configuration
     void setAutoReconnect(bool enable);
     void setReconnectInterval(unsigned long intervalMs);
     void setTimeout(unsigned long timeoutMs);
+    void setRSSISampleInterval(unsigned long intervalMs);
+    void setPowerSaveEnabled(bool enable);
+    void setPowerSaveIdleTimeout(unsigned long timeoutMs);
 
     // Event callbacks (optional)
     typedef void (*NetworkEventCallback)(NetworkStatus status);
@@ -82,6 +124,39 @@ class Network {
     unsigned long lastReconnectAttempt;
     unsigned long connectionStartTime;
     int reconnectAttempts;
+    unsigned long connectedSince;
+
+    // Telemetry
+    NetworkTelemetry telemetry;
+    unsigned long rssiSampleInterval;
+    unsigned long lastRSSISample;
+    Seqlock<SerialProtocol::Telemetry> telemetryReport;
+    Seqlock<RSSIHistory> rssiHistory;
+    uint32_t reportedTelemetryVersion;
+
+    // Modem power save
+    bool powerSaveEnabled;
+    bool powerSaveActive;
+    unsigned long powerSaveIdleTimeout;
+    unsigned long powerModeSince;
+    unsigned long lastSeenInputTime;
+    unsigned long fullPowerTime;
+    unsigned long powerSaveTime;
+    unsigned long wakeCount;
+
+    // First-packet latency after an input event
+    bool packetPending;
+    bool pendingFromPowerSave;
+    unsigned long pendingInputTime;
+    unsigned long awakeLatencySum;
+    unsigned long awakeLatencyCount;
+    unsigned long wakeLatencySum;
+    unsigned long wakeLatencyCount;
+    unsigned long wakeLatencyMax;
+
+    // Copies of status and powerSaveActive for other tasks, stored whenever either changes
+    std::atomic<NetworkStatus> publishedStatus;
+    std::atomic<bool> publishedPowerSave;
 
     // WiFi credentials (from secret.h)
     String wifiSSID;
@@ -96,9 +171,16 @@ class Network {
     void updateConnectionStatus();
     void attemptReconnection();
     void setNewStatus(NetworkStatus newStatus);
+    void sampleTelemetry();
+    void publishTelemetryReport();
+    void updatePowerSave();
+    void setPowerSaveMode(bool active);
+    void publishLinkState();
 
     // Configuration constants
     static const unsigned long DEFAULT_CONNECTION_TIMEOUT = 10000;  // 10 seconds
     static const unsigned long DEFAULT_RECONNECT_INTERVAL = 5000;   // 5 seconds
+    static const unsigned long DEFAULT_RSSI_SAMPLE_INTERVAL = 5000; // 5 seconds
+    static const unsigned long DEFAULT_POWER_SAVE_IDLE = 30000;     // 30 seconds
     static const int MAX_RECONNECT_ATTEMPTS = 5;
 };
@@ -0,0 +1,140 @@
+#include "NetworkTelemetry.hpp"
+
+NetworkTelemetry::NetworkTelemetry() : version(0) {
+}
+
+void NetworkTelemetry::recordRSSI(int rssi) {
+    // RSSI is reported in dBm, well within int8_t
+    if (rssi < -128) rssi = -128;
+    if (rssi > 0) rssi = 0;
+    rssiHistory.push((int8_t)rssi);
+    version++;
+}
+
+void NetworkTelemetry::recordConnectAttempt(unsigned long startTime, unsigned long duration, wl_status_t result) {
+    connectAttempts.push({startTime, (uint32_t)duration, (uint8_t)result});
+    version++;
+}
+
+void NetworkTelemetry::recordSessionUptime(unsigned long durationMs) {
+    sessionUptimes.push((uint32_t)(durationMs / 1000));
+    version++;
+}
+
+void NetworkTelemetry::clear() {
+    rssiHistory.clear();
+    connectAttempts.clear();
+    sessionUptimes.clear();
+    version++;
+}
+
+const RingBuffer<int8_t, NetworkTelemetry::RSSI_HISTORY>& NetworkTelemetry::getRSSIHistory() const {
+    return rssiHistory;
+}
+
+const RingBuffer<NetworkTelemetry::ConnectAttempt, NetworkTelemetry::ATTEMPT_HISTORY>& NetworkTelemetry::getConnectAttempts() const {
+    return connectAttempts;
+}
+
+const RingBuffer<uint32_t, NetworkTelemetry::SESSION_HISTORY>& NetworkTelemetry::getSessionUptimes() const {
+    return sessionUptimes;
+}
+
+NetworkTelemetry::Summary NetworkTelemetry::getSummary(Series series) const {
+    Summary summary = {0, 0, 0, 0};
+    size_t count = seriesSize(series);
+    if (count == 0) return summary;
+
+    int64_t sum = 0;
+    summary.min = INT32_MAX;
+    summary.max = INT32_MIN;
+    for (size_t i = 0; i < count; i++) {
+        int32_t value = seriesValue(series, i);
+        if (value < summary.min) summary.min = value;
+        if (value > summary.max) summary.max = value;
+        sum += value;
+    }
+
+    summary.count = count;
+    summary.mean = (int32_t)(sum / (int64_t)count);
+    return summary;
+}
+
+// Fill bins with counts over [minValue, maxValue); out-of-range samples go to the edge bins.
+// Returns the number of samples counted.
+size_t NetworkTelemetry::getHistogram(Series series, uint16_t* bins, size_t binCount, int32_t minValue, int32_t maxValue) const {
+    if (!bins || binCount == 0 || maxValue <= minValue) return 0;
+
+    for (size_t i = 0; i < binCount; i++) {
+        bins[i] = 0;
+    }
+
+    size_t count = seriesSize(series);
+    int64_t range = (int64_t)maxValue - minValue;
+    for (size_t i = 0; i < count; i++) {
+        int64_t offset = (int64_t)seriesValue(series, i) - minValue;
+        if (offset < 0) offset = 0;
+        if (offset >= range) offset = range - 1;
+        bins[(size_t)(offset * (int64_t)binCount / range)]++;
+    }
+    return count;
+}
+
+size_t NetworkTelemetry::getFailedAttempts() const {
+    size_t failed = 0;
+    for (size_t i = 0; i < connectAttempts.size(); i++) {
+        if (connectAttempts[i].result != WL_CONNECTED) failed++;
+    }
+    return failed;
+}
+
+uint32_t NetworkTelemetry::getVersion() const {
+    return version;
+}
+
+const char* NetworkTelemetry::resultToString(uint8_t result) {
+    switch (result) {
+        case WL_CONNECTED:
+            return "connected";
+        case WL_NO_SSID_AVAIL:
+            return "no_ssid";
+        case WL_CONNECT_FAILED:
+            return "connect_failed";
+        case WL_CONNECTION_LOST:
+            return "connection_lost";
+        case WL_DISCONNECTED:
+            return "timeout";
+        case WL_IDLE_STATUS:
+            return "idle";
+        default:
+            return "unknown";
+    }
+}
+
+// Private methods
+
+size_t NetworkTelemetry::seriesSize(Series series) const {
+    switch (series) {
+        case Series::RSSI:
+            return rssiHistory.size();
+        case Series::CONNECT_DURATION:
+            return connectAttempts.size();
+        case Series::SESSION_UPTIME:
+            return sessionUptimes.size();
+        default:
+            return 0;
+    }
+}
+
+int32_t NetworkTelemetry::seriesValue(Series series, size_t index) const {
+    switch (series) {
+        case Series::RSSI:
+            return rssiHistory[index];
+        case Series::CONNECT_DURATION:
+            return (int32_t)connectAttempts[index].duration;
+        case Series::SESSION_UPTIME:
+            return (int32_t)sessionUptimes[index];
+        default:
+            return 0;
+    }
+}
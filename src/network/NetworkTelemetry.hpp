@@ -0,0 +1,94 @@
+#pragma once
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+// Fixed-capacity ring buffer, overwrites the oldest entry when full
+template <typename T, size_t N>
+class RingBuffer {
+   public:
+    RingBuffer() : head(0), count(0) {}
+
+    void push(const T& value) {
+        data[head] = value;
+        head = (head + 1) % N;
+        if (count < N) count++;
+    }
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return N; }
+    bool empty() const { return count == 0; }
+
+    // Index 0 is the oldest entry
+    const T& operator[](size_t index) const { return data[(head + N - count + index) % N]; }
+    const T& newest() const { return data[(head + N - 1) % N]; }
+
+   private:
+    T data[N];
+    size_t head;
+    size_t count;
+};
+
+// Link history kept by Network: RSSI samples, connect attempts and session uptimes
+class NetworkTelemetry {
+   public:
+    static const size_t RSSI_HISTORY = 64;
+    static const size_t ATTEMPT_HISTORY = 16;
+    static const size_t SESSION_HISTORY = 16;
+
+    enum class Series {
+        RSSI,              // dBm
+        CONNECT_DURATION,  // ms per attempt
+        SESSION_UPTIME     // seconds per finished session
+    };
+
+    struct ConnectAttempt {
+        unsigned long timestamp;  // millis() when the attempt started
+        uint32_t duration;        // ms until connected or timed out
+        uint8_t result;           // wl_status_t at the end of the attempt
+    };
+
+    struct Summary {
+        size_t count;
+        int32_t min;
+        int32_t max;
+        int32_t mean;
+    };
+
+    NetworkTelemetry();
+
+    // Recording
+    void recordRSSI(int rssi);
+    void recordConnectAttempt(unsigned long startTime, unsigned long duration, wl_status_t result);
+    void recordSessionUptime(unsigned long durationMs);
+    void clear();
+
+    // Raw history
+    const RingBuffer<int8_t, RSSI_HISTORY>& getRSSIHistory() const;
+    const RingBuffer<ConnectAttempt, ATTEMPT_HISTORY>& getConnectAttempts() const;
+    const RingBuffer<uint32_t, SESSION_HISTORY>& getSessionUptimes() const;
+
+    // Analysis
+    Summary getSummary(Series series) const;
+    size_t getHistogram(Series series, uint16_t* bins, size_t binCount, int32_t minValue, int32_t maxValue) const;
+    size_t getFailedAttempts() const;
+
+    // Bumped by every change, so a reader can tell whether to rebuild its copy
+    uint32_t getVersion() const;
+
+    static const char* resultToString(uint8_t result);
+
+   private:
+    RingBuffer<int8_t, RSSI_HISTORY> rssiHistory;
+    RingBuffer<ConnectAttempt, ATTEMPT_HISTORY> connectAttempts;
+    RingBuffer<uint32_t, SESSION_HISTORY> sessionUptimes;
+    uint32_t version;
+
+    size_t seriesSize(Series series) const;
+    int32_t seriesValue(Series series, size_t index) const;
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+// Latest-value queue behind MqttPublisher, one slot per channel.
+//
+// set() overwrites the channel's value and marks it dirty, so however many
+// changes arrive between two flushes, each channel is published at most
+// once with its newest value. While the broker is unreachable nothing is
+// flushed and the queue simply holds the newest value per channel: it is
+// bounded by MAX_CHANNELS and never grows with the length of the outage.
+//
+// Kept free of the MQTT client; MqttPublisher::flush() supplies the publish
+// step (test/host/test_publish_queue.cpp runs both against a broker stand-in).
+class PublishQueue {
+   public:
+    static const uint8_t MAX_CHANNELS = 16;
+
+    PublishQueue() : dirtyMask(0), channelCount(0), coalescedCount(0) {
+        memset(values, 0, sizeof(values));
+    }
+
+    // Store the latest value for a channel and queue it
+    void set(uint8_t channel, int value) {
+        if (channel >= MAX_CHANNELS) return;
+
+        if (channel >= channelCount) {
+            channelCount = channel + 1;
+        }
+
+        uint32_t bit = 1UL << channel;
+        if (dirtyMask & bit) {
+            coalescedCount++;
+        }
+
+        values[channel] = value;
+        dirtyMask |= bit;
+    }
+
+    // Publish every queued channel once, lowest first. publish(channel, value)
+    // returns false when the session dropped the message; that channel stays
+    // queued and the flush stops, since the rest would fail too. Returns the
+    // number of channels published.
+    template <typename Publish>
+    uint8_t flush(Publish&& publish) {
+        uint8_t published = 0;
+        uint32_t pending = dirtyMask;
+
+        while (pending != 0) {
+            uint8_t channel = __builtin_ctz(pending);
+            uint32_t bit = 1UL << channel;
+            pending &= ~bit;
+
+            // Clear first so a change arriving mid-publish is not lost
+            dirtyMask &= ~bit;
+            if (!publish(channel, values[channel])) {
+                dirtyMask |= bit;
+                break;
+            }
+            published++;
+        }
+
+        return published;
+    }
+
+    bool hasPending() const { return dirtyMask != 0; }
+    uint8_t getPendingCount() const { return __builtin_popcount(dirtyMask); }
+    uint8_t getChannelCount() const { return channelCount; }
+    int getValue(uint8_t channel) const { return channel < MAX_CHANNELS ? values[channel] : 0; }
+
+    // Changes that replaced a value still waiting to be published
+    unsigned long getCoalescedCount() const { return coalescedCount; }
+    void resetStats() { coalescedCount = 0; }
+
+   private:
+    int values[MAX_CHANNELS];
+    uint32_t dirtyMask;
+    uint8_t channelCount;
+    unsigned long coalescedCount;
+};
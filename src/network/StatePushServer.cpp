@@ -0,0 +1,259 @@
+#include "StatePushServer.hpp"
+#include "Network.hpp"
+#include "../core/Log.hpp"
+
+// Initialize static instance pointer
+StatePushServer* StatePushServer::instance = nullptr;
+
+// Private constructor
+StatePushServer::StatePushServer() : server(nullptr),
+                                     initialized(false),
+                                     listening(false),
+                                     port(DEFAULT_PORT),
+                                     pushInterval(DEFAULT_PUSH_INTERVAL),
+                                     channelCount(0),
+                                     lastFanoutLatency(0),
+                                     maxFanoutLatency(0),
+                                     framesSent(0) {
+    for (uint8_t i = 0; i < MAX_CHANNELS; i++) {
+        channelValues[i] = 0;
+        channelChangedAt[i] = 0;
+    }
+    for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+        clients[i] = {false, false, 0, 0};
+    }
+}
+
+// Destructor
+StatePushServer::~StatePushServer() {
+    shutdown();
+}
+
+// Static method to get the singleton instance
+StatePushServer& StatePushServer::getInstance() {
+    if (instance == nullptr) {
+        instance = new StatePushServer();
+    }
+    return *instance;
+}
+
+// Static method to check if instance exists
+bool StatePushServer::hasInstance() {
+    return instance != nullptr;
+}
+
+// Static method to destroy the instance
+void StatePushServer::destroyInstance() {
+    if (instance != nullptr) {
+        delete instance;
+        instance = nullptr;
+    }
+}
+
+// Initialize the server (listening starts once the network is connected)
+void StatePushServer::initialize() {
+    if (initialized) return;
+
+    server = new WebSocketsServer(port);
+    server->onEvent([this](uint8_t num, WStype_t type, uint8_t* payload, size_t length) {
+        handleEvent(num, type, payload, length);
+    });
+    initialized = true;
+
+    LOG_INFO("WebSocket: Initialized");
+}
+
+// Shutdown the server and drop all clients
+void StatePushServer::shutdown() {
+    if (!initialized) return;
+
+    if (listening) {
+        server->close();
+        listening = false;
+    }
+    delete server;
+    server = nullptr;
+
+    for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+        clients[i] = {false, false, 0, 0};
+    }
+    initialized = false;
+
+    LOG_INFO("WebSocket: Shutdown complete");
+}
+
+// Service the socket and push pending diffs - call this regularly in main loop
+void StatePushServer::update() {
+    if (!initialized) return;
+
+    if (!listening) {
+        if (!Network::hasInstance() || !Network::getInstance().isConnected()) return;
+        startListening();
+    }
+
+    server->loop();
+
+    unsigned long now = millis();
+    for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+        ClientState& client = clients[i];
+        if (!client.connected) continue;
+        if (!client.needsSnapshot && client.pendingMask == 0) continue;
+        if (now - client.lastPush < pushInterval) continue;
+
+        pushToClient(i, now);
+    }
+}
+
+// Record a new channel value and mark it dirty for every client
+void StatePushServer::setChannelValue(uint8_t channel, int value, unsigned long changedAt) {
+    if (channel >= MAX_CHANNELS) return;
+
+    if (channel >= channelCount) {
+        channelCount = channel + 1;
+    } else if (channelValues[channel] == value) {
+        return;
+    }
+
+    channelValues[channel] = value;
+    channelChangedAt[channel] = changedAt;
+
+    uint32_t bit = 1UL << channel;
+    for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+        if (clients[i].connected) {
+            clients[i].pendingMask |= bit;
+        }
+    }
+}
+
+int StatePushServer::getChannelValue(uint8_t channel) const {
+    return channel < MAX_CHANNELS ? channelValues[channel] : 0;
+}
+
+// Set the listening port (takes effect on the next initialize)
+void StatePushServer::setPort(uint16_t port) {
+    this->port = port;
+}
+
+// Set the minimum time between two frames to the same client
+void StatePushServer::setPushInterval(unsigned long intervalMs) {
+    pushInterval = intervalMs;
+}
+
+uint8_t StatePushServer::getClientCount() const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+        if (clients[i].connected) count++;
+    }
+    return count;
+}
+
+unsigned long StatePushServer::getLastFanoutLatency() const {
+    return lastFanoutLatency;
+}
+
+unsigned long StatePushServer::getMaxFanoutLatency() const {
+    return maxFanoutLatency;
+}
+
+unsigned long StatePushServer::getFramesSent() const {
+    return framesSent;
+}
+
+void StatePushServer::resetStats() {
+    lastFanoutLatency = 0;
+    maxFanoutLatency = 0;
+    framesSent = 0;
+}
+
+// Private methods
+
+void StatePushServer::startListening() {
+    server->begin();
+    listening = true;
+
+    LOG_INFO("WebSocket: Listening on port %u", port);
+}
+
+void StatePushServer::handleEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length) {
+    if (num >= MAX_CLIENTS) return;
+
+    switch (type) {
+        case WStype_CONNECTED:
+            // Snapshot goes out on the next update, not from inside the handshake
+            clients[num] = {true, true, 0, 0};
+            break;
+
+        case WStype_DISCONNECTED:
+            clients[num] = {false, false, 0, 0};
+            break;
+
+        default:
+            // Clients only listen; incoming frames are ignored
+            break;
+    }
+}
+
+void StatePushServer::pushToClient(uint8_t num, unsigned long now) {
+    ClientState& client = clients[num];
+
+    size_t length;
+    if (client.needsSnapshot) {
+        length = buildSnapshotFrame();
+    } else {
+        length = buildDiffFrame(client.pendingMask);
+        recordLatency(client.pendingMask);
+    }
+
+    // Clear before sending so changes made by callbacks during the send are kept
+    client.needsSnapshot = false;
+    client.pendingMask = 0;
+    client.lastPush = now;
+
+    if (server->sendTXT(num, frameBuffer, length)) {
+        framesSent++;
+        Network::getInstance().notePacketSent();
+    } else if (client.connected) {
+        // The cleared channels never reached the client; resend everything on the next push
+        client.needsSnapshot = true;
+    }
+}
+
+// Full state: {"s":[v0,v1,...]}
+size_t StatePushServer::buildSnapshotFrame() {
+    size_t pos = snprintf(frameBuffer, sizeof(frameBuffer), "{\"s\":[");
+    for (uint8_t i = 0; i < channelCount; i++) {
+        pos += snprintf(frameBuffer + pos, sizeof(frameBuffer) - pos, i ? ",%d" : "%d", channelValues[i]);
+    }
+    pos += snprintf(frameBuffer + pos, sizeof(frameBuffer) - pos, "]}");
+    return pos;
+}
+
+// Changed channels only: {"d":[[channel,value],...]}
+size_t StatePushServer::buildDiffFrame(uint32_t mask) {
+    size_t pos = snprintf(frameBuffer, sizeof(frameBuffer), "{\"d\":[");
+    bool first = true;
+    for (uint8_t i = 0; i < channelCount; i++) {
+        if (!(mask & (1UL << i))) continue;
+        pos += snprintf(frameBuffer + pos, sizeof(frameBuffer) - pos, first ? "[%u,%d]" : ",[%u,%d]",
+                        i, channelValues[i]);
+        first = false;
+    }
+    pos += snprintf(frameBuffer + pos, sizeof(frameBuffer) - pos, "]}");
+    return pos;
+}
+
+// Latency from the oldest input event in this frame to the moment it is sent
+void StatePushServer::recordLatency(uint32_t mask) {
+    unsigned long now = micros();
+    unsigned long latency = 0;
+    for (uint8_t i = 0; i < channelCount; i++) {
+        if (!(mask & (1UL << i))) continue;
+        unsigned long age = now - channelChangedAt[i];
+        if (age > latency) latency = age;
+    }
+
+    lastFanoutLatency = latency;
+    if (latency > maxFanoutLatency) {
+        maxFanoutLatency = latency;
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <Arduino.h>
+#include <WebSocketsServer.h>
+
+// WebSocket endpoint that pushes mixer channel changes to connected clients.
+// New clients receive a full snapshot, after that only the changed channels
+// are sent, coalesced per client and limited to one frame per push interval.
+class StatePushServer {
+   private:
+    // Private constructor to prevent direct instantiation
+    StatePushServer();
+
+    // Static instance pointer
+    static StatePushServer* instance;
+
+    // Delete copy constructor and assignment operator
+    StatePushServer(const StatePushServer&) = delete;
+    StatePushServer& operator=(const StatePushServer&) = delete;
+
+   public:
+    static const uint8_t MAX_CHANNELS = 16;
+    static const uint8_t MAX_CLIENTS = WEBSOCKETS_SERVER_CLIENT_MAX;
+
+    // Public destructor
+    ~StatePushServer();
+
+    // Static method to get the singleton instance
+    static StatePushServer& getInstance();
+
+    // Static method to check if instance exists
+    static bool hasInstance();
+
+    // Static method to destroy the instance
+    static void destroyInstance();
+
+    // Server lifecycle methods
+    void initialize();
+    void shutdown();
+    void update();
+
+    // Channel state (cheap and non-blocking). changedAt is the micros() of the
+    // input that produced the value (Mixer::Snapshot::changedAt), so the fan-out
+    // latency covers the trip from the control task as well as the push.
+    void setChannelValue(uint8_t channel, int value, unsigned long changedAt);
+    int getChannelValue(uint8_t channel) const;
+
+    // Configuration
+    void setPort(uint16_t port);
+    void setPushInterval(unsigned long intervalMs);
+
+    // Monitoring
+    uint8_t getClientCount() const;
+    unsigned long getLastFanoutLatency() const;  // microseconds, input event to send
+    unsigned long getMaxFanoutLatency() const;   // microseconds, input event to send
+    unsigned long getFramesSent() const;
+    void resetStats();
+
+   private:
+    struct ClientState {
+        bool connected;
+        bool needsSnapshot;
+        uint32_t pendingMask;  // Channels changed since the last frame to this client
+        unsigned long lastPush;
+    };
+
+    WebSocketsServer* server;
+
+    bool initialized;
+    bool listening;
+    uint16_t port;
+    unsigned long pushInterval;
+
+    // Channel state
+    int channelValues[MAX_CHANNELS];
+    unsigned long channelChangedAt[MAX_CHANNELS];  // micros() of the input behind the latest change
+    uint8_t channelCount;
+
+    // Per-client state
+    ClientState clients[MAX_CLIENTS];
+
+    // Preallocated frame buffer, shared by all clients
+    char frameBuffer[16 + MAX_CHANNELS * 18];
+
+    // Stats
+    unsigned long lastFanoutLatency;
+    unsigned long maxFanoutLatency;
+    unsigned long framesSent;
+
+    // Internal methods
+    void startListening();
+    void handleEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length);
+    void pushToClient(uint8_t num, unsigned long now);
+    size_t buildSnapshotFrame();
+    size_t buildDiffFrame(uint32_t mask);
+    void recordLatency(uint32_t mask);
+
+    // Configuration constants
+    static const uint16_t DEFAULT_PORT = 81;
+    static const unsigned long DEFAULT_PUSH_INTERVAL = 50;  // 20 frames/s per client
+};
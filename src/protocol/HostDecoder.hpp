@@ -0,0 +1,205 @@
+#pragma once
+
+// PC end of the binary serial protocol (see SerialProtocol.hpp).
+//
+// Keeps a mirror of the device's channel table from MSG_SNAPSHOT and
+// MSG_DELTA frames, queues MSG_ACK frames for the tool to match against its
+// commands, keeps the latest MSG_TELEMETRY report and encodes commands. Like
+// SerialProtocol.hpp it has no Arduino dependencies: a host tool feeds it
+// whatever it reads from the serial port and writes the encoded commands back.
+//
+// The device numbers every frame it sends, so a jump in seq means frames
+// were lost (e.g. the port was opened mid-stream or the OS buffer
+// overflowed). The mirror may then be stale until the next snapshot; the
+// tool can send requestSnapshot() to resynchronise.
+
+#include "SerialProtocol.hpp"
+
+namespace SerialProtocol {
+
+class HostDecoder {
+   public:
+    static const uint8_t ACK_QUEUE_SIZE = 8;
+
+    struct Ack {
+        uint8_t commandSeq;
+        uint8_t status;
+    };
+
+    struct Stats {
+        uint32_t snapshots;
+        uint32_t deltas;
+        uint32_t acks;
+        uint32_t telemetryReports;
+        uint32_t seqGaps;       // Jumps in the device's frame numbering
+        uint32_t badMessages;   // Valid frames whose payload does not parse
+        uint32_t droppedAcks;   // Acks lost to a full queue
+    };
+
+    HostDecoder()
+        : decoder(onFrame, this), channelCount(0), synced(false), seqKnown(false), nextSeq(0), commandSeq(0),
+          ackHead(0), ackCount(0), telemetryFresh(false) {
+        memset(channels, 0, sizeof(channels));
+        memset(&telemetry, 0, sizeof(telemetry));
+        memset(&stats, 0, sizeof(stats));
+    }
+
+    void feed(const uint8_t* data, size_t count) { decoder.feed(data, count); }
+
+    // Channel mirror, valid once the first snapshot has arrived
+    bool hasSnapshot() const { return synced; }
+    uint8_t getChannelCount() const { return channelCount; }
+    const ChannelState& getChannel(uint8_t channel) const { return channels[channel < MAX_CHANNELS ? channel : 0]; }
+
+    // Oldest queued ack, false when none is waiting
+    bool takeAck(Ack& ack) {
+        if (ackCount == 0) return false;
+        ack = acks[ackHead];
+        ackHead = (ackHead + 1) % ACK_QUEUE_SIZE;
+        ackCount--;
+        return true;
+    }
+
+    // Latest telemetry report, false if none arrived since the last call
+    bool takeTelemetry(Telemetry& report) {
+        if (!telemetryFresh) return false;
+        report = telemetry;
+        telemetryFresh = false;
+        return true;
+    }
+
+    // Command encoders. Each returns the bytes written to out, 0 if capacity is
+    // too small; getLastCommandSeq() is the seq the device will ack.
+    size_t setTarget(uint8_t channel, uint8_t level, uint8_t* out, size_t capacity) {
+        uint8_t payload[2] = {channel, level};
+        return encodeCommand(CMD_SET_TARGET, payload, 2, out, capacity);
+    }
+
+    size_t setMute(uint8_t channel, bool muted, uint8_t* out, size_t capacity) {
+        uint8_t payload[2] = {channel, (uint8_t)(muted ? 1 : 0)};
+        return encodeCommand(CMD_SET_MUTE, payload, 2, out, capacity);
+    }
+
+    size_t requestSnapshot(uint8_t* out, size_t capacity) {
+        return encodeCommand(CMD_REQUEST_SNAPSHOT, nullptr, 0, out, capacity);
+    }
+
+    size_t ping(uint8_t* out, size_t capacity) {
+        return encodeCommand(CMD_PING, nullptr, 0, out, capacity);
+    }
+
+    size_t getTelemetry(uint8_t* out, size_t capacity) {
+        return encodeCommand(CMD_GET_TELEMETRY, nullptr, 0, out, capacity);
+    }
+
+    uint8_t getLastCommandSeq() const { return (uint8_t)(commandSeq - 1); }
+
+    const Stats& getStats() const { return stats; }
+    const FrameDecoder::Stats& getFrameStats() const { return decoder.getStats(); }
+
+   private:
+    FrameDecoder decoder;
+    FrameWriter writer;
+    ChannelState channels[MAX_CHANNELS];
+    uint8_t channelCount;
+    bool synced;
+    bool seqKnown;
+    uint8_t nextSeq;
+    uint8_t commandSeq;
+    Ack acks[ACK_QUEUE_SIZE];
+    uint8_t ackHead;
+    uint8_t ackCount;
+    Telemetry telemetry;
+    bool telemetryFresh;
+    Stats stats;
+
+    size_t encodeCommand(uint8_t type, const uint8_t* payload, size_t length, uint8_t* out, size_t capacity) {
+        writer.begin(type, commandSeq);
+        for (size_t i = 0; i < length; i++) {
+            writer.put(payload[i]);
+        }
+        size_t written = writer.finish(out, capacity);
+        if (written > 0) commandSeq++;
+        return written;
+    }
+
+    void handleFrame(uint8_t type, uint8_t seq, const uint8_t* payload, size_t length) {
+        if (seqKnown && seq != nextSeq) {
+            stats.seqGaps++;
+        }
+        seqKnown = true;
+        nextSeq = seq + 1;
+
+        switch (type) {
+            case MSG_SNAPSHOT:
+                if (!applySnapshot(payload, length)) stats.badMessages++;
+                break;
+            case MSG_DELTA:
+                if (!applyDelta(payload, length)) stats.badMessages++;
+                break;
+            case MSG_ACK:
+                if (length != 2) {
+                    stats.badMessages++;
+                } else {
+                    pushAck(payload[0], payload[1]);
+                }
+                break;
+            case MSG_TELEMETRY:
+                if (parseTelemetry(payload, length, telemetry)) {
+                    telemetryFresh = true;
+                    stats.telemetryReports++;
+                } else {
+                    stats.badMessages++;
+                }
+                break;
+            default:
+                stats.badMessages++;
+                break;
+        }
+    }
+
+    bool applySnapshot(const uint8_t* payload, size_t length) {
+        if (length < 1 || payload[0] > MAX_CHANNELS || length != 1 + payload[0] * CHANNEL_STATE_SIZE) return false;
+
+        channelCount = payload[0];
+        for (uint8_t channel = 0; channel < channelCount; channel++) {
+            const uint8_t* entry = payload + 1 + channel * CHANNEL_STATE_SIZE;
+            channels[channel] = {entry[0], entry[1], entry[2]};
+        }
+        synced = true;
+        stats.snapshots++;
+        return true;
+    }
+
+    bool applyDelta(const uint8_t* payload, size_t length) {
+        if (length < 1 || length != 1 + payload[0] * (1 + CHANNEL_STATE_SIZE)) return false;
+
+        // Validate the whole frame first so a bad entry leaves the mirror untouched
+        for (uint8_t i = 0; i < payload[0]; i++) {
+            if (payload[1 + i * (1 + CHANNEL_STATE_SIZE)] >= MAX_CHANNELS) return false;
+        }
+        for (uint8_t i = 0; i < payload[0]; i++) {
+            const uint8_t* entry = payload + 1 + i * (1 + CHANNEL_STATE_SIZE);
+            channels[entry[0]] = {entry[1], entry[2], entry[3]};
+        }
+        stats.deltas++;
+        return true;
+    }
+
+    void pushAck(uint8_t seq, uint8_t status) {
+        stats.acks++;
+        if (ackCount == ACK_QUEUE_SIZE) {
+            ackHead = (ackHead + 1) % ACK_QUEUE_SIZE;
+            ackCount--;
+            stats.droppedAcks++;
+        }
+        acks[(ackHead + ackCount) % ACK_QUEUE_SIZE] = {seq, status};
+        ackCount++;
+    }
+
+    static void onFrame(uint8_t type, uint8_t seq, const uint8_t* payload, size_t length, void* context) {
+        static_cast<HostDecoder*>(context)->handleFrame(type, seq, payload, length);
+    }
+};
+
+}  // namespace SerialProtocol
@@ -0,0 +1,278 @@
+#include "SerialLink.hpp"
+#include "../mixer/Mixer.hpp"
+#include "../io/InputLog.hpp"
+#include "../network/Network.hpp"
+
+using namespace SerialProtocol;
+
+// Initialize static member
+SerialLink* SerialLink::instance = nullptr;
+
+// Private constructor
+SerialLink::SerialLink() : initialized(false),
+                           txSeq(0),
+                           pendingMask(0),
+                           snapshotPending(false),
+                           telemetryPending(false),
+                           screenRequest(-1),
+                           decoder(onFrame, this) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+// Destructor
+SerialLink::~SerialLink() {
+    shutdown();
+}
+
+// Get singleton instance
+SerialLink& SerialLink::getInstance() {
+    if (instance == nullptr) {
+        instance = new SerialLink();
+    }
+    return *instance;
+}
+
+// Check if instance exists
+bool SerialLink::hasInstance() {
+    return instance != nullptr;
+}
+
+// Destroy the singleton instance
+void SerialLink::destroyInstance() {
+    if (instance != nullptr) {
+        delete instance;
+        instance = nullptr;
+    }
+}
+
+// Lifecycle
+void SerialLink::initialize() {
+    if (initialized) return;
+
+    // Hosts that attach later ask with CMD_REQUEST_SNAPSHOT
+    snapshotPending = true;
+    telemetryPending = false;
+    pendingMask = 0;
+    initialized = true;
+}
+
+void SerialLink::shutdown() {
+    initialized = false;
+}
+
+void SerialLink::update() {
+    if (!initialized) return;
+
+    receive();
+
+    if (snapshotPending) {
+        if (!sendSnapshot()) {
+            stats.txDeferred++;
+            return;
+        }
+        snapshotPending = false;
+        pendingMask = 0;  // The snapshot already carries every channel
+    }
+
+    if (pendingMask != 0) {
+        if (sendDelta()) {
+            pendingMask = 0;
+        } else {
+            stats.txDeferred++;
+        }
+    }
+
+    if (telemetryPending) {
+        if (sendTelemetry()) {
+            telemetryPending = false;
+        } else {
+            stats.txDeferred++;
+        }
+    }
+}
+
+// Outgoing state
+void SerialLink::markDirty(uint32_t channelMask) {
+    pendingMask |= channelMask;
+}
+
+void SerialLink::requestSnapshot() {
+    snapshotPending = true;
+}
+
+// Host requests
+int SerialLink::takeScreenRequest() {
+    return screenRequest.exchange(-1, std::memory_order_acq_rel);
+}
+
+// Stats
+const SerialLink::Stats& SerialLink::getStats() const {
+    return stats;
+}
+
+const FrameDecoder::Stats& SerialLink::getDecoderStats() const {
+    return decoder.getStats();
+}
+
+// Private methods
+
+void SerialLink::receive() {
+    size_t budget = MAX_RX_PER_UPDATE;
+    while (budget-- > 0 && Serial.available() > 0) {
+        decoder.feed((uint8_t)Serial.read());
+    }
+}
+
+bool SerialLink::sendSnapshot() {
+    Mixer& mixer = Mixer::getInstance();
+    uint8_t count = mixer.getChannelCount();
+
+    writer.begin(MSG_SNAPSHOT, txSeq);
+    writer.put(count);
+    for (uint8_t channel = 0; channel < count; channel++) {
+        ChannelState state;
+        fillState(channel, state);
+        writer.putState(state);
+    }
+    return sendFrame();
+}
+
+bool SerialLink::sendDelta() {
+    writer.begin(MSG_DELTA, txSeq);
+    writer.put(0);  // Patched with the real count below
+
+    uint8_t count = 0;
+    uint32_t mask = pendingMask;
+    while (mask) {
+        uint8_t channel = __builtin_ctz(mask);
+        mask &= mask - 1;
+
+        ChannelState state;
+        fillState(channel, state);
+        writer.put(channel);
+        writer.putState(state);
+        count++;
+    }
+    writer.patch(0, count);
+
+    if (!sendFrame()) return false;
+    stats.channelsSent += count;
+    return true;
+}
+
+bool SerialLink::sendAck(uint8_t commandSeq, uint8_t status) {
+    writer.begin(MSG_ACK, txSeq);
+    writer.put(commandSeq);
+    writer.put(status);
+    return sendFrame();
+}
+
+bool SerialLink::sendTelemetry() {
+    // A read that keeps racing the network task is retried on the next update()
+    Telemetry report;
+    if (!Network::getInstance().readTelemetryReport(report)) return false;
+
+    writer.begin(MSG_TELEMETRY, txSeq);
+    writer.putTelemetry(report);
+    return sendFrame();
+}
+
+bool SerialLink::sendFrame() {
+    size_t length = writer.finish(txBuffer, sizeof(txBuffer));
+    if (length == 0 || (size_t)Serial.availableForWrite() < length) return false;
+
+    Serial.write(txBuffer, length);
+    txSeq++;
+    stats.framesSent++;
+    stats.bytesSent += length;
+    return true;
+}
+
+uint8_t SerialLink::handleCommand(uint8_t type, const uint8_t* payload, size_t length) {
+    Mixer& mixer = Mixer::getInstance();
+
+    switch (type) {
+        case CMD_SET_TARGET:
+            if (length != 2) return ACK_BAD_LENGTH;
+            if (!mixer.isValidChannel(payload[0])) return ACK_BAD_CHANNEL;
+            mixer.setTarget(payload[0], payload[1]);
+            return ACK_OK;
+
+        case CMD_SET_MUTE:
+            if (length != 2) return ACK_BAD_LENGTH;
+            if (!mixer.isValidChannel(payload[0])) return ACK_BAD_CHANNEL;
+            mixer.setMuted(payload[0], payload[1] != 0);
+            return ACK_OK;
+
+        case CMD_REQUEST_SNAPSHOT:
+            if (length != 0) return ACK_BAD_LENGTH;
+            snapshotPending = true;
+            return ACK_OK;
+
+        case CMD_PING:
+            return length == 0 ? ACK_OK : ACK_BAD_LENGTH;
+
+        case CMD_SHOW_SCREEN:
+            if (length != 1) return ACK_BAD_LENGTH;
+            // The display job applies it; UI range-checks the number
+            screenRequest.store(payload[0], std::memory_order_release);
+            return ACK_OK;
+
+        case CMD_INPUT_LOG:
+            if (length != 1) return ACK_BAD_LENGTH;
+            return handleInputLog(payload[0]) ? ACK_OK : ACK_FAILED;
+
+        case CMD_GET_TELEMETRY:
+            if (length != 0) return ACK_BAD_LENGTH;
+            if (!Network::hasInstance()) return ACK_FAILED;
+            telemetryPending = true;
+            return ACK_OK;
+
+        default:
+            return ACK_UNKNOWN_COMMAND;
+    }
+}
+
+bool SerialLink::handleInputLog(uint8_t op) {
+    // Runs on the control task, between IO passes
+    InputLog& log = InputLog::getInstance();
+
+    switch (op) {
+        case INPUT_LOG_STOP:
+            log.stop();
+            return true;
+        case INPUT_LOG_RECORD:
+            return log.startRecording();
+        case INPUT_LOG_REPLAY:
+            return log.startReplay();
+        case INPUT_LOG_REPLAY_FAST:
+            return log.runReplayFast();
+        case INPUT_LOG_SAVE:
+            return log.save();
+        case INPUT_LOG_LOAD:
+            return log.load();
+        default:
+            return false;
+    }
+}
+
+void SerialLink::fillState(uint8_t channel, ChannelState& state) const {
+    Mixer& mixer = Mixer::getInstance();
+    state.target = (uint8_t)mixer.getTarget(channel);
+    state.current = (uint8_t)mixer.getCurrent(channel);
+    state.flags = mixer.isMuted(channel) ? FLAG_MUTED : 0;
+}
+
+void SerialLink::onFrame(uint8_t type, uint8_t seq, const uint8_t* payload, size_t length, void* context) {
+    SerialLink* link = static_cast<SerialLink*>(context);
+
+    uint8_t status = link->handleCommand(type, payload, length);
+    if (status == ACK_OK) {
+        link->stats.commandsHandled++;
+    } else {
+        link->stats.commandsRejected++;
+    }
+
+    // Acks are best effort; the host retries on timeout
+    link->sendAck(seq, status);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include "SerialProtocol.hpp"
+
+// Device end of the binary serial protocol (see SerialProtocol.hpp).
+//
+// Mixer changes are queued with markDirty() and leave as at most one
+// MSG_DELTA frame per update(), so bursts of encoder steps are batched.
+// update() also drains the RX buffer and applies host commands to the Mixer.
+// CMD_GET_TELEMETRY is answered with the report Network publishes from the
+// network task, so the link never reads the live history across tasks.
+// Frames are only written when the UART has room for the whole frame. If it
+// does not, the dirty channels stay queued for the next update() and the
+// loop never blocks on the port.
+class SerialLink {
+   private:
+    // Private constructor to prevent direct instantiation
+    SerialLink();
+
+    // Static instance pointer
+    static SerialLink* instance;
+
+    // Delete copy constructor and assignment operator
+    SerialLink(const SerialLink&) = delete;
+    SerialLink& operator=(const SerialLink&) = delete;
+
+   public:
+    static const size_t MAX_RX_PER_UPDATE = 64;  // Bytes consumed per update() to bound its run time
+
+    struct Stats {
+        uint32_t framesSent;
+        uint32_t bytesSent;
+        uint32_t channelsSent;     // Channel entries carried by delta frames
+        uint32_t txDeferred;       // update() calls that found the UART too full
+        uint32_t commandsHandled;
+        uint32_t commandsRejected; // Acked with a non-OK status
+    };
+
+    // Public destructor
+    ~SerialLink();
+
+    // Static method to get the singleton instance
+    static SerialLink& getInstance();
+
+    // Static method to check if instance exists
+    static bool hasInstance();
+
+    // Static method to destroy the instance
+    static void destroyInstance();
+
+    // Lifecycle
+    void initialize();
+    void shutdown();
+    void update();
+
+    // Outgoing state
+    void markDirty(uint32_t channelMask);
+    void requestSnapshot();
+
+    // Host requests
+    // Screen the host asked for with CMD_SHOW_SCREEN, -1 if none since the last call (callable from the UI task)
+    int takeScreenRequest();
+
+    // Stats
+    const Stats& getStats() const;
+    const SerialProtocol::FrameDecoder::Stats& getDecoderStats() const;
+
+   private:
+    bool initialized;
+    uint8_t txSeq;
+    uint32_t pendingMask;
+    bool snapshotPending;
+    bool telemetryPending;
+    std::atomic<int> screenRequest;
+
+    SerialProtocol::FrameDecoder decoder;
+    SerialProtocol::FrameWriter writer;
+    uint8_t txBuffer[SerialProtocol::MAX_ENCODED];
+
+    Stats stats;
+
+    // Internal methods
+    void receive();
+    bool sendSnapshot();
+    bool sendDelta();
+    bool sendAck(uint8_t commandSeq, uint8_t status);
+    bool sendTelemetry();
+    bool sendFrame();
+    uint8_t handleCommand(uint8_t type, const uint8_t* payload, size_t length);
+    bool handleInputLog(uint8_t op);
+    void fillState(uint8_t channel, SerialProtocol::ChannelState& state) const;
+
+    static void onFrame(uint8_t type, uint8_t seq, const uint8_t* payload, size_t length, void* context);
+};
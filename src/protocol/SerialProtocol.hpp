@@ -0,0 +1,345 @@
+#pragma once
+
+// Binary framing shared by the firmware and PC host tools.
+//
+// This header has no Arduino dependencies. A host decoder only needs this
+// file and a byte stream from the serial port; HostDecoder.hpp builds the
+// PC end of the protocol on top of it.
+//
+// Wire format, one message per frame:
+//
+//   0x00  COBS( type:u8  seq:u8  payload[0..MAX_PAYLOAD]  crc16:u16le )  0x00
+//
+// The CRC is CRC-16/CCITT-FALSE over type, seq and payload. COBS removes
+// every zero byte from the encoded frame, so 0x00 only ever marks a frame
+// boundary. Frames are sent with a delimiter on both sides, so plain-text log
+// lines written between frames never corrupt the next frame. Those lines are
+// counted as bad frames. Empty frames between delimiters are ignored.
+//
+// Device -> host:
+//   MSG_SNAPSHOT  count:u8, then count x ChannelState (channels 0..count-1)
+//   MSG_DELTA     count:u8, then count x { channel:u8, ChannelState }
+//   MSG_ACK       commandSeq:u8, status:u8
+//   MSG_TELEMETRY Telemetry (below), in answer to CMD_GET_TELEMETRY
+//
+// Host -> device (each is answered with MSG_ACK carrying the command's seq):
+//   CMD_SET_TARGET        channel:u8, level:u8
+//   CMD_SET_MUTE          channel:u8, muted:u8
+//   CMD_REQUEST_SNAPSHOT  (empty, a MSG_SNAPSHOT follows the ack)
+//   CMD_PING              (empty)
+//   CMD_SHOW_SCREEN       screen:u8 (e.g. 8 = performance)
+//   CMD_INPUT_LOG         op:u8 (InputLogOp: record, stop, replay, save, load)
+//   CMD_GET_TELEMETRY     (empty, a MSG_TELEMETRY follows the ack)
+//
+// ChannelState is { target:u8, current:u8, flags:u8 }, flags bit 0 = muted.
+//
+// Telemetry is the WiFi link history kept by Network: three summaries
+// { count:u8, min:i32le, max:i32le, mean:i32le } for RSSI samples (dBm),
+// connect attempts (ms) and finished sessions (s), then failedAttempts:u8,
+// lastResult:u8 (wl_status_t of the newest attempt, TELEMETRY_NO_RESULT if
+// none) and TELEMETRY_RSSI_BINS x u8, an RSSI histogram over
+// [TELEMETRY_RSSI_MIN, TELEMETRY_RSSI_MAX) dBm.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace SerialProtocol {
+
+static const uint8_t MAX_CHANNELS = 16;
+static const size_t CHANNEL_STATE_SIZE = 3;
+static const size_t MAX_PAYLOAD = 1 + MAX_CHANNELS * (1 + CHANNEL_STATE_SIZE);
+static const size_t MAX_FRAME = 2 + MAX_PAYLOAD + 2;              // type, seq, payload, crc
+static const size_t MAX_ENCODED = MAX_FRAME + MAX_FRAME / 254 + 3;  // COBS overhead plus both delimiters
+
+static const uint8_t FLAG_MUTED = 0x01;
+
+static const uint8_t TELEMETRY_RSSI_BINS = 16;
+static const int32_t TELEMETRY_RSSI_MIN = -100;
+static const int32_t TELEMETRY_RSSI_MAX = -30;
+static const uint8_t TELEMETRY_NO_RESULT = 0xFF;
+static const size_t SUMMARY_SIZE = 1 + 3 * 4;
+static const size_t TELEMETRY_SIZE = 3 * SUMMARY_SIZE + 2 + TELEMETRY_RSSI_BINS;
+static_assert(TELEMETRY_SIZE <= MAX_PAYLOAD, "Telemetry must fit one frame");
+
+enum MessageType : uint8_t {
+    MSG_SNAPSHOT = 0x01,
+    MSG_DELTA = 0x02,
+    MSG_ACK = 0x03,
+    MSG_TELEMETRY = 0x04,
+
+    CMD_SET_TARGET = 0x10,
+    CMD_SET_MUTE = 0x11,
+    CMD_REQUEST_SNAPSHOT = 0x12,
+    CMD_PING = 0x13,
+    CMD_SHOW_SCREEN = 0x14,
+    CMD_INPUT_LOG = 0x15,
+    CMD_GET_TELEMETRY = 0x16
+};
+
+enum AckStatus : uint8_t {
+    ACK_OK = 0x00,
+    ACK_UNKNOWN_COMMAND = 0x01,
+    ACK_BAD_LENGTH = 0x02,
+    ACK_BAD_CHANNEL = 0x03,
+    ACK_FAILED = 0x04
+};
+
+enum InputLogOp : uint8_t {
+    INPUT_LOG_STOP = 0x00,
+    INPUT_LOG_RECORD = 0x01,
+    INPUT_LOG_REPLAY = 0x02,       // Real time
+    INPUT_LOG_REPLAY_FAST = 0x03,  // As fast as possible; the ack follows the whole replay
+    INPUT_LOG_SAVE = 0x04,         // To NVS
+    INPUT_LOG_LOAD = 0x05
+};
+
+struct ChannelState {
+    uint8_t target;
+    uint8_t current;
+    uint8_t flags;
+};
+
+struct SeriesSummary {
+    uint8_t count;
+    int32_t min;
+    int32_t max;
+    int32_t mean;
+};
+
+struct Telemetry {
+    SeriesSummary rssi;      // dBm per sample
+    SeriesSummary connect;   // ms per connect attempt
+    SeriesSummary sessions;  // s per finished session
+    uint8_t failedAttempts;
+    uint8_t lastResult;
+    uint8_t rssiBins[TELEMETRY_RSSI_BINS];
+};
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+inline uint16_t crc16(const uint8_t* data, size_t length, uint16_t crc = 0xFFFF) {
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// COBS encode without the trailing delimiter. Returns the encoded length, 0 if out is too small.
+inline size_t cobsEncode(const uint8_t* in, size_t length, uint8_t* out, size_t capacity) {
+    if (capacity < length + length / 254 + 1) return 0;
+
+    size_t write = 1;
+    size_t codeIndex = 0;
+    uint8_t code = 1;
+
+    for (size_t read = 0; read < length; read++) {
+        if (in[read] == 0) {
+            out[codeIndex] = code;
+            codeIndex = write++;
+            code = 1;
+        } else {
+            out[write++] = in[read];
+            if (++code == 0xFF) {
+                out[codeIndex] = code;
+                codeIndex = write++;
+                code = 1;
+            }
+        }
+    }
+    out[codeIndex] = code;
+    return write;
+}
+
+// COBS decode of one frame (delimiter already stripped). Returns the decoded length, 0 on malformed input.
+inline size_t cobsDecode(const uint8_t* in, size_t length, uint8_t* out, size_t capacity) {
+    size_t read = 0;
+    size_t write = 0;
+
+    while (read < length) {
+        uint8_t code = in[read++];
+        if (code == 0 || read + code - 1 > length) return 0;
+
+        for (uint8_t i = 1; i < code; i++) {
+            if (write >= capacity) return 0;
+            out[write++] = in[read++];
+        }
+        if (code != 0xFF && read < length) {
+            if (write >= capacity) return 0;
+            out[write++] = 0;
+        }
+    }
+    return write;
+}
+
+inline int32_t readI32(const uint8_t* data) {
+    return (int32_t)((uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24));
+}
+
+// Parse a MSG_TELEMETRY payload. Returns false if the length is wrong.
+inline bool parseTelemetry(const uint8_t* payload, size_t length, Telemetry& telemetry) {
+    if (length != TELEMETRY_SIZE) return false;
+
+    SeriesSummary* summaries[3] = {&telemetry.rssi, &telemetry.connect, &telemetry.sessions};
+    for (SeriesSummary* summary : summaries) {
+        summary->count = payload[0];
+        summary->min = readI32(payload + 1);
+        summary->max = readI32(payload + 5);
+        summary->mean = readI32(payload + 9);
+        payload += SUMMARY_SIZE;
+    }
+    telemetry.failedAttempts = payload[0];
+    telemetry.lastResult = payload[1];
+    memcpy(telemetry.rssiBins, payload + 2, TELEMETRY_RSSI_BINS);
+    return true;
+}
+
+// Builds one message and encodes it into a wire-ready buffer
+class FrameWriter {
+   public:
+    FrameWriter() : length(0) {}
+
+    void begin(uint8_t type, uint8_t seq) {
+        raw[0] = type;
+        raw[1] = seq;
+        length = 2;
+    }
+
+    bool put(uint8_t value) {
+        if (length >= 2 + MAX_PAYLOAD) return false;
+        raw[length++] = value;
+        return true;
+    }
+
+    bool putState(const ChannelState& state) {
+        return put(state.target) && put(state.current) && put(state.flags);
+    }
+
+    bool put32(uint32_t value) {
+        return put(value & 0xFF) && put((value >> 8) & 0xFF) && put((value >> 16) & 0xFF) && put(value >> 24);
+    }
+
+    bool putSummary(const SeriesSummary& summary) {
+        return put(summary.count) && put32((uint32_t)summary.min) && put32((uint32_t)summary.max) &&
+               put32((uint32_t)summary.mean);
+    }
+
+    bool putTelemetry(const Telemetry& telemetry) {
+        if (!putSummary(telemetry.rssi) || !putSummary(telemetry.connect) || !putSummary(telemetry.sessions) ||
+            !put(telemetry.failedAttempts) || !put(telemetry.lastResult)) {
+            return false;
+        }
+        for (uint8_t i = 0; i < TELEMETRY_RSSI_BINS; i++) {
+            if (!put(telemetry.rssiBins[i])) return false;
+        }
+        return true;
+    }
+
+    // Overwrite a payload byte already written (e.g. a count known only at the end)
+    void patch(size_t payloadOffset, uint8_t value) {
+        if (2 + payloadOffset < length) raw[2 + payloadOffset] = value;
+    }
+
+    // Appends the CRC, COBS-encodes and delimits. Returns the number of bytes in out.
+    size_t finish(uint8_t* out, size_t capacity) {
+        uint16_t crc = crc16(raw, length);
+        raw[length] = (uint8_t)(crc & 0xFF);
+        raw[length + 1] = (uint8_t)(crc >> 8);
+
+        if (capacity < 2) return 0;
+        size_t encoded = cobsEncode(raw, length + 2, out + 1, capacity - 2);
+        if (encoded == 0) return 0;
+        out[0] = 0;
+        out[encoded + 1] = 0;
+        return encoded + 2;
+    }
+
+   private:
+    uint8_t raw[MAX_FRAME];
+    size_t length;
+};
+
+// Incremental decoder: feed() bytes as they arrive and it calls the handler once per valid frame
+class FrameDecoder {
+   public:
+    typedef void (*FrameHandler)(uint8_t type, uint8_t seq, const uint8_t* payload, size_t length, void* context);
+
+    struct Stats {
+        uint32_t frames;     // Valid frames delivered
+        uint32_t crcErrors;  // Decoded but failed the CRC
+        uint32_t badFrames;  // Malformed COBS, too short or too long
+    };
+
+    FrameDecoder(FrameHandler handler = nullptr, void* context = nullptr)
+        : handler(handler), context(context), length(0), overflow(false) {
+        memset(&stats, 0, sizeof(stats));
+    }
+
+    void setHandler(FrameHandler newHandler, void* newContext) {
+        handler = newHandler;
+        context = newContext;
+    }
+
+    void feed(uint8_t byte) {
+        if (byte != 0) {
+            if (length < sizeof(encoded)) {
+                encoded[length++] = byte;
+            } else {
+                overflow = true;
+            }
+            return;
+        }
+
+        // Delimiter: decode what we collected (empty frames are just back-to-back delimiters)
+        if (length > 0 || overflow) {
+            processFrame();
+        }
+        length = 0;
+        overflow = false;
+    }
+
+    void feed(const uint8_t* data, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            feed(data[i]);
+        }
+    }
+
+    const Stats& getStats() const { return stats; }
+
+   private:
+    FrameHandler handler;
+    void* context;
+    uint8_t encoded[MAX_ENCODED];
+    uint8_t decoded[MAX_FRAME];
+    size_t length;
+    bool overflow;
+    Stats stats;
+
+    void processFrame() {
+        if (overflow) {
+            stats.badFrames++;
+            return;
+        }
+
+        size_t size = cobsDecode(encoded, length, decoded, sizeof(decoded));
+        if (size < 4) {
+            stats.badFrames++;
+            return;
+        }
+
+        uint16_t expected = (uint16_t)decoded[size - 2] | ((uint16_t)decoded[size - 1] << 8);
+        if (crc16(decoded, size - 2) != expected) {
+            stats.crcErrors++;
+            return;
+        }
+
+        stats.frames++;
+        if (handler) {
+            handler(decoded[0], decoded[1], decoded + 2, size - 4, context);
+        }
+    }
+};
+
+}  // namespace SerialProtocol
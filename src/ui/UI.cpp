@@ -1,11 +1,12 @@
 #include "UI.hpp"
+#include "../core/PerfCounters.hpp"
 #include "../network/network.hpp"
 
 // Initialize static member
 UI* UI::instance = nullptr;
 
 // Private constructor
-UI::UI() : display(nullptr), initialized(false), currentScreen(SCREEN_HELLO_WORLD), currentRotation(1) {
+UI::UI() : display(nullptr), initialized(false), currentScreen(SCREEN_HELLO_WORLD), currentRotation(1), progressValue(50) {
     // Initialize the e-paper display
     display = new GxEPD2_BW<GxEPD2_290_BS, GxEPD2_290_BS::HEIGHT>(
         GxEPD2_290_BS(/*CS=5*/ 5, /*DC=*/0, /*RES=*/2, /*BUSY=*/15));
@@ -293,6 +294,9 @@ void UI::updateScreen() {
         case SCREEN_PROGRESS_BAR:
             showProgressBarScreen();
             break;
+        case SCREEN_PERFORMANCE:
+            showPerformanceScreen();
+            break;
         default:
             showMainMenu();
             break;
@@ -524,6 +528,9 @@ void UI::showNetworkScreen() {
 
         // Display detailed network status
         displayNetworkStatus(0, display->height() / 4, false);
+
+        // RSSI history along the bottom edge
+        drawRSSISparkline(5, display->height() - 17, display->width() - 10, 14);
     } while (display->nextPage());
 
     currentScreen = SCREEN_NETWORK;
@@ -583,6 +590,37 @@ void UI::displayNetworkStatus(uint16_t x, uint16_t y, bool compact) {
     }
 }
 
+void UI::drawRSSISparkline(uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
+    if (!display || width < 2 || height < 2) return;
+
+    // The network task owns the live history; draw from its published copy
+    Network::RSSIHistory history;
+    if (!Network::hasInstance() || !Network::getInstance().readRSSIHistory(history)) return;
+    size_t count = history.count;
+    if (count < 2) return;
+
+    // Map -100..-30 dBm onto the strip, oldest sample on the left
+    const int minRSSI = -100;
+    const int maxRSSI = -30;
+
+    int16_t lastX = 0;
+    int16_t lastY = 0;
+    for (size_t i = 0; i < count; i++) {
+        int rssi = history.samples[i];
+        if (rssi < minRSSI) rssi = minRSSI;
+        if (rssi > maxRSSI) rssi = maxRSSI;
+
+        int16_t px = x + (int32_t)i * (width - 1) / (count - 1);
+        int16_t py = y + (height - 1) - (int32_t)(rssi - minRSSI) * (height - 1) / (maxRSSI - minRSSI);
+
+        if (i > 0) {
+            display->drawLine(lastX, lastY, px, py, GxEPD_BLACK);
+        }
+        lastX = px;
+        lastY = py;
+    }
+}
+
 void UI::showProgressBarScreen() {
     if (!initialized || !display) return;
 
@@ -591,6 +629,7 @@ void UI::showProgressBarScreen() {
     display->setTextColor(GxEPD_BLACK);
     display->setFullWindow();
 
+    unsigned long start = millis();
     display->firstPage();
     do {
         display->fillScreen(GxEPD_WHITE);
@@ -607,15 +646,19 @@ void UI::showProgressBarScreen() {
         display->setFont(&FreeMonoBold9pt7b);  // Restore main font
         displayTextCenteredAt("Progress:", display->height() / 2);
 
-        // Draw initial progress bar at 50%
+        // Draw the current (possibly restored) value so no follow-up refresh is needed
         uint16_t barWidth = display->width() - 40;
         uint16_t barHeight = 30;
         uint16_t barX = (display->width() - barWidth) / 2;
         uint16_t barY = display->height() * 5 / 8;
 
-        drawProgressBar(50, barX, barY, barWidth, barHeight);
+        drawProgressBar(progressValue, barX, barY, barWidth, barHeight);
+
+        String valueStr = String(progressValue) + "%";
+        displayTextCenteredAt(valueStr.c_str(), barY + barHeight + 25);
 
     } while (display->nextPage());
+    PerfCounters::getInstance().recordRefresh(true, millis() - start);
 
     currentScreen = SCREEN_PROGRESS_BAR;
 }
@@ -623,6 +666,8 @@ void UI::showProgressBarScreen() {
 void UI::updateProgressBar(int value, bool forceFullUpdate) {
     if (!initialized || !display || currentScreen != SCREEN_PROGRESS_BAR) return;
 
+    progressValue = value;
+
     // Progress bar dimensions
     uint16_t barWidth = display->width() - 40;
     uint16_t barHeight = 30;
@@ -632,6 +677,7 @@ void UI::updateProgressBar(int value, bool forceFullUpdate) {
     // Value text area
     uint16_t valueY = barY + barHeight + 25;
 
+    unsigned long start = millis();
     if (forceFullUpdate) {
         // Full screen update
         display->setFullWindow();
@@ -683,6 +729,15 @@ void UI::updateProgressBar(int value, bool forceFullUpdate) {
 
         } while (display->nextPage());
     }
+    PerfCounters::getInstance().recordRefresh(forceFullUpdate, millis() - start);
+}
+
+void UI::setProgressValue(int value) {
+    progressValue = value;
+}
+
+int UI::getProgressValue() const {
+    return progressValue;
 }
 
 void UI::drawProgressBar(int value, uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
@@ -708,3 +763,119 @@ void UI::drawProgressBar(int value, uint16_t x, uint16_t y, uint16_t width, uint
         display->fillRect(x + 2 + fillWidth, y + 2, width - 4 - fillWidth, height - 4, GxEPD_WHITE);
     }
 }
+
+void UI::showPerformanceScreen() {
+    if (!initialized || !display) return;
+
+    // Partial window over the whole panel, so even entering the screen avoids the full-refresh flash
+    display->setRotation(currentRotation);
+    display->setPartialWindow(0, 0, display->width(), display->height());
+    display->setTextColor(GxEPD_BLACK);
+
+    unsigned long start = millis();
+    display->firstPage();
+    do {
+        display->fillScreen(GxEPD_WHITE);
+
+        display->setFont(&FreeMonoBold9pt7b);
+        displayTextCenteredAt("PERFORMANCE", PERF_TITLE_HEIGHT - 6);
+        display->drawLine(0, PERF_TITLE_HEIGHT, display->width(), PERF_TITLE_HEIGHT, GxEPD_BLACK);
+
+        drawPerformanceMetrics(PERF_TITLE_HEIGHT + 2);
+    } while (display->nextPage());
+    PerfCounters::getInstance().recordRefresh(false, millis() - start);
+
+    currentScreen = SCREEN_PERFORMANCE;
+}
+
+void UI::updatePerformanceScreen() {
+    if (!initialized || !display || currentScreen != SCREEN_PERFORMANCE) return;
+
+    // The title stays; only the metrics below it are redrawn
+    uint16_t areaY = PERF_TITLE_HEIGHT + 2;
+    uint16_t areaH = display->height() - areaY;
+
+    display->setPartialWindow(0, areaY, display->width(), areaH);
+
+    unsigned long start = millis();
+    display->firstPage();
+    do {
+        display->fillRect(0, areaY, display->width(), areaH, GxEPD_WHITE);
+        drawPerformanceMetrics(areaY);
+    } while (display->nextPage());
+    PerfCounters::getInstance().recordRefresh(false, millis() - start);
+}
+
+void UI::drawPerformanceMetrics(uint16_t y) {
+    PerfCounters::Snapshot perf;
+    PerfCounters::getInstance().getSnapshot(perf);
+
+    char line[48];
+    uint16_t lineHeight = 10;
+    uint16_t textX = 4;
+    uint16_t textY = y + 3;
+
+    display->setFont(0);  // 6x8 font so every metric fits beside the histogram
+    display->setTextColor(GxEPD_BLACK);
+
+    snprintf(line, sizeof(line), "IO  %lu/%lu/%lu us", (unsigned long)perf.ioUpdateLast,
+             (unsigned long)perf.ioUpdateAvg, (unsigned long)perf.ioUpdateMax);
+    displayText(line, textX, textY);
+    textY += lineHeight;
+
+    snprintf(line, sizeof(line), "EPD part %lu full %lu ms", (unsigned long)perf.partialRefreshMs,
+             (unsigned long)perf.fullRefreshMs);
+    displayText(line, textX, textY);
+    textY += lineHeight;
+
+    snprintf(line, sizeof(line), "Heap %lu blk %lu", (unsigned long)perf.freeHeap,
+             (unsigned long)perf.largestFreeBlock);
+    displayText(line, textX, textY);
+    textY += lineHeight;
+
+    snprintf(line, sizeof(line), "WiFi retry %lu fail %lu/%lu", (unsigned long)perf.wifiReconnects,
+             (unsigned long)perf.wifiFailedConnects, (unsigned long)perf.wifiConnectAttempts);
+    displayText(line, textX, textY);
+    textY += lineHeight;
+
+    // Stack high-water marks, two tasks per line
+    for (uint8_t i = 0; i < perf.taskCount; i += 2) {
+        if (i + 1 < perf.taskCount) {
+            snprintf(line, sizeof(line), "Stk %s %lu %s %lu", perf.tasks[i].name, (unsigned long)perf.tasks[i].highWaterMark,
+                     perf.tasks[i + 1].name, (unsigned long)perf.tasks[i + 1].highWaterMark);
+        } else {
+            snprintf(line, sizeof(line), "Stk %s %lu", perf.tasks[i].name, (unsigned long)perf.tasks[i].highWaterMark);
+        }
+        displayText(line, textX, textY);
+        textY += lineHeight;
+    }
+
+    // Loop period histogram on the right
+    uint16_t histWidth = PerfCounters::LOOP_BINS * 10;
+    uint16_t histX = display->width() - histWidth - 4;
+    uint16_t histY = y + 14;
+    uint16_t histHeight = display->height() - histY - 12;
+
+    displayText("loop ms", histX, y + 3);
+    drawLoopHistogram(perf.loopHistogram, histX, histY, histWidth, histHeight);
+    displayText("<1", histX, histY + histHeight + 3);
+    displayText(">100", histX + histWidth - 24, histY + histHeight + 3);
+}
+
+void UI::drawLoopHistogram(const uint32_t* bins, uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
+    uint32_t peak = 0;
+    for (uint8_t i = 0; i < PerfCounters::LOOP_BINS; i++) {
+        if (bins[i] > peak) peak = bins[i];
+    }
+
+    display->drawLine(x, y + height - 1, x + width - 1, y + height - 1, GxEPD_BLACK);
+    if (peak == 0) return;
+
+    uint16_t barWidth = width / PerfCounters::LOOP_BINS;
+    for (uint8_t i = 0; i < PerfCounters::LOOP_BINS; i++) {
+        // Any non-empty bin gets at least one pixel so rare slow loops stay visible
+        uint16_t barHeight = (uint16_t)((uint64_t)bins[i] * (height - 1) / peak);
+        if (bins[i] > 0 && barHeight == 0) barHeight = 1;
+        display->fillRect(x + i * barWidth + 1, y + height - 1 - barHeight, barWidth - 2, barHeight, GxEPD_BLACK);
+    }
+}
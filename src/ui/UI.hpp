@@ -47,10 +47,16 @@ class UI {
     void showStatusScreen();
     void showNetworkScreen();
     void showProgressBarScreen();
+    void showPerformanceScreen();
 
     // Progress bar specific methods
     void updateProgressBar(int value, bool forceFullUpdate = false);
     void drawProgressBar(int value, uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+    void setProgressValue(int value);  // Value drawn by showProgressBarScreen(), set before it is shown
+    int getProgressValue() const;
+
+    // Performance screen: redraws only the metrics area, never a full refresh
+    void updatePerformanceScreen();
 
     // Display utility methods
     void setRotation(uint16_t rotation);
@@ -63,6 +69,7 @@ class UI {
     void displayTextCenteredAt(const char* text, uint16_t y);
     void displayNetworkStatus(uint16_t x, uint16_t y, bool compact = false);
     void displayNetworkIndicator();
+    void drawRSSISparkline(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
 
     // Screen navigation
     void nextScreen();
@@ -84,6 +91,7 @@ class UI {
     bool initialized;
     int currentScreen;
     uint16_t currentRotation;
+    int progressValue;  // Value currently on the progress bar
 
     // Screen constants
     static const int SCREEN_HELLO_WORLD = 0;
@@ -94,7 +102,9 @@ class UI {
     static const int SCREEN_STATUS = 5;
     static const int SCREEN_NETWORK = 6;
     static const int SCREEN_PROGRESS_BAR = 7;
-    static const int MAX_SCREENS = 8;
+    static const int SCREEN_PERFORMANCE = 8;
+    static const int MAX_SCREENS = 9;
+    static const uint16_t PERF_TITLE_HEIGHT = 18;  // Static part of the performance screen
 
     // Internal methods
     void setupDisplay();
@@ -107,4 +117,8 @@ class UI {
     // Partial update demo helpers
     void showPartialUpdateBox();
     void animatePartialUpdates();
+
+    // Performance screen helpers
+    void drawPerformanceMetrics(uint16_t y);
+    void drawLoopHistogram(const uint32_t* bins, uint16_t x, uint16_t y, uint16_t width, uint16_t height);
 };
\ No newline at end of file
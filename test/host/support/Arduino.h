@@ -0,0 +1,180 @@
+#pragma once
+
+// Host stand-in for the parts of the Arduino core the firmware modules use.
+//
+// Time does not pass on its own: tests move it with host::advanceMicros()
+// or host::setMillis(), so debounce windows and deadlines are exact. Pin
+// levels are plain arrays a test sets before calling into a device.
+// Everything is inline so a test links only the modules it exercises.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+using std::max;
+using std::min;
+
+typedef uint8_t byte;
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define INPUT_PULLDOWN 0x09
+#define OUTPUT_OPEN_DRAIN 0x13
+#define HIGH 0x1
+#define LOW 0x0
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+#define IRAM_ATTR
+
+namespace host {
+const int PIN_COUNT = 40;
+
+inline std::atomic<uint64_t>& clock() {
+    static std::atomic<uint64_t> micros(0);
+    return micros;
+}
+
+inline void advanceMicros(uint64_t us) { clock() += us; }
+inline void advanceMillis(uint64_t ms) { clock() += ms * 1000; }
+inline void setMillis(uint64_t ms) { clock() = ms * 1000; }
+
+inline int* pinLevels() {
+    static int levels[PIN_COUNT] = {};
+    return levels;
+}
+
+inline void setPin(int pin, int level) {
+    if (pin >= 0 && pin < PIN_COUNT) pinLevels()[pin] = level;
+}
+}
+
+inline unsigned long millis() { return (unsigned long)(host::clock() / 1000); }
+inline unsigned long micros() { return (unsigned long)host::clock(); }
+inline void delay(unsigned long ms) { host::advanceMillis(ms); }
+inline void delayMicroseconds(unsigned int us) { host::advanceMicros(us); }
+inline void yield() {}
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t pin) { return pin < host::PIN_COUNT ? host::pinLevels()[pin] : LOW; }
+inline void digitalWrite(uint8_t pin, uint8_t level) { host::setPin(pin, level); }
+inline uint16_t analogRead(uint8_t) { return 0; }
+inline int8_t digitalPinToAnalogChannel(uint8_t pin) { return pin >= 32 && pin <= 39 ? pin - 32 : -1; }
+inline uint32_t getCpuFrequencyMhz() { return 240; }
+inline void attachInterruptArg(uint8_t, void (*)(void*), void*, int) {}
+inline void detachInterrupt(uint8_t) {}
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// Spinlock standing in for the ESP32 cross-core critical section
+struct portMUX_TYPE {
+    std::atomic_flag flag = ATOMIC_FLAG_INIT;
+};
+#define portMUX_INITIALIZER_UNLOCKED {}
+inline void portENTER_CRITICAL(portMUX_TYPE* mux) {
+    while (mux->flag.test_and_set(std::memory_order_acquire)) {
+    }
+}
+inline void portEXIT_CRITICAL(portMUX_TYPE* mux) { mux->flag.clear(std::memory_order_release); }
+#define portENTER_CRITICAL_ISR(mux) portENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL_ISR(mux) portEXIT_CRITICAL(mux)
+
+class String {
+   public:
+    String(const char* text = "") : value(text ? text : "") {}
+    String(const std::string& text) : value(text) {}
+    String(int number) : value(std::to_string(number)) {}
+    String(unsigned int number) : value(std::to_string(number)) {}
+    String(long number) : value(std::to_string(number)) {}
+    String(unsigned long number) : value(std::to_string(number)) {}
+
+    const char* c_str() const { return value.c_str(); }
+    unsigned int length() const { return (unsigned int)value.size(); }
+
+    bool operator==(const String& other) const { return value == other.value; }
+    bool operator!=(const String& other) const { return value != other.value; }
+    bool operator<(const String& other) const { return value < other.value; }
+    String operator+(const String& other) const { return String(value + other.value); }
+    String& operator+=(const String& other) {
+        value += other.value;
+        return *this;
+    }
+
+   private:
+    std::string value;
+};
+
+class Print {
+   public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t byte) = 0;
+    virtual size_t write(const uint8_t* data, size_t size) {
+        size_t written = 0;
+        while (written < size && write(data[written])) written++;
+        return written;
+    }
+
+    size_t printf(const char* format, ...) {
+        char line[256];
+        va_list args;
+        va_start(args, format);
+        int length = vsnprintf(line, sizeof(line), format, args);
+        va_end(args);
+        if (length < 0) return 0;
+        return write((const uint8_t*)line, std::min((size_t)length, sizeof(line) - 1));
+    }
+    size_t print(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+    size_t print(const String& text) { return print(text.c_str()); }
+    size_t print(long number) { return printf("%ld", number); }
+    size_t println(const char* text = "") { return print(text) + print("\n"); }
+    size_t println(const String& text) { return println(text.c_str()); }
+};
+
+class Stream : public Print {
+   public:
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+};
+
+// Serial output goes to stdout
+class HardwareSerial : public Stream {
+   public:
+    size_t write(uint8_t byte) override { return fputc(byte, stdout) == EOF ? 0 : 1; }
+    using Print::write;
+    void begin(unsigned long) {}
+    void flush() { fflush(stdout); }
+};
+
+inline HardwareSerial& hostSerial() {
+    static HardwareSerial serial;
+    return serial;
+}
+#define Serial hostSerial()
+
+struct EspClass {
+    uint32_t getCycleCount() { return (uint32_t)(host::clock() * 240); }
+    uint64_t getEfuseMac() { return 0x0000A1B2C3D4E5F6ULL; }
+};
+inline EspClass ESP;
+
+// The ESP32 toolchain's newlib has strlcpy; glibc only since 2.38
+#if defined(__GLIBC__) && (__GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38))
+inline size_t strlcpy(char* destination, const char* source, size_t size) {
+    size_t length = strlen(source);
+    if (size > 0) {
+        size_t count = length < size - 1 ? length : size - 1;
+        memcpy(destination, source, count);
+        destination[count] = '\0';
+    }
+    return length;
+}
+#endif
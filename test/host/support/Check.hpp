@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdio.h>
+
+// Minimal assertions for the host test programs: a failed CHECK prints its
+// location and marks the run failed, and TEST_RESULT() turns that into the
+// exit status make sees.
+namespace check {
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+}
+
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        if (!(condition)) {                                                           \
+            printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition);     \
+            check::failures()++;                                                      \
+        }                                                                             \
+    } while (0)
+
+#define CHECK_EQUAL(expected, actual)                                                             \
+    do {                                                                                          \
+        long long expectedValue = (long long)(expected);                                          \
+        long long actualValue = (long long)(actual);                                              \
+        if (expectedValue != actualValue) {                                                       \
+            printf("%s:%d: CHECK_EQUAL failed: %s is %lld, expected %lld\n", __FILE__, __LINE__, \
+                   #actual, actualValue, expectedValue);                                          \
+            check::failures()++;                                                                  \
+        }                                                                                         \
+    } while (0)
+
+#define TEST_RESULT(name)                                                  \
+    (check::failures() ? (printf("%s: %d check(s) FAILED\n", name, check::failures()), 1) \
+                       : (printf("%s: OK\n", name), 0))
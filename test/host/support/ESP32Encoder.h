@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+
+// Host stand-in for the PCNT encoder library; tests move the count directly
+enum class puType { up, down, none };
+
+class ESP32Encoder {
+   public:
+    static inline puType useInternalWeakPullResistors = puType::up;
+
+    void attachFullQuad(int, int) {}
+    void attachHalfQuad(int, int) {}
+    void attachSingleEdge(int, int) {}
+    void setFilter(uint16_t) {}
+    void detach() {}
+
+    int64_t getCount() { return count; }
+    int64_t clearCount() { return count = 0; }
+    int64_t setCount(int64_t value) { return count = value; }
+
+    int64_t count = 0;
+};
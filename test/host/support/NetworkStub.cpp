@@ -0,0 +1,70 @@
+// Host builds have no radio. Until a test calls Network::getInstance() there
+// is no instance, so PowerManager and IO see no network; the instance that
+// call creates reports a fixed, connected link for the network servers.
+#include "network/Network.hpp"
+
+Network* Network::instance = nullptr;
+
+Network::Network() : initialized(true),
+                     status(NetworkStatus::CONNECTED),
+                     reconnectAttempts(0),
+                     powerSaveActive(false),
+                     publishedStatus(NetworkStatus::CONNECTED),
+                     publishedPowerSave(false),
+                     wifiSSID("host-lan"),
+                     eventCallback(nullptr) {
+}
+
+Network& Network::getInstance() {
+    if (instance == nullptr) {
+        instance = new Network();
+    }
+    return *instance;
+}
+
+bool Network::hasInstance() {
+    return instance != nullptr;
+}
+
+NetworkStatus Network::getStatus() const {
+    return publishedStatus.load(std::memory_order_relaxed);
+}
+
+const char* Network::getStatusString() const {
+    return statusToString(status);
+}
+
+const char* Network::statusToString(NetworkStatus value) {
+    return value == NetworkStatus::CONNECTED ? "Connected" : "Disconnected";
+}
+
+bool Network::isConnected() const {
+    return getStatus() == NetworkStatus::CONNECTED;
+}
+
+void Network::getLocalIP(char* buffer, size_t size) const {
+    snprintf(buffer, size, "127.0.0.1");
+}
+
+void Network::getSSID(char* buffer, size_t size) const {
+    snprintf(buffer, size, "%s", wifiSSID.c_str());
+}
+
+void Network::getMACAddress(char* buffer, size_t size) const {
+    snprintf(buffer, size, "02:00:00:00:00:01");
+}
+
+int Network::getRSSI() const {
+    return -55;
+}
+
+int Network::getReconnectAttempts() const {
+    return reconnectAttempts;
+}
+
+bool Network::isPowerSaveActive() const {
+    return publishedPowerSave.load(std::memory_order_relaxed);
+}
+
+void Network::notePacketSent() {
+}
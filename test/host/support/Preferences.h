@@ -0,0 +1,41 @@
+#pragma once
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+#include <vector>
+
+// Host stand-in for NVS: one in-memory store shared by every instance
+class Preferences {
+   public:
+    bool begin(const char* name, bool readOnly = false, const char* partition = nullptr) {
+        space = name;
+        return true;
+    }
+    void end() {}
+
+    size_t putBytes(const char* key, const void* data, size_t length) {
+        const uint8_t* bytes = (const uint8_t*)data;
+        store()[space + "/" + key].assign(bytes, bytes + length);
+        return length;
+    }
+    size_t getBytesLength(const char* key) {
+        auto entry = store().find(space + "/" + key);
+        return entry == store().end() ? 0 : entry->second.size();
+    }
+    size_t getBytes(const char* key, void* data, size_t length) {
+        auto entry = store().find(space + "/" + key);
+        if (entry == store().end() || entry->second.size() > length) return 0;
+        memcpy(data, entry->second.data(), entry->second.size());
+        return entry->second.size();
+    }
+    bool remove(const char* key) { return store().erase(space + "/" + key) > 0; }
+
+   private:
+    std::string space;
+
+    static std::map<std::string, std::vector<uint8_t>>& store() {
+        static std::map<std::string, std::vector<uint8_t>> entries;
+        return entries;
+    }
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+// Host stand-in for PubSubClient whose sessions go to host::mqttBroker(),
+// an in-process broker a test controls. The broker keeps retained topics,
+// can be taken offline, and can cut the session after a given number of
+// publishes. A publish on a cut session fails and closes it, as the real
+// client does when the socket write fails.
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+
+namespace host {
+
+class MqttBroker {
+   public:
+    bool online = true;
+    int dropAfter = -1;  // Cut the session after this many more publishes, -1 for never
+    unsigned long connects = 0;
+    unsigned long publishes = 0;
+    std::map<std::string, std::string> retained;
+
+    bool publish(const char* topic, const uint8_t* payload, size_t length, bool retain) {
+        if (dropAfter == 0) online = false;
+        if (!online) return false;
+        if (dropAfter > 0) dropAfter--;
+
+        publishes++;
+        if (retain) retained[topic] = std::string((const char*)payload, length);
+        return true;
+    }
+
+    std::string value(const std::string& topic) const {
+        auto it = retained.find(topic);
+        return it == retained.end() ? "" : it->second;
+    }
+};
+
+inline MqttBroker& mqttBroker() {
+    static MqttBroker broker;
+    return broker;
+}
+
+}  // namespace host
+
+class PubSubClient {
+   public:
+    template <typename Client>
+    explicit PubSubClient(Client&) : session(false) {}
+
+    PubSubClient& setServer(const char*, uint16_t) { return *this; }
+
+    bool connect(const char*) {
+        session = host::mqttBroker().online;
+        if (session) host::mqttBroker().connects++;
+        return session;
+    }
+
+    void disconnect() { session = false; }
+    bool connected() { return session && host::mqttBroker().online; }
+    bool loop() { return connected(); }
+    int state() { return connected() ? 0 : -2; }  // MQTT_CONNECTED, MQTT_CONNECT_FAILED
+
+    bool publish(const char* topic, const uint8_t* payload, unsigned int length, bool retain) {
+        if (!connected()) return false;
+        session = host::mqttBroker().publish(topic, payload, length, retain);
+        return session;
+    }
+
+   private:
+    bool session;
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+// Host stand-in for the Arduino WebServer, serving real HTTP on 127.0.0.1.
+//
+// Like the ESP32 one, handleClient() takes at most one waiting connection,
+// reads its request, runs the matching handler and closes the connection
+// after the response (no keep-alive). Only the request line is looked at;
+// the method must be GET. That is all ApiServer needs, and it lets a test
+// time whole requests over the loopback interface.
+
+#include <Arduino.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <functional>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define PGM_P const char*
+
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_POST };
+
+class WebServer {
+   public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    WebServer(int port = 80) : port(port), listener(-1), client(-1), routeCount(0) {}
+    ~WebServer() { stop(); }
+
+    void begin() {
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(listener, (sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 16) != 0) {
+            perror("WebServer");
+            close(listener);
+            listener = -1;
+            return;
+        }
+        fcntl(listener, F_SETFL, O_NONBLOCK);
+    }
+
+    void stop() {
+        if (listener >= 0) close(listener);
+        listener = -1;
+    }
+
+    bool isListening() const { return listener >= 0; }
+
+    void on(const char* uri, HTTPMethod method, THandlerFunction handler) {
+        if (routeCount < MAX_ROUTES) routes[routeCount++] = {uri, handler};
+    }
+
+    void onNotFound(THandlerFunction handler) { notFound = handler; }
+
+    void handleClient() {
+        if (listener < 0) return;
+        client = accept(listener, nullptr, nullptr);
+        if (client < 0) return;
+
+        char request[512];
+        size_t length = 0;
+        while (length < sizeof(request) - 1) {
+            ssize_t received = recv(client, request + length, sizeof(request) - 1 - length, 0);
+            if (received <= 0) break;
+            length += received;
+            request[length] = '\0';
+            if (strstr(request, "\r\n\r\n")) break;
+        }
+        request[length] = '\0';
+
+        char path[128] = "";
+        THandlerFunction* handler = &notFound;
+        if (sscanf(request, "GET %127s HTTP/", path) == 1) {
+            for (uint8_t i = 0; i < routeCount; i++) {
+                if (strcmp(routes[i].uri, path) == 0) handler = &routes[i].handler;
+            }
+        }
+        if (*handler) (*handler)();
+
+        close(client);
+        client = -1;
+    }
+
+    void send(int code, const char* contentType, const char* content) {
+        send_P(code, contentType, content, strlen(content));
+    }
+    void send(int code, const char* contentType, const String& content) {
+        send_P(code, contentType, content.c_str(), content.length());
+    }
+
+    void send_P(int code, PGM_P contentType, PGM_P content, size_t length) {
+        char header[160];
+        int headerLength = snprintf(header, sizeof(header),
+                                    "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %u\r\nConnection: close\r\n\r\n",
+                                    code, code == 200 ? "OK" : "Not Found", contentType, (unsigned)length);
+        writeAll(header, headerLength);
+        writeAll(content, length);
+    }
+
+   private:
+    static const uint8_t MAX_ROUTES = 8;
+
+    struct Route {
+        const char* uri;
+        THandlerFunction handler;
+    };
+
+    int port;
+    int listener;
+    int client;
+    Route routes[MAX_ROUTES];
+    uint8_t routeCount;
+    THandlerFunction notFound;
+
+    void writeAll(const char* data, size_t length) {
+        while (length > 0) {
+            ssize_t sent = ::send(client, data, length, MSG_NOSIGNAL);
+            if (sent <= 0) return;
+            data += sent;
+            length -= sent;
+        }
+    }
+};
@@ -0,0 +1,233 @@
+#pragma once
+
+// Host stand-in for links2004's WebSocketsServer, serving on 127.0.0.1.
+//
+// loop() accepts waiting connections, answers the upgrade request with the
+// RFC 6455 handshake and reports WStype_CONNECTED, and reports
+// WStype_DISCONNECTED once a client has closed its end. sendTXT() writes one
+// unmasked text frame. Frames from clients are read and dropped, as
+// StatePushServer ignores them; there is no ping/pong or fragmentation.
+
+#include <Arduino.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <functional>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define WEBSOCKETS_SERVER_CLIENT_MAX 5
+
+enum WStype_t { WStype_ERROR, WStype_DISCONNECTED, WStype_CONNECTED, WStype_TEXT, WStype_BIN };
+
+class WebSocketsServer {
+   public:
+    typedef std::function<void(uint8_t num, WStype_t type, uint8_t* payload, size_t length)> WebSocketServerEvent;
+
+    WebSocketsServer(uint16_t port) : port(port), listener(-1) {
+        for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) clients[i] = -1;
+    }
+    ~WebSocketsServer() { close(); }
+
+    void begin() {
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(listener, (sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 8) != 0) {
+            perror("WebSocketsServer");
+            ::close(listener);
+            listener = -1;
+            return;
+        }
+        fcntl(listener, F_SETFL, O_NONBLOCK);
+    }
+
+    void close() {
+        for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) drop(i, false);
+        if (listener >= 0) ::close(listener);
+        listener = -1;
+    }
+
+    void onEvent(WebSocketServerEvent handler) { onEventHandler = handler; }
+
+    void loop() {
+        if (listener < 0) return;
+
+        int fd;
+        while ((fd = accept(listener, nullptr, nullptr)) >= 0) {
+            uint8_t num = 0;
+            while (num < WEBSOCKETS_SERVER_CLIENT_MAX && clients[num] >= 0) num++;
+            if (num == WEBSOCKETS_SERVER_CLIENT_MAX || !handshake(fd)) {
+                ::close(fd);
+                continue;
+            }
+            fcntl(fd, F_SETFL, O_NONBLOCK);
+            clients[num] = fd;
+            emit(num, WStype_CONNECTED, (uint8_t*)"/", 1);
+        }
+
+        for (uint8_t num = 0; num < WEBSOCKETS_SERVER_CLIENT_MAX; num++) {
+            if (clients[num] < 0) continue;
+            char buffer[256];
+            ssize_t received = recv(clients[num], buffer, sizeof(buffer), 0);
+            if (received == 0 || (received > 0 && (buffer[0] & 0x0F) == 0x08)) drop(num, true);
+        }
+    }
+
+    bool sendTXT(uint8_t num, const char* payload, size_t length = 0, bool headerToPayload = false) {
+        if (num >= WEBSOCKETS_SERVER_CLIENT_MAX || clients[num] < 0) return false;
+        if (length == 0) length = strlen(payload);
+
+        uint8_t header[4] = {0x81};
+        size_t headerLength = 2;
+        if (length < 126) {
+            header[1] = (uint8_t)length;
+        } else {
+            header[1] = 126;
+            header[2] = (uint8_t)(length >> 8);
+            header[3] = (uint8_t)length;
+            headerLength = 4;
+        }
+        return writeAll(clients[num], header, headerLength) && writeAll(clients[num], payload, length);
+    }
+
+    uint8_t connectedClients(bool ping = false) {
+        uint8_t count = 0;
+        for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+            if (clients[i] >= 0) count++;
+        }
+        return count;
+    }
+
+   private:
+    uint16_t port;
+    int listener;
+    int clients[WEBSOCKETS_SERVER_CLIENT_MAX];
+    WebSocketServerEvent onEventHandler;
+
+    void emit(uint8_t num, WStype_t type, uint8_t* payload, size_t length) {
+        if (onEventHandler) onEventHandler(num, type, payload, length);
+    }
+
+    void drop(uint8_t num, bool notify) {
+        if (clients[num] < 0) return;
+        ::close(clients[num]);
+        clients[num] = -1;
+        if (notify) emit(num, WStype_DISCONNECTED, nullptr, 0);
+    }
+
+    static bool writeAll(int fd, const void* data, size_t length) {
+        const uint8_t* bytes = (const uint8_t*)data;
+        while (length > 0) {
+            ssize_t sent = send(fd, bytes, length, MSG_NOSIGNAL);
+            if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) continue;
+            if (sent <= 0) return false;
+            bytes += sent;
+            length -= sent;
+        }
+        return true;
+    }
+
+    // Reads the upgrade request and answers it; false if it is not a WebSocket upgrade
+    static bool handshake(int fd) {
+        char request[1024];
+        size_t length = 0;
+        while (length < sizeof(request) - 1) {
+            ssize_t received = recv(fd, request + length, sizeof(request) - 1 - length, 0);
+            if (received <= 0) return false;
+            length += received;
+            request[length] = '\0';
+            if (strstr(request, "\r\n\r\n")) break;
+        }
+
+        const char* keyField = strstr(request, "Sec-WebSocket-Key:");
+        if (!keyField) return false;
+        char key[64 + 36];
+        if (sscanf(keyField, "Sec-WebSocket-Key: %63s", key) != 1) return false;
+        strcat(key, "258EAFA5-E914-47DA-95CA-C5AB0DC85B11");
+
+        uint8_t digest[20];
+        sha1((const uint8_t*)key, strlen(key), digest);
+        char accept[32];
+        base64(digest, sizeof(digest), accept);
+
+        char response[160];
+        int responseLength = snprintf(response, sizeof(response),
+                                      "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\n"
+                                      "Connection: Upgrade\r\nSec-WebSocket-Accept: %s\r\n\r\n",
+                                      accept);
+        return writeAll(fd, response, responseLength);
+    }
+
+    static uint32_t rotate(uint32_t value, int bits) { return (value << bits) | (value >> (32 - bits)); }
+
+    static void sha1(const uint8_t* data, size_t length, uint8_t digest[20]) {
+        uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+        uint8_t message[128] = {};  // Keys are short: at most two blocks
+        memcpy(message, data, length);
+        message[length] = 0x80;
+        size_t total = length + 9 <= 64 ? 64 : 128;
+        uint64_t bits = (uint64_t)length * 8;
+        for (int i = 0; i < 8; i++) message[total - 1 - i] = (uint8_t)(bits >> (8 * i));
+
+        for (size_t block = 0; block < total; block += 64) {
+            uint32_t w[80];
+            for (int i = 0; i < 16; i++) {
+                const uint8_t* p = message + block + i * 4;
+                w[i] = (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+            }
+            for (int i = 16; i < 80; i++) w[i] = rotate(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+            uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+            for (int i = 0; i < 80; i++) {
+                uint32_t f, k;
+                if (i < 20) {
+                    f = (b & c) | (~b & d);
+                    k = 0x5A827999;
+                } else if (i < 40) {
+                    f = b ^ c ^ d;
+                    k = 0x6ED9EBA1;
+                } else if (i < 60) {
+                    f = (b & c) | (b & d) | (c & d);
+                    k = 0x8F1BBCDC;
+                } else {
+                    f = b ^ c ^ d;
+                    k = 0xCA62C1D6;
+                }
+                uint32_t next = rotate(a, 5) + f + e + k + w[i];
+                e = d;
+                d = c;
+                c = rotate(b, 30);
+                b = a;
+                a = next;
+            }
+            h[0] += a;
+            h[1] += b;
+            h[2] += c;
+            h[3] += d;
+            h[4] += e;
+        }
+        for (int i = 0; i < 20; i++) digest[i] = (uint8_t)(h[i / 4] >> (24 - 8 * (i % 4)));
+    }
+
+    static void base64(const uint8_t* data, size_t length, char* out) {
+        static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        size_t pos = 0;
+        for (size_t i = 0; i < length; i += 3) {
+            uint32_t chunk = (uint32_t)data[i] << 16;
+            if (i + 1 < length) chunk |= (uint32_t)data[i + 1] << 8;
+            if (i + 2 < length) chunk |= data[i + 2];
+            out[pos++] = alphabet[(chunk >> 18) & 63];
+            out[pos++] = alphabet[(chunk >> 12) & 63];
+            out[pos++] = i + 1 < length ? alphabet[(chunk >> 6) & 63] : '=';
+            out[pos++] = i + 2 < length ? alphabet[chunk & 63] : '=';
+        }
+        out[pos] = '\0';
+    }
+};
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "WiFi.h"
+
+// Only held by value for PubSubClient, which talks to the broker stand-in instead
+class WiFiClient {};
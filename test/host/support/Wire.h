@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Host stand-in for the I2C driver; device tests use MockI2CBus instead
+class TwoWire {
+   public:
+    bool begin(int sda, int scl, uint32_t frequency) { return true; }
+    void setClock(uint32_t) {}
+    void beginTransmission(uint8_t) {}
+    size_t write(uint8_t) { return 1; }
+    size_t write(const uint8_t*, size_t length) { return length; }
+    uint8_t endTransmission(bool stop = true) { return 2; }  // Address NACK: nothing on the bus
+    uint8_t requestFrom(uint8_t, uint8_t) { return 0; }
+    int available() { return 0; }
+    int read() { return -1; }
+};
+
+inline TwoWire Wire;
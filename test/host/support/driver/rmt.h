@@ -0,0 +1,135 @@
+#pragma once
+
+// Host stand-in for the legacy RMT driver, enough for RmtFrameSink.
+//
+// rmt_write_sample() runs the channel's translator over the whole sample
+// buffer the way the driver's interrupt does, 64 items at a time, and keeps
+// the items for the test in host::rmtItems(). The frame then stays on the
+// line until the test calls host::rmtFinish(), which fires the tx-end
+// callback as the interrupt would.
+
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+#include <vector>
+
+typedef enum {
+    RMT_CHANNEL_0,
+    RMT_CHANNEL_1,
+    RMT_CHANNEL_2,
+    RMT_CHANNEL_3,
+    RMT_CHANNEL_4,
+    RMT_CHANNEL_5,
+    RMT_CHANNEL_6,
+    RMT_CHANNEL_7,
+    RMT_CHANNEL_MAX
+} rmt_channel_t;
+
+typedef enum { RMT_IDLE_LEVEL_LOW, RMT_IDLE_LEVEL_HIGH } rmt_idle_level_t;
+
+typedef struct {
+    union {
+        struct {
+            uint32_t duration0 : 15;
+            uint32_t level0 : 1;
+            uint32_t duration1 : 15;
+            uint32_t level1 : 1;
+        };
+        uint32_t val;
+    };
+} rmt_item32_t;
+
+typedef struct {
+    bool idle_output_en;
+    rmt_idle_level_t idle_level;
+} rmt_tx_config_t;
+
+typedef struct {
+    rmt_channel_t channel;
+    gpio_num_t gpio_num;
+    uint8_t clk_div;
+    rmt_tx_config_t tx_config;
+} rmt_config_t;
+
+#define RMT_DEFAULT_CONFIG_TX(gpio, channel_id) \
+    { (channel_id), (gpio), 80, { false, RMT_IDLE_LEVEL_LOW } }
+
+typedef void (*sample_to_rmt_t)(const void* src, rmt_item32_t* dest, size_t src_size, size_t wanted_num,
+                                size_t* translated_size, size_t* item_num);
+typedef void (*rmt_tx_end_fn_t)(rmt_channel_t channel, void* arg);
+
+namespace host {
+struct RmtChannel {
+    bool installed = false;
+    bool sending = false;
+    sample_to_rmt_t translator = nullptr;
+    std::vector<rmt_item32_t> items;  // Last frame as it went out
+};
+
+inline RmtChannel& rmtChannel(rmt_channel_t channel) {
+    static RmtChannel channels[RMT_CHANNEL_MAX];
+    return channels[channel];
+}
+
+inline rmt_tx_end_fn_t& rmtTxEnd() {
+    static rmt_tx_end_fn_t callback = nullptr;
+    return callback;
+}
+
+inline const std::vector<rmt_item32_t>& rmtItems(rmt_channel_t channel) {
+    return rmtChannel(channel).items;
+}
+
+// The last item has left the line
+inline void rmtFinish(rmt_channel_t channel) {
+    if (!rmtChannel(channel).sending) return;
+    rmtChannel(channel).sending = false;
+    if (rmtTxEnd()) rmtTxEnd()(channel, nullptr);
+}
+}  // namespace host
+
+inline esp_err_t rmt_config(const rmt_config_t* config) {
+    return config->channel < RMT_CHANNEL_MAX ? ESP_OK : ESP_FAIL;
+}
+
+inline esp_err_t rmt_driver_install(rmt_channel_t channel, size_t, int) {
+    if (host::rmtChannel(channel).installed) return ESP_ERR_INVALID_STATE;
+    host::rmtChannel(channel) = host::RmtChannel();
+    host::rmtChannel(channel).installed = true;
+    return ESP_OK;
+}
+
+inline esp_err_t rmt_driver_uninstall(rmt_channel_t channel) {
+    host::rmtChannel(channel) = host::RmtChannel();
+    return ESP_OK;
+}
+
+inline esp_err_t rmt_translator_init(rmt_channel_t channel, sample_to_rmt_t translator) {
+    host::rmtChannel(channel).translator = translator;
+    return ESP_OK;
+}
+
+inline rmt_tx_end_fn_t rmt_register_tx_end_callback(rmt_tx_end_fn_t callback, void*) {
+    rmt_tx_end_fn_t previous = host::rmtTxEnd();
+    host::rmtTxEnd() = callback;
+    return previous;
+}
+
+inline esp_err_t rmt_write_sample(rmt_channel_t channel, const uint8_t* src, size_t src_size, bool) {
+    host::RmtChannel& state = host::rmtChannel(channel);
+    if (!state.installed || !state.translator || state.sending) return ESP_FAIL;
+
+    const size_t BLOCK_ITEMS = 64;  // One channel's RMT memory
+    state.items.clear();
+    size_t done = 0;
+    while (done < src_size) {
+        rmt_item32_t block[BLOCK_ITEMS];
+        size_t translated = 0;
+        size_t count = 0;
+        state.translator(src + done, block, src_size - done, BLOCK_ITEMS, &translated, &count);
+        if (translated == 0) return ESP_FAIL;
+        state.items.insert(state.items.end(), block, block + count);
+        done += translated;
+    }
+    state.sending = true;
+    return ESP_OK;
+}
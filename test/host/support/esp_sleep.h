@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_INVALID_STATE 0x103
+
+typedef enum { ESP_SLEEP_WAKEUP_UNDEFINED, ESP_SLEEP_WAKEUP_TIMER, ESP_SLEEP_WAKEUP_GPIO, ESP_SLEEP_WAKEUP_UART } esp_sleep_wakeup_cause_t;
+typedef enum { ESP_SLEEP_WAKEUP_ALL } esp_sleep_source_t;
+
+namespace host {
+// Light sleeps entered, and how long the timer wakeup was armed for
+inline uint32_t& sleepCount() {
+    static uint32_t count = 0;
+    return count;
+}
+inline uint64_t& sleepTimerMicros() {
+    static uint64_t timer = 0;
+    return timer;
+}
+}
+
+inline esp_err_t esp_sleep_enable_timer_wakeup(uint64_t us) {
+    host::sleepTimerMicros() = us;
+    return ESP_OK;
+}
+inline esp_err_t esp_sleep_enable_gpio_wakeup() { return ESP_OK; }
+inline esp_err_t esp_sleep_enable_uart_wakeup(int) { return ESP_OK; }
+inline esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t) { return ESP_OK; }
+inline esp_err_t esp_light_sleep_start() {
+    host::sleepCount()++;
+    return ESP_OK;
+}
+inline esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() { return ESP_SLEEP_WAKEUP_TIMER; }
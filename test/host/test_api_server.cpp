@@ -0,0 +1,146 @@
+// ApiServer: the three endpoints and request throughput over loopback.
+//
+// support/WebServer.h serves real HTTP on 127.0.0.1, so each request here is
+// a TCP connect, request, response and close through the kernel, as a
+// browser or script on the LAN would make it. The test runs single threaded:
+// the client connects and writes its request, which waits in the listen
+// backlog until ApiServer::update() accepts and answers it.
+//
+// The device list is checked as the control task changes it: ApiServer must
+// show what IO published, including after a device is removed and freed.
+// The benchmark reports requests per second with the bodies cached, and
+// checks that serving never re-serializes.
+
+#include <Arduino.h>
+#include <arpa/inet.h>
+#include <chrono>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "Check.hpp"
+#include "io/IO.hpp"
+#include "network/ApiServer.hpp"
+#include "network/Network.hpp"
+
+namespace {
+const uint16_t PORT = 18080;
+
+struct Response {
+    int status;
+    std::string body;
+};
+
+// One request, answered by a single ApiServer::update()
+Response request(ApiServer& api, const char* path) {
+    Response response = {0, ""};
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(PORT);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+        close(fd);
+        return response;
+    }
+
+    char line[160];
+    int length = snprintf(line, sizeof(line), "GET %s HTTP/1.1\r\nHost: unimix\r\n\r\n", path);
+    send(fd, line, length, 0);
+
+    api.update();
+
+    std::string raw;
+    char buffer[1024];
+    ssize_t received;
+    while ((received = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        raw.append(buffer, received);
+    }
+    close(fd);
+
+    sscanf(raw.c_str(), "HTTP/1.1 %d", &response.status);
+    size_t bodyStart = raw.find("\r\n\r\n");
+    if (bodyStart != std::string::npos) response.body = raw.substr(bodyStart + 4);
+    return response;
+}
+
+bool contains(const std::string& text, const char* part) {
+    return text.find(part) != std::string::npos;
+}
+
+void testEndpoints(ApiServer& api) {
+    IO& io = IO::getInstance();
+    Button::Config buttonConfig;
+    buttonConfig.pin = 4;
+    CHECK(io.addButton("mute_button", buttonConfig) != nullptr);
+    RotaryEncoder::Config encoderConfig;
+    encoderConfig.pinA = 12;
+    encoderConfig.pinB = 13;
+    encoderConfig.hasButton = false;
+    CHECK(io.addRotaryEncoder("volume_encoder", encoderConfig) != nullptr);
+    io.initialize();
+
+    api.setChannelValue(0, 42);
+    api.setChannelValue(2, -7);
+    Response state = request(api, "/api/state");
+    CHECK_EQUAL(200, state.status);
+    CHECK(state.body == "{\"channels\":[42,0,-7]}");
+
+    Response devices = request(api, "/api/devices");
+    CHECK_EQUAL(200, devices.status);
+    CHECK(devices.body ==
+          "{\"devices\":[{\"id\":\"mute_button\",\"type\":\"button\",\"initialized\":true},"
+          "{\"id\":\"volume_encoder\",\"type\":\"encoder\",\"initialized\":true}]}");
+
+    // Removal frees the device; the next body comes from the republished list
+    CHECK(io.removeDevice("mute_button"));
+    devices = request(api, "/api/devices");
+    CHECK(!contains(devices.body, "mute_button"));
+    CHECK(contains(devices.body, "volume_encoder"));
+
+    Response network = request(api, "/api/network");
+    CHECK_EQUAL(200, network.status);
+    CHECK(network.body ==
+          "{\"status\":\"Connected\",\"ssid\":\"host-lan\",\"ip\":\"127.0.0.1\",\"rssi\":-55,"
+          "\"mac\":\"02:00:00:00:00:01\",\"reconnects\":0}");
+
+    CHECK_EQUAL(404, request(api, "/api/missing").status);
+}
+
+void benchmark(ApiServer& api) {
+    const char* paths[] = {"/api/state", "/api/devices", "/api/network"};
+    const int REQUESTS = 6000;
+
+    api.resetStats();
+    auto start = std::chrono::steady_clock::now();
+    int answered = 0;
+    for (int i = 0; i < REQUESTS; i++) {
+        if (request(api, paths[i % 3]).status == 200) answered++;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("api server: %.0f requests/s over loopback (%.1f us per request, connect to close)\n",
+           REQUESTS / seconds, seconds * 1e6 / REQUESTS);
+
+    CHECK_EQUAL(REQUESTS, answered);
+    CHECK_EQUAL(REQUESTS, api.getRequestCount());
+    CHECK_EQUAL(0, api.getSerializeCount());  // Nothing changed, so every request was a copy
+}
+}
+
+int main() {
+    Network::getInstance();  // The stub's link is up, so the server starts listening
+
+    ApiServer& api = ApiServer::getInstance();
+    api.setPort(PORT);
+    api.initialize();
+    api.update();  // Starts listening
+
+    testEndpoints(api);
+    benchmark(api);
+
+    ApiServer::destroyInstance();
+    return TEST_RESULT("test_api_server");
+}
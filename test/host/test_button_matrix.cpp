@@ -0,0 +1,196 @@
+// ButtonMatrix: debounce, ghosting and the cost of processScan().
+//
+// Raw scans are fed straight to processScan(), the same entry point update()
+// uses after reading the GPIOs. The vertical counter must accept a change
+// after exactly DEBOUNCE_SCANS agreeing scans and restart on any bounce. With
+// three corners of a rectangle pressed, the fourth (ghost) corner and the
+// press that completed the rectangle are held back until it breaks. The
+// benchmark reports the time per processScan() for an 8x8 matrix at rest,
+// with every key bouncing, and with the ghost check busy. The GPIO half of a
+// scan is a fixed rows * (cols + 2) pin operations on the target and is not
+// measured here.
+
+#include <Arduino.h>
+#include <chrono>
+#include <stdio.h>
+#include "Check.hpp"
+#include "io/ButtonMatrix.hpp"
+
+namespace {
+ButtonMatrix::Config matrixConfig(uint8_t rows, uint8_t cols, bool hasDiodes = false) {
+    ButtonMatrix::Config config;
+    config.rows = rows;
+    config.cols = cols;
+    config.hasDiodes = hasDiodes;
+    for (uint8_t i = 0; i < rows; i++) config.rowPins[i] = i;
+    for (uint8_t i = 0; i < cols; i++) config.colPins[i] = 16 + i;
+    return config;
+}
+
+uint64_t bit(const ButtonMatrix& matrix, uint8_t row, uint8_t col) {
+    return 1ULL << matrix.keyIndex(row, col);
+}
+
+// Feed the same raw scan several times
+void feed(ButtonMatrix& matrix, uint64_t sample, int scans, unsigned long& now) {
+    for (int i = 0; i < scans; i++) {
+        matrix.processScan(sample, now);
+        now += 5;
+    }
+}
+
+void testDebounce() {
+    ButtonMatrix matrix("keypad", matrixConfig(4, 4));
+    unsigned long now = 1000;
+    uint64_t key = bit(matrix, 1, 2);
+    const int SCANS = ButtonMatrix::DEBOUNCE_SCANS;
+
+    // A press shows up on the DEBOUNCE_SCANS-th agreeing scan, not before
+    feed(matrix, key, SCANS - 1, now);
+    CHECK_EQUAL(0, matrix.getPressedMask());
+    feed(matrix, key, 1, now);
+    CHECK_EQUAL(key, matrix.getPressedMask());
+
+    ButtonMatrix::KeyEvent event;
+    CHECK(matrix.takeEvent(event));
+    CHECK_EQUAL(matrix.keyIndex(1, 2), event.key);
+    CHECK(event.pressed);
+    CHECK(!matrix.takeEvent(event));
+
+    // A bounce back to the debounced state restarts the count
+    feed(matrix, 0, SCANS - 1, now);
+    feed(matrix, key, 1, now);
+    feed(matrix, 0, SCANS - 1, now);
+    CHECK_EQUAL(key, matrix.getPressedMask());
+    feed(matrix, 0, 1, now);
+    CHECK_EQUAL(0, matrix.getPressedMask());
+    CHECK(matrix.takeEvent(event));
+    CHECK(!event.pressed);
+
+    // Continuous chatter shorter than the window never gets through
+    for (int i = 0; i < 100; i++) {
+        feed(matrix, key, 1 + i % (SCANS - 1), now);
+        feed(matrix, 0, 1, now);
+    }
+    CHECK_EQUAL(0, matrix.getPressedMask());
+    CHECK(!matrix.takeEvent(event));
+
+    // Keys past the configured grid are ignored
+    feed(matrix, ~0ULL << matrix.getKeyCount(), SCANS, now);
+    CHECK_EQUAL(0, matrix.getPressedMask());
+}
+
+void testGhosting() {
+    ButtonMatrix matrix("keypad", matrixConfig(4, 4));
+    unsigned long now = 1000;
+    const int SCANS = ButtonMatrix::DEBOUNCE_SCANS;
+    uint64_t a = bit(matrix, 0, 0), b = bit(matrix, 0, 1), c = bit(matrix, 1, 0), ghost = bit(matrix, 1, 1);
+
+    // Two keys in one row are reported exactly
+    feed(matrix, a | b, SCANS, now);
+    CHECK_EQUAL(a | b, matrix.getPressedMask());
+
+    // A third corner makes the fourth read as pressed too: both new corners are held back
+    feed(matrix, a | b | c | ghost, SCANS, now);
+    CHECK_EQUAL(a | b, matrix.getPressedMask());
+    CHECK_EQUAL(2, matrix.getStats().ghostBlocks);
+
+    // Holding still does not count the same block again
+    feed(matrix, a | b | c | ghost, SCANS * 4, now);
+    CHECK_EQUAL(a | b, matrix.getPressedMask());
+    CHECK_EQUAL(2, matrix.getStats().ghostBlocks);
+
+    // Releasing b breaks the rectangle: the ghost goes away and c is finally reported
+    feed(matrix, a | c, SCANS, now);
+    CHECK_EQUAL(a | c, matrix.getPressedMask());
+
+    ButtonMatrix::KeyEvent event;
+    int presses = 0, releases = 0;
+    bool ghostReported = false;
+    while (matrix.takeEvent(event)) {
+        if (event.pressed) presses++;
+        else releases++;
+        if (event.key == matrix.keyIndex(1, 1)) ghostReported = true;
+    }
+    CHECK_EQUAL(3, presses);  // a, b, then c
+    CHECK_EQUAL(1, releases);  // b
+    CHECK(!ghostReported);
+
+    // Any pattern without a rectangle is reported in full (n-key rollover)
+    uint64_t diagonal = 0;
+    for (uint8_t i = 0; i < 4; i++) diagonal |= bit(matrix, i, i);
+    uint64_t fan = diagonal | bit(matrix, 0, 1) | bit(matrix, 0, 2) | bit(matrix, 0, 3);
+    feed(matrix, 0, SCANS, now);
+    feed(matrix, fan, SCANS, now);
+    CHECK_EQUAL(fan, matrix.getPressedMask());
+
+    // With diodes there are no ghosts, so a full rectangle goes straight through
+    ButtonMatrix diodes("keypad", matrixConfig(4, 4, true));
+    feed(diodes, a | b | c | ghost, SCANS, now);
+    CHECK_EQUAL(a | b | c | ghost, diodes.getPressedMask());
+    CHECK_EQUAL(0, diodes.getStats().ghostBlocks);
+}
+
+// Deterministic noise for the benchmark
+uint64_t nextRandom(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+double nanosPerScan(ButtonMatrix& matrix, const uint64_t* samples, size_t sampleCount, int scans) {
+    unsigned long now = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < scans; i++) {
+        matrix.processScan(samples[i % sampleCount], now += 5);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Keep the event queue from being optimized into nothing
+    ButtonMatrix::KeyEvent event;
+    while (matrix.takeEvent(event)) {
+    }
+    return std::chrono::duration<double, std::nano>(elapsed).count() / scans;
+}
+
+void benchmark() {
+    const int SCANS = 2000000;
+    const size_t PATTERNS = 256;
+    uint64_t samples[PATTERNS];
+    uint64_t random = 0x9E3779B97F4A7C15ULL;
+
+    ButtonMatrix idle("bench", matrixConfig(8, 8));
+    samples[0] = 0;
+    double idleNs = nanosPerScan(idle, samples, 1, SCANS);
+
+    // Every key flips at random on every scan
+    for (size_t i = 0; i < PATTERNS; i++) samples[i] = nextRandom(random);
+    ButtonMatrix bouncing("bench", matrixConfig(8, 8));
+    double bouncingNs = nanosPerScan(bouncing, samples, PATTERNS, SCANS);
+
+    // Half the keys held, so most row pairs share columns and the ghost check runs in full
+    for (size_t i = 0; i < PATTERNS; i++) samples[i] = 0x5A5A5A5A5A5A5A5AULL;
+    ButtonMatrix ghosted("bench", matrixConfig(8, 8));
+    double ghostedNs = nanosPerScan(ghosted, samples, 1, SCANS);
+
+    ButtonMatrix diodes("bench", matrixConfig(8, 8, true));
+    for (size_t i = 0; i < PATTERNS; i++) samples[i] = nextRandom(random);
+    double diodesNs = nanosPerScan(diodes, samples, PATTERNS, SCANS);
+
+    printf("button matrix 8x8 processScan: %.1f ns idle, %.1f ns all keys bouncing, %.1f ns ghost check busy, "
+           "%.1f ns bouncing with diodes\n",
+           idleNs, bouncingNs, ghostedNs, diodesNs);
+
+    CHECK_EQUAL(SCANS, idle.getStats().scans);
+    CHECK_EQUAL(0, idle.getPressedMask());
+    CHECK(ghosted.getStats().ghostBlocks > 0);
+}
+}
+
+int main() {
+    testDebounce();
+    testGhosting();
+    benchmark();
+    return TEST_RESULT("test_button_matrix");
+}
@@ -0,0 +1,215 @@
+// IO: long-run heap fragmentation check for adding and removing devices.
+//
+// Every C++ allocation made while the test runs is served from a fixed
+// 64 KB first-fit heap, which stands in for the ESP32's internal RAM. Unlike
+// malloc on a host, it can report the two figures that matter on the
+// target: free heap and the largest free block. The test adds and removes
+// devices thousands of times, mixing device types so that the holes left
+// behind differ in size. After a warm-up, both figures must stay where they
+// were. A slow leak shows up as falling free heap. Fragmentation shows up
+// as a falling largest block while free heap holds.
+
+#include <Arduino.h>
+#include <new>
+#include <stdio.h>
+#include "Check.hpp"
+#include "io/IO.hpp"
+
+namespace {
+// First-fit heap with boundary-tagged blocks, coalescing on free
+class TestHeap {
+   public:
+    static const size_t SIZE = 64 * 1024;
+    static const size_t ALIGN = 16;
+
+    TestHeap() {
+        setBlock(0, SIZE, false);
+    }
+
+    void* allocate(size_t bytes) {
+        size_t need = roundUp(bytes + HEADER);
+        for (size_t offset = 0; offset < SIZE; offset += blockSize(offset)) {
+            if (blockUsed(offset) || blockSize(offset) < need) continue;
+
+            size_t rest = blockSize(offset) - need;
+            if (rest >= ALIGN * 2) {
+                setBlock(offset + need, rest, false);
+            } else {
+                need = blockSize(offset);
+            }
+            setBlock(offset, need, true);
+            return memory + offset + HEADER;
+        }
+        return nullptr;
+    }
+
+    void release(void* pointer) {
+        size_t offset = (uint8_t*)pointer - memory - HEADER;
+        setBlock(offset, blockSize(offset), false);
+
+        // Merge every run of free blocks, including this one with its neighbours
+        for (size_t at = 0; at < SIZE;) {
+            size_t after = at + blockSize(at);
+            if (after < SIZE && !blockUsed(at) && !blockUsed(after)) {
+                setBlock(at, blockSize(at) + blockSize(after), false);
+            } else {
+                at = after;
+            }
+        }
+    }
+
+    bool owns(void* pointer) const {
+        return pointer >= memory && pointer < memory + SIZE;
+    }
+
+    size_t freeBytes() const {
+        size_t total = 0;
+        for (size_t offset = 0; offset < SIZE; offset += blockSize(offset)) {
+            if (!blockUsed(offset)) total += blockSize(offset) - HEADER;
+        }
+        return total;
+    }
+
+    size_t largestFreeBlock() const {
+        size_t largest = 0;
+        for (size_t offset = 0; offset < SIZE; offset += blockSize(offset)) {
+            if (!blockUsed(offset) && blockSize(offset) - HEADER > largest) largest = blockSize(offset) - HEADER;
+        }
+        return largest;
+    }
+
+    static const size_t HEADER = ALIGN;  // Block size with the used flag in bit 0
+
+   private:
+    alignas(ALIGN) uint8_t memory[SIZE];
+
+    static size_t roundUp(size_t bytes) {
+        return (bytes + ALIGN - 1) & ~(ALIGN - 1);
+    }
+    size_t blockSize(size_t offset) const {
+        return *(const size_t*)(memory + offset) & ~(size_t)1;
+    }
+    bool blockUsed(size_t offset) const {
+        return *(const size_t*)(memory + offset) & 1;
+    }
+    void setBlock(size_t offset, size_t size, bool used) {
+        *(size_t*)(memory + offset) = size | (used ? 1 : 0);
+    }
+};
+
+TestHeap heap;
+bool useTestHeap = false;
+size_t testAllocations = 0;
+
+const int CYCLES = 20000;
+const int WARMUP_CYCLES = 1000;
+const int CHECK_INTERVAL = 1000;
+const uint8_t FIXED_DEVICES = 6;
+const uint8_t CHURN_SLOTS = 6;
+
+DeviceId churnIds[CHURN_SLOTS];
+
+// Alternate three device types through each slot so the freed holes differ in size
+bool addChurnDevice(IO& io, int slot, int cycle) {
+    char id[DeviceId::MAX_LENGTH + 1];
+    snprintf(id, sizeof(id), "churn_%d_%d", slot, cycle % 7);
+    churnIds[slot] = id;
+
+    switch ((slot + cycle) % 3) {
+        case 0: {
+            Button::Config config;
+            config.pin = 4 + slot;
+            return io.addButton(id, config) != nullptr;
+        }
+        case 1: {
+            RotaryEncoder::Config config;
+            config.pinA = 12 + slot;
+            config.pinB = 20 + slot;
+            config.hasButton = false;
+            return io.addRotaryEncoder(id, config) != nullptr;
+        }
+        default: {
+            ButtonMatrix::Config config;
+            return io.addButtonMatrix(id, config) != nullptr;
+        }
+    }
+}
+}
+
+void* operator new(size_t bytes) {
+    void* pointer = useTestHeap ? heap.allocate(bytes) : malloc(bytes);
+    if (!pointer) throw std::bad_alloc();
+    if (useTestHeap) testAllocations++;
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+    if (heap.owns(pointer)) {
+        heap.release(pointer);
+    } else {
+        free(pointer);
+    }
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+int main() {
+    useTestHeap = true;
+
+    IO& io = IO::getInstance();
+    for (uint8_t i = 0; i < FIXED_DEVICES; i++) {
+        char id[DeviceId::MAX_LENGTH + 1];
+        snprintf(id, sizeof(id), "fixed_%u", i);
+        Button::Config config;
+        config.pin = i;
+        CHECK(io.addButton(id, config) != nullptr);
+    }
+    io.initialize();
+
+    size_t startFree = heap.freeBytes();
+    size_t baselineFree = 0;
+    size_t baselineLargest = 0;
+    size_t minLargest = SIZE_MAX;
+    size_t allocationsAtWarmup = 0;
+    size_t addAllocations = 0;
+
+    for (int cycle = 0; cycle < CYCLES; cycle++) {
+        int slot = cycle % CHURN_SLOTS;
+        if (cycle >= CHURN_SLOTS) {
+            CHECK(io.removeDevice(churnIds[slot]));
+        }
+        size_t before = testAllocations;
+        CHECK(addChurnDevice(io, slot, cycle));
+        addAllocations += testAllocations - before;
+
+        host::advanceMillis(1);
+        io.update();
+
+        if (cycle + 1 == WARMUP_CYCLES) {
+            baselineFree = heap.freeBytes();
+            baselineLargest = heap.largestFreeBlock();
+            allocationsAtWarmup = testAllocations;
+        } else if (cycle + 1 > WARMUP_CYCLES && (cycle + 1) % CHECK_INTERVAL == 0) {
+            size_t largest = heap.largestFreeBlock();
+            if (largest < minLargest) minLargest = largest;
+            CHECK_EQUAL(baselineFree, heap.freeBytes());
+            CHECK(largest >= baselineLargest);
+        }
+    }
+
+    printf("device heap: %d add/remove cycles, %.2f allocations per add, %.2f per cycle after warm-up, "
+           "free %u -> %u bytes, largest free block %u bytes (lowest %u)\n",
+           CYCLES, (double)addAllocations / CYCLES,
+           (double)(testAllocations - allocationsAtWarmup) / (CYCLES - WARMUP_CYCLES), (unsigned)startFree,
+           (unsigned)heap.freeBytes(), (unsigned)baselineLargest, (unsigned)minLargest);
+
+    // Everything comes back once the devices are gone
+    IO::destroyInstance();
+    CHECK_EQUAL(TestHeap::SIZE - TestHeap::HEADER, heap.freeBytes());
+    CHECK_EQUAL(TestHeap::SIZE - TestHeap::HEADER, heap.largestFreeBlock());
+
+    useTestHeap = false;
+    return TEST_RESULT("test_device_heap");
+}
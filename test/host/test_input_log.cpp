@@ -0,0 +1,212 @@
+// InputLog: record a session, move it as bytes, and replay it through the devices.
+//
+// The devices are the firmware's own. The encoder is a RotaryEncoder whose
+// hardware count the test sets, with its button and a separate Button on
+// pins of support/Arduino.h. A scripted second of turning and pressing is
+// recorded while IO::update() runs once per fake millisecond, and every
+// callback is noted with its InputLog::now() time.
+//
+// The log then goes through getData() and loadData() into a fresh instance,
+// and is replayed fast and in real time. Both replays must fire the same
+// callbacks at the same log times as the recorded session, with encoder
+// counts offset from the live count rather than jumping to the logged one.
+// Damaged logs must be refused. The benchmark reports the host cost of an
+// IO pass during a fast replay and the log's bytes per change.
+
+#include <Arduino.h>
+#include <chrono>
+#include <memory>
+#include <stdio.h>
+#include <vector>
+#include "Check.hpp"
+#include "io/IO.hpp"
+#include "io/InputLog.hpp"
+
+namespace {
+const int ENCODER_BUTTON_PIN = 25;
+const int BUTTON_PIN = 4;
+const int SESSION_MS = 1000;
+const int64_t LIVE_COUNT = 500;  // Where the encoder sits when a replay starts
+
+class TestEncoder : public RotaryEncoder {
+   public:
+    TestEncoder(const DeviceId& id, const Config& config) : RotaryEncoder(id, config) {}
+    void step(int detents) { count += detents; }
+    int64_t getCount() const { return count; }
+
+   protected:
+    int64_t readHardwareCount() const override { return count; }
+    void writeHardwareCount(int64_t value) override { count = value; }
+
+   private:
+    int64_t count = 0;
+};
+
+struct Event {
+    char source;  // 'e' encoder turn, 'k' encoder button, 'b' button
+    int value;
+    unsigned long at;  // ms since the session or replay started
+
+    bool operator==(const Event& other) const {
+        return source == other.source && value == other.value && at == other.at;
+    }
+};
+
+TestEncoder* encoder = nullptr;
+std::vector<Event> events;
+unsigned long sessionStart = 0;
+
+void note(char source, int value) {
+    events.push_back({source, value, InputLog::now() - sessionStart});
+}
+
+void setUp() {
+    host::setPin(ENCODER_BUTTON_PIN, HIGH);
+    host::setPin(BUTTON_PIN, HIGH);
+
+    IO& io = IO::getInstance();
+    RotaryEncoder::Config encoderConfig;
+    encoderConfig.buttonPin = ENCODER_BUTTON_PIN;
+    encoder = new TestEncoder("encoder", encoderConfig);
+    io.addDevice(std::unique_ptr<RotaryEncoder>(encoder));
+    encoder->setEncoderCallback([](int delta) { note('e', delta); });
+    encoder->setButtonCallback([](bool pressed) { note('k', pressed); });
+
+    Button::Config buttonConfig;
+    buttonConfig.pin = BUTTON_PIN;
+    Button* button = io.addButton("button", buttonConfig);
+    button->setCallback([](bool pressed) { note('b', pressed); });
+
+    io.initialize();
+}
+
+// One scripted second: turns both ways, a press on each button, a bounce too short to count
+void playSession() {
+    IO& io = IO::getInstance();
+    io.update();
+    for (int ms = 1; ms <= SESSION_MS; ms++) {
+        host::advanceMillis(1);
+        if (ms % 20 == 0 && ms < 500) encoder->step(1);
+        if (ms >= 600 && ms < 700 && ms % 10 == 0) encoder->step(-2);
+        if (ms == 300) host::setPin(BUTTON_PIN, LOW);
+        if (ms == 450) host::setPin(BUTTON_PIN, HIGH);
+        if (ms == 520) host::setPin(ENCODER_BUTTON_PIN, LOW);
+        if (ms == 540) host::setPin(ENCODER_BUTTON_PIN, HIGH);  // Bounce: shorter than the debounce
+        if (ms == 800) host::setPin(ENCODER_BUTTON_PIN, LOW);
+        if (ms == 900) host::setPin(ENCODER_BUTTON_PIN, HIGH);
+        io.update();
+    }
+}
+
+std::vector<Event> record(std::vector<uint8_t>& data) {
+    InputLog& log = InputLog::getInstance();
+    events.clear();
+    sessionStart = InputLog::now();
+    CHECK(log.startRecording());
+    playSession();
+    log.stop();
+
+    CHECK(log.getMode() == InputLog::Mode::IDLE);
+    CHECK(!log.getStats().overflowed);
+    CHECK_EQUAL(SESSION_MS, log.getStats().durationMs);
+    data.assign(log.getData(), log.getData() + log.getSize());
+    return events;
+}
+
+// Moves the live encoder away from the logged counts, so a replay has to offset them
+void moveLive() {
+    encoder->setPosition(LIVE_COUNT);
+    IO::getInstance().update();
+}
+
+void testRoundTrip(const std::vector<uint8_t>& data) {
+    uint32_t records = InputLog::getInstance().getStats().records;
+    InputLog::destroyInstance();
+
+    InputLog& log = InputLog::getInstance();
+    CHECK(log.loadData(data.data(), data.size()));
+    CHECK_EQUAL(data.size(), log.getSize());
+    CHECK(memcmp(data.data(), log.getData(), data.size()) == 0);
+    CHECK_EQUAL(records, log.getStats().records);
+    CHECK_EQUAL(SESSION_MS, log.getStats().durationMs);
+
+    // Damaged logs are refused and leave nothing to replay
+    std::vector<uint8_t> damaged(data);
+    damaged[0] = 'X';
+    CHECK(!log.loadData(damaged.data(), damaged.size()));
+    CHECK(!log.startReplay());
+    CHECK(!log.loadData(data.data(), data.size() - 1));  // Cut inside the end marker
+    CHECK(!log.loadData(data.data(), 3));
+
+    CHECK(log.loadData(data.data(), data.size()));
+}
+
+void testReplay(const std::vector<Event>& recorded, bool fast) {
+    InputLog& log = InputLog::getInstance();
+    moveLive();
+    events.clear();
+    sessionStart = InputLog::now();
+
+    if (fast) {
+        CHECK(log.runReplayFast());
+    } else {
+        CHECK(log.startReplay());
+        while (log.getMode() == InputLog::Mode::REPLAYING) {
+            host::advanceMillis(1);
+            IO::getInstance().update();
+        }
+    }
+    CHECK(log.getMode() == InputLog::Mode::IDLE);
+    CHECK(InputLog::now() - sessionStart >= SESSION_MS + InputLog::REPLAY_TAIL);
+
+    CHECK_EQUAL(recorded.size(), events.size());
+    CHECK(events == recorded);
+
+    // Counts were replayed from the live position, and the live counter was moved to the end
+    int turned = 0;
+    for (const Event& event : recorded) {
+        if (event.source == 'e') turned += event.value;
+    }
+    CHECK_EQUAL(LIVE_COUNT + turned, encoder->getPosition());
+    CHECK_EQUAL(encoder->getPosition(), encoder->getCount());
+}
+
+void benchmark(const std::vector<uint8_t>& data, size_t changes) {
+    const int REPLAYS = 200;
+    InputLog& log = InputLog::getInstance();
+
+    // The fake clock stands still inside a pass, so the pass time comes from the host clock
+    uint32_t passes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < REPLAYS; i++) {
+        log.runReplayFast();
+        passes += log.getStats().updates;
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    printf("input log: %u bytes for %u records (%.1f bytes per device change), fast replay %.3f us per IO pass "
+           "over %u passes\n",
+           (unsigned)data.size(), log.getStats().records, (double)data.size() / changes, us / passes, passes);
+}
+}
+
+int main() {
+    setUp();
+
+    std::vector<uint8_t> data;
+    std::vector<Event> recorded = record(data);
+    CHECK_EQUAL(24 + 10 + 2 + 2, recorded.size());  // Steps, double steps, a press and release on each button
+    CHECK_EQUAL(24 - 20, encoder->getPosition());
+
+    testRoundTrip(data);
+    testReplay(recorded, true);
+    testReplay(recorded, false);
+
+    // Every record but the end marker: the three channels' first values, then each change
+    size_t changes = InputLog::getInstance().getStats().records - 1;
+    benchmark(data, changes);
+
+    InputLog::destroyInstance();
+    IO::destroyInstance();
+    return TEST_RESULT("test_input_log");
+}
@@ -0,0 +1,191 @@
+// LedRing frames for known mixer states, through CaptureFrameSink and RmtFrameSink.
+//
+// The ring is fed the way publishChanges() in main.cpp does: the LED
+// consumer's dirty bit for the channel, then setLevel() with the channel's
+// current level and mute state, then update(). Each captured frame is
+// checked byte by byte against the GRB values for the ring's colors and
+// brightness, including the partly lit LED at the end of the arc.
+//
+// RmtFrameSink runs against support/driver/rmt.h, so the WS2812 bit timing
+// its translator produces and the latch after the tx-end callback are
+// checked too. The benchmark reports the cost of drawing and pushing a frame
+// per animation step, and the wire time those frames take.
+
+#include <Arduino.h>
+#include <chrono>
+#include <driver/rmt.h>
+#include <stdio.h>
+#include "Check.hpp"
+#include "io/CaptureFrameSink.hpp"
+#include "io/LedRing.hpp"
+#include "mixer/Mixer.hpp"
+
+namespace {
+const uint8_t LEDS = 12;
+
+// Config defaults: 0x00FF40 and 0xFF0000 at brightness 64, in GRB
+const uint8_t ARC[3] = {64, 0, 16};
+const uint8_t MUTED_ARC[3] = {0, 64, 0};
+
+// publishChanges()'s LED consumer for one channel
+void feed(LedRing& ring, uint8_t channel) {
+    Mixer& mixer = Mixer::getInstance();
+    if (mixer.takeDirty(Mixer::CONSUMER_LEDS) & (1UL << channel)) {
+        ring.setLevel(mixer.getCurrent(channel), mixer.isMuted(channel));
+        ring.update();
+    }
+}
+
+bool pixelIs(const CaptureFrameSink& sink, uint8_t led, uint8_t green, uint8_t red, uint8_t blue) {
+    const uint8_t* pixel = sink.getFrame() + led * 3;
+    return pixel[0] == green && pixel[1] == red && pixel[2] == blue;
+}
+
+// The first lit LEDs show color, the rest are dark
+bool arcIs(const CaptureFrameSink& sink, uint8_t lit, const uint8_t* color) {
+    for (uint8_t led = 0; led < LEDS; led++) {
+        bool ok = led < lit ? pixelIs(sink, led, color[0], color[1], color[2]) : pixelIs(sink, led, 0, 0, 0);
+        if (!ok) return false;
+    }
+    return true;
+}
+
+void testMixerFrames() {
+    Mixer& mixer = Mixer::getInstance();
+    uint8_t channel = mixer.addChannel(50);
+    mixer.takeDirty(Mixer::CONSUMER_LEDS);
+
+    CaptureFrameSink sink;
+    LedRing ring("ring", sink, LedRing::Config());
+    CHECK(ring.initialize());
+    CHECK_EQUAL(1, sink.getStats().frames);  // The dark frame that clears the ring
+    CHECK_EQUAL(LEDS * 3, sink.getFrameLength());
+    CHECK(arcIs(sink, 0, ARC));
+
+    // Half of 100 on 12 LEDs: six full LEDs
+    mixer.markAllDirty();
+    feed(ring, channel);
+    CHECK_EQUAL(2, sink.getStats().frames);
+    CHECK(arcIs(sink, 6, ARC));
+
+    // 55 lights 6.6 LEDs; the seventh at 153/256 of the color
+    mixer.jumpTo(channel, 55);
+    feed(ring, channel);
+    CHECK(pixelIs(sink, 5, 64, 0, 16));
+    CHECK(pixelIs(sink, 6, 38, 0, 9));
+    CHECK(pixelIs(sink, 7, 0, 0, 0));
+
+    // Mute redraws the same arc in the muted color
+    mixer.jumpTo(channel, 50);
+    mixer.setMuted(channel, true);
+    feed(ring, channel);
+    CHECK(arcIs(sink, 6, MUTED_ARC));
+    CHECK_EQUAL(4, sink.getStats().frames);
+
+    // A change that draws the same frame is not sent
+    mixer.markAllDirty();
+    feed(ring, channel);
+    CHECK_EQUAL(4, sink.getStats().frames);
+
+    // While the sink is busy the newest frame waits, and goes out once it is free
+    mixer.setMuted(channel, false);
+    mixer.jumpTo(channel, 25);
+    sink.holdBusy(true);
+    feed(ring, channel);
+    CHECK(ring.hasPendingOutput());
+    mixer.jumpTo(channel, Mixer::LEVEL_MAX);
+    feed(ring, channel);
+    CHECK_EQUAL(4, sink.getStats().frames);
+    sink.holdBusy(false);
+    ring.update();
+    CHECK(!ring.hasPendingOutput());
+    CHECK_EQUAL(5, sink.getStats().frames);
+    CHECK(arcIs(sink, LEDS, ARC));
+
+    // Shutdown leaves the ring dark
+    ring.shutdown();
+    CHECK(arcIs(sink, 0, ARC));
+}
+
+void testRmtSink() {
+    const rmt_channel_t CHANNEL = RMT_CHANNEL_1;
+    RmtFrameSink sink(26, CHANNEL);
+    CHECK(!sink.write((const uint8_t*)"\x80", 1));  // Not started
+    CHECK(sink.begin());
+    host::advanceMicros(RmtFrameSink::LATCH_MICROS);  // The line has been low since boot
+
+    RmtFrameSink other(27, CHANNEL);
+    CHECK(!other.begin());  // One sink per channel
+
+    LedRing::Config config;
+    config.ledCount = 24;  // 576 bits, so the translator refills the RMT memory several times
+    LedRing ring("rmt_ring", sink, config);
+    ring.setLevel(50);
+    CHECK(ring.initialize());
+    CHECK(sink.isBusy());
+
+    // Bits go out MSB first: 0 is 0.40 us high then 0.85 us low, 1 is 0.80 us then 0.45 us
+    const std::vector<rmt_item32_t>& items = host::rmtItems(CHANNEL);
+    CHECK_EQUAL(24 * 3 * 8, items.size());
+    if (items.size() != 24 * 3 * 8) return;
+    const uint8_t first = ARC[0];  // Green of the first LED
+    bool bitsMatch = true;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+        bool one = first & (0x80 >> bit);
+        const rmt_item32_t& item = items[bit];
+        bitsMatch &= item.level0 == 1 && item.level1 == 0;
+        bitsMatch &= item.duration0 == (one ? 32u : 16u) && item.duration1 == (one ? 18u : 34u);
+    }
+    CHECK(bitsMatch);
+    const rmt_item32_t& dark = items[12 * 3 * 8];  // First bit of the first unlit LED
+    CHECK(dark.duration0 == 16 && dark.duration1 == 34);
+
+    // A new level waits for the frame on the line, then for the latch
+    ring.setLevel(100);
+    ring.update();
+    CHECK(ring.hasPendingOutput());
+    host::rmtFinish(CHANNEL);
+    CHECK(sink.isBusy());
+    host::advanceMicros(RmtFrameSink::LATCH_MICROS);
+    CHECK(!sink.isBusy());
+    ring.update();
+    CHECK(!ring.hasPendingOutput());
+    CHECK_EQUAL(2, ring.getFrameCount());
+
+    ring.shutdown();  // Busy: the ring keeps its last frame
+    CHECK_EQUAL(2, ring.getFrameCount());
+    host::rmtFinish(CHANNEL);
+}
+
+void benchmark() {
+    const int STEPS = 100000;
+    Mixer& mixer = Mixer::getInstance();
+    uint8_t channel = 0;
+
+    CaptureFrameSink sink;
+    LedRing ring("bench_ring", sink, LedRing::Config());
+    ring.initialize();
+
+    // Every step moves the level, as an animation frame does
+    auto start = std::chrono::steady_clock::now();
+    for (int step = 0; step < STEPS; step++) {
+        mixer.jumpTo(channel, step % (Mixer::LEVEL_MAX + 1));
+        feed(ring, channel);
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / STEPS;
+
+    printf("led ring: %.3f us per animation step to draw and push, %u frames, %.0f us on the wire each "
+           "(%u LEDs + latch)\n",
+           us, sink.getStats().frames, (double)sink.getWireMicros() / sink.getStats().frames, LEDS);
+    CHECK(sink.getStats().frames > STEPS / 2);
+}
+}
+
+int main() {
+    testMixerFrames();
+    testRmtSink();
+    benchmark();
+
+    Mixer::destroyInstance();
+    return TEST_RESULT("test_led_ring");
+}
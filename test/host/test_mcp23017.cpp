@@ -0,0 +1,207 @@
+// Mcp23017 and ExpanderEncoder driven through MockI2CBus.
+//
+// The test plays quadrature steps and button presses into the expander's
+// registers, asserts the INT line the way the chip would, and runs the
+// encoder's update(). It checks the decoded position and button state,
+// the register setup, and that nothing touches the bus while INT is idle.
+// It also reports the simulated bus time of each kind of scan at the
+// common I2C clocks, read from getBusMicros() around the scan.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "Check.hpp"
+#include "io/ExpanderEncoder.hpp"
+#include "io/MockI2CBus.hpp"
+
+namespace {
+const uint8_t ADDRESS = 0x21;
+const int INT_PIN = 27;
+const uint8_t PIN_A = 0;
+const uint8_t PIN_B = 1;
+const uint8_t PIN_BUTTON = 8;  // GPB0, so a scan covers both ports
+
+const uint8_t REG_GPINTENA = 0x04;
+const uint8_t REG_IOCON = 0x0A;
+const uint8_t REG_GPPUA = 0x0C;
+const uint8_t REG_INTCAPA = 0x10;
+const uint8_t REG_GPIOA = 0x12;
+
+// Gray code for one detent forward with pullups (both pins high at rest)
+const uint8_t FORWARD[4] = {0b01, 0b00, 0b10, 0b11};
+
+struct Rig {
+    MockI2CBus bus;
+    Mcp23017 expander;
+    ExpanderEncoder encoder;
+    uint16_t port;
+
+    static RotaryEncoder::Config encoderConfig() {
+        RotaryEncoder::Config config;
+        config.pinA = PIN_A;
+        config.pinB = PIN_B;
+        config.buttonPin = PIN_BUTTON;
+        config.hasButton = true;
+        config.enablePullups = true;
+        config.countsPerDetent = 4;
+        config.debounceTime = 5;
+        return config;
+    }
+
+    explicit Rig(uint32_t clockHz)
+        : bus(clockHz), expander(bus, ADDRESS, INT_PIN), encoder("exp_encoder", expander, encoderConfig()),
+          port(0xFFFF) {
+        host::setPin(INT_PIN, HIGH);
+        setPort(port);
+    }
+
+    void setPort(uint16_t value) {
+        bus.setRegister(ADDRESS, REG_GPIOA, value & 0xFF);
+        bus.setRegister(ADDRESS, REG_GPIOA + 1, value >> 8);
+    }
+
+    // Pin changes as the chip reports them: INTCAP holds the port at the first
+    // change, GPIO the port now, and INT stays low until update() reads them
+    void change(uint16_t first, uint16_t now) {
+        bus.setRegister(ADDRESS, REG_INTCAPA, first & 0xFF);
+        bus.setRegister(ADDRESS, REG_INTCAPA + 1, first >> 8);
+        setPort(now);
+        port = now;
+        host::setPin(INT_PIN, LOW);
+    }
+
+    // One update pass; returns the simulated bus time it took
+    uint32_t update() {
+        uint32_t start = bus.getBusMicros();
+        encoder.update();
+        host::setPin(INT_PIN, HIGH);  // The capture read released the line
+        host::advanceMillis(1);
+        return bus.getBusMicros() - start;
+    }
+
+    uint16_t withEncoder(uint8_t state) const {
+        return (port & ~(uint16_t)0b11) | state;
+    }
+};
+
+void testSetupAndDecode() {
+    host::setMillis(1000);
+    Rig rig(MockI2CBus::DEFAULT_CLOCK);
+    CHECK(rig.encoder.initialize());
+
+    // Mirrored open-drain INT, pullups and interrupt-on-change on exactly the claimed pins
+    uint16_t claimed = (1 << PIN_A) | (1 << PIN_B) | (1 << PIN_BUTTON);
+    CHECK_EQUAL(0x44, rig.bus.getRegister(ADDRESS, REG_IOCON));
+    CHECK_EQUAL(claimed & 0xFF, rig.bus.getRegister(ADDRESS, REG_GPINTENA));
+    CHECK_EQUAL(claimed >> 8, rig.bus.getRegister(ADDRESS, REG_GPINTENA + 1));
+    CHECK_EQUAL(claimed & 0xFF, rig.bus.getRegister(ADDRESS, REG_GPPUA));
+    CHECK_EQUAL(0, rig.encoder.getPosition());
+
+    // Two detents forward, one edge per interrupt
+    for (int detent = 0; detent < 2; detent++) {
+        for (uint8_t state : FORWARD) {
+            uint16_t next = rig.withEncoder(state);
+            rig.change(next, next);
+            rig.update();
+        }
+    }
+    CHECK_EQUAL(2, rig.encoder.getPosition());
+
+    // One detent back, two edges per interrupt: INTCAP keeps the first, GPIO has the second
+    for (int i = 3; i >= 0; i -= 2) {
+        uint16_t first = rig.withEncoder(FORWARD[(i + 3) % 4]);
+        uint16_t second = rig.withEncoder(FORWARD[(i + 2) % 4]);
+        rig.change(first, second);
+        rig.update();
+    }
+    CHECK_EQUAL(1, rig.encoder.getPosition());
+
+    // Button press (active low) is debounced from the same scans
+    uint16_t pressed = rig.port & ~(uint16_t)(1 << PIN_BUTTON);
+    rig.change(pressed, pressed);
+    rig.update();
+    for (int i = 0; i < 10; i++) {
+        rig.update();
+    }
+    CHECK(rig.encoder.isButtonPressed());
+    CHECK_EQUAL(1, rig.encoder.getPosition());
+
+    // While INT is idle and the safety scan is not due, no pass touches the bus
+    uint32_t reads = rig.bus.getStats().reads;
+    for (int i = 0; i < 20; i++) {
+        rig.update();
+    }
+    CHECK(rig.bus.getStats().reads - reads <= 1);
+    CHECK_EQUAL(0, rig.expander.getStats().failedReads);
+}
+
+// Bus time per scan at a given clock, against the framing MockI2CBus models
+void reportScanCost(uint32_t clockHz) {
+    host::setMillis(5000);
+    Rig rig(clockHz);
+    CHECK(rig.encoder.initialize());
+    rig.update();
+
+    const int SCANS = 100;
+    uint32_t interruptMicros = 0;
+    for (int i = 0; i < SCANS; i++) {
+        uint16_t next = rig.withEncoder(FORWARD[i % 4]);
+        rig.change(next, next);
+        interruptMicros += rig.update();
+    }
+
+    uint32_t idleMicros = 0;
+    int idleScans = 0;
+    for (int i = 0; i < SCANS; i++) {
+        host::advanceMillis(Mcp23017::DEFAULT_POLL_INTERVAL);
+        uint32_t micros = rig.update();
+        if (micros) {
+            idleMicros += micros;
+            idleScans++;
+        }
+    }
+
+    // Capture scan: address, register, address again, 4 data bytes. Safety scan: the same with 2 data bytes.
+    uint32_t expectedInterrupt = (uint32_t)((7 * 9 + 2) * 1000000ULL / clockHz);
+    uint32_t expectedIdle = (uint32_t)((5 * 9 + 2) * 1000000ULL / clockHz);
+    printf("mcp23017 @ %4u kHz: %3u us per INT scan (4-byte burst), %3u us per safety scan, %d safety scans\n",
+           (unsigned)(clockHz / 1000), (unsigned)(interruptMicros / SCANS),
+           (unsigned)(idleScans ? idleMicros / idleScans : 0), idleScans);
+
+    CHECK_EQUAL(SCANS / 4, rig.encoder.getPosition());
+    CHECK_EQUAL(SCANS, idleScans);
+    CHECK(interruptMicros / SCANS >= expectedInterrupt - 1 && interruptMicros / SCANS <= expectedInterrupt + 1);
+    CHECK(idleMicros / SCANS >= expectedIdle - 1 && idleMicros / SCANS <= expectedIdle + 1);
+}
+
+// A NACKed capture read is counted and the next interrupt recovers
+void testFailedRead() {
+    host::setMillis(9000);
+    Rig rig(MockI2CBus::DEFAULT_CLOCK);
+    CHECK(rig.encoder.initialize());
+
+    uint16_t next = rig.withEncoder(FORWARD[0]);
+    rig.change(next, next);
+    rig.bus.failNextTransaction();
+    rig.update();
+    CHECK_EQUAL(1, rig.expander.getStats().failedReads);
+
+    // The line is still low on the real chip until a read succeeds
+    host::setPin(INT_PIN, LOW);
+    rig.update();
+    for (int i = 1; i < 4; i++) {
+        next = rig.withEncoder(FORWARD[i]);
+        rig.change(next, next);
+        rig.update();
+    }
+    CHECK_EQUAL(1, rig.encoder.getPosition());
+}
+}
+
+int main() {
+    testSetupAndDecode();
+    reportScanCost(100000);
+    reportScanCost(400000);
+    reportScanCost(1000000);
+    testFailedRead();
+    return TEST_RESULT("test_mcp23017");
+}
@@ -0,0 +1,181 @@
+// Mixer: dirty tracking per consumer, and 16 channels updated at 1 kHz.
+//
+// Each channel is bound to its own encoder, as on the device. An encoder
+// here is a RotaryEncoder whose hardware count the test sets. A detent step
+// then runs the same path as the PCNT counter does: update() sees the step
+// and calls Mixer::adjustTarget() through the bound callback.
+//
+// The benchmark runs the control loop's mixer work for one simulated minute
+// at 1 kHz. On every tick all 16 encoders step, the animation advances by
+// 1 ms, and the consumers take their dirty bits the way publishChanges() in
+// main.cpp does: UI publishes the snapshot, serial and LEDs read the
+// channels they were told about. It reports the cost per tick against the
+// 1 ms budget.
+
+#include <Arduino.h>
+#include <chrono>
+#include <memory>
+#include <stdio.h>
+#include "Check.hpp"
+#include "mixer/Mixer.hpp"
+
+namespace {
+const uint8_t CHANNELS = Mixer::MAX_CHANNELS;
+const uint32_t ALL_CHANNELS = (1UL << CHANNELS) - 1;
+
+class TestEncoder : public RotaryEncoder {
+   public:
+    TestEncoder(const DeviceId& id, const Config& config) : RotaryEncoder(id, config) {}
+    void step(int detents) { count += detents; }
+
+   protected:
+    int64_t readHardwareCount() const override { return count; }
+    void writeHardwareCount(int64_t value) override { count = value; }
+
+   private:
+    int64_t count = 0;
+};
+
+std::unique_ptr<TestEncoder> encoders[CHANNELS];
+
+void setUp(Mixer& mixer) {
+    RotaryEncoder::Config config;
+    config.hasButton = false;
+    for (uint8_t channel = 0; channel < CHANNELS; channel++) {
+        char id[DeviceId::MAX_LENGTH + 1];
+        snprintf(id, sizeof(id), "encoder_%u", channel);
+        encoders[channel].reset(new TestEncoder(id, config));
+        encoders[channel]->initialize();
+
+        CHECK_EQUAL(channel, mixer.addChannel(50));
+        CHECK(mixer.bindEncoder(channel, encoders[channel].get()));
+    }
+    CHECK_EQUAL(-1, mixer.addChannel());
+}
+
+// The consumer side of publishChanges(); returns a checksum so the reads are not optimised away
+uint32_t consume(Mixer& mixer, uint32_t& uiMask, uint32_t& serialMask, uint32_t& ledMask) {
+    uint32_t sum = 0;
+
+    uiMask = mixer.takeDirty(Mixer::CONSUMER_UI);
+    if (uiMask != 0) mixer.publish();
+
+    serialMask = mixer.takeDirty(Mixer::CONSUMER_SERIAL);
+    for (uint32_t pending = serialMask; pending != 0; pending &= pending - 1) {
+        uint8_t channel = __builtin_ctz(pending);
+        sum += mixer.getTarget(channel) + (mixer.isMuted(channel) ? 1 : 0);
+    }
+
+    ledMask = mixer.takeDirty(Mixer::CONSUMER_LEDS);
+    for (uint32_t pending = ledMask; pending != 0; pending &= pending - 1) {
+        sum += mixer.getCurrent(__builtin_ctz(pending));
+    }
+    return sum;
+}
+
+void testDirtyTracking(Mixer& mixer) {
+    uint32_t ui, serial, leds;
+    consume(mixer, ui, serial, leds);
+    CHECK_EQUAL(ALL_CHANNELS, ui);  // New channels are reported to everyone
+    mixer.takeDirty(Mixer::CONSUMER_STORAGE);
+
+    // An encoder step reaches its channel's target and every consumer
+    encoders[5]->step(3);
+    encoders[5]->update();
+    CHECK_EQUAL(53, mixer.getTarget(5));
+    for (uint8_t consumer = 0; consumer < Mixer::CONSUMER_COUNT; consumer++) {
+        CHECK_EQUAL(1UL << 5, mixer.peekDirty((Mixer::Consumer)consumer));
+    }
+
+    // Taking one consumer's bits leaves the others alone
+    CHECK_EQUAL(1UL << 5, mixer.takeDirty(Mixer::CONSUMER_SERIAL));
+    CHECK_EQUAL(0, mixer.peekDirty(Mixer::CONSUMER_SERIAL));
+    CHECK_EQUAL(1UL << 5, mixer.peekDirty(Mixer::CONSUMER_STORAGE));
+    consume(mixer, ui, serial, leds);
+    mixer.takeDirty(Mixer::CONSUMER_STORAGE);
+
+    // Animation frames only concern the consumers that draw
+    CHECK(mixer.isAnimating());
+    uint32_t moved = mixer.animate(5);
+    CHECK_EQUAL(1UL << 5, moved);
+    CHECK_EQUAL(moved, mixer.peekDirty(Mixer::CONSUMER_UI));
+    CHECK_EQUAL(moved, mixer.peekDirty(Mixer::CONSUMER_LEDS));
+    CHECK_EQUAL(0, mixer.peekDirty(Mixer::CONSUMER_SERIAL));
+    CHECK_EQUAL(0, mixer.peekDirty(Mixer::CONSUMER_STORAGE));
+    mixer.animate(1000);
+    CHECK(!mixer.isAnimating());
+    CHECK_EQUAL(53, mixer.getCurrent(5));
+
+    // Mute and clamping
+    mixer.toggleMute(2);
+    CHECK(mixer.isMuted(2));
+    CHECK_EQUAL(1UL << 2, mixer.getMuteMask());
+    encoders[2]->step(500);
+    encoders[2]->update();
+    CHECK_EQUAL(Mixer::LEVEL_MAX, mixer.getTarget(2));
+    mixer.jumpTo(2, 50);
+    mixer.setMuted(2, false);
+    CHECK_EQUAL(50, mixer.getCurrent(2));
+
+    // The published copy matches the table
+    consume(mixer, ui, serial, leds);
+    mixer.takeDirty(Mixer::CONSUMER_STORAGE);
+    Mixer::Snapshot snapshot;
+    CHECK(mixer.readSnapshot(snapshot));
+    CHECK_EQUAL(CHANNELS, snapshot.channelCount);
+    CHECK_EQUAL(53, snapshot.target[5]);
+    CHECK_EQUAL(53, snapshot.current[5]);
+    CHECK_EQUAL(0, snapshot.muteMask);
+}
+
+void benchmark(Mixer& mixer) {
+    const int TICKS = 60000;  // One minute at 1 kHz
+    uint32_t ui, serial, leds;
+    uint32_t checksum = 0;
+    int missed = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < TICKS; tick++) {
+        // Every channel moves one detent, back and forth so none sits at a limit
+        int direction = (tick & 1) ? -1 : 1;
+        for (uint8_t channel = 0; channel < CHANNELS; channel++) {
+            encoders[channel]->step(direction);
+            encoders[channel]->update();
+        }
+        mixer.animate(1);
+        checksum += consume(mixer, ui, serial, leds);
+        if (serial != ALL_CHANNELS || ui != ALL_CHANNELS) missed++;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double tickUs = seconds * 1e6 / TICKS;
+
+    // The mixer alone, without the encoder path
+    start = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < TICKS; tick++) {
+        int level = 40 + (tick & 7);
+        for (uint8_t channel = 0; channel < CHANNELS; channel++) {
+            mixer.setTarget(channel, level);
+        }
+        mixer.animate(1);
+        checksum += consume(mixer, ui, serial, leds);
+    }
+    double mixerUs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1e6 / TICKS;
+
+    printf("mixer: 16 channels at 1 kHz, %.2f us per tick with encoders (%.1f%% of the 1 ms budget), "
+           "%.2f us mixer only, %.0f ns per channel update (checksum %u)\n",
+           tickUs, tickUs / 10.0, mixerUs, mixerUs * 1000 / CHANNELS, checksum);
+
+    CHECK_EQUAL(0, missed);
+    CHECK(tickUs < 1000);
+}
+}
+
+int main() {
+    Mixer& mixer = Mixer::getInstance();
+    setUp(mixer);
+    testDirtyTracking(mixer);
+    benchmark(mixer);
+
+    Mixer::destroyInstance();
+    return TEST_RESULT("test_mixer");
+}
@@ -0,0 +1,189 @@
+// MqttPublisher: coalescing and the offline queue against a broker stand-in.
+//
+// The publisher under test is the firmware's own: update(), flush() and
+// their topic and payload formatting run unchanged. Only the session is
+// replaced. support/PubSubClient.h hands it to host::mqttBroker(), which
+// keeps retained topics, can go offline, and can cut the session after a
+// given number of publishes. The fake clock drives the publisher's
+// schedule: a flush per publish interval while the session is up, a
+// reconnect attempt per reconnect interval while it is down, and a flush
+// right after reconnecting.
+//
+// The benchmark reports the cost of setChannelValue() and of a flush, and
+// how many publishes a fast spin turns into at the default interval.
+
+#include <Arduino.h>
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include "Check.hpp"
+#include "network/MqttPublisher.hpp"
+#include "network/Network.hpp"
+
+namespace {
+const unsigned long PUBLISH_INTERVAL = 100;     // MqttPublisher's default coalescing window
+const unsigned long RECONNECT_INTERVAL = 5000;  // MqttPublisher's default
+
+host::MqttBroker& broker() {
+    return host::mqttBroker();
+}
+
+std::string retained(uint8_t channel) {
+    return broker().value("unimix/channel/" + std::to_string(channel));
+}
+
+// A fresh publisher and broker, with the session opened by the first update
+MqttPublisher& start() {
+    MqttPublisher::destroyInstance();
+    broker() = host::MqttBroker();
+
+    MqttPublisher& publisher = MqttPublisher::getInstance();
+    publisher.setBroker("127.0.0.1", 1883);
+    publisher.initialize();
+    publisher.update();
+    return publisher;
+}
+
+// One encoder step per millisecond on a channel, with the publisher serviced every millisecond
+void spin(MqttPublisher& publisher, uint8_t channel, int steps, int& value) {
+    for (int ms = 0; ms < steps; ms++) {
+        host::advanceMillis(1);
+        publisher.setChannelValue(channel, ++value);
+        publisher.update();
+    }
+}
+
+void testCoalescing() {
+    MqttPublisher& publisher = start();
+    CHECK(publisher.isConnected());
+    int value = 0;
+
+    // A one-second spin of 1000 steps becomes ten publishes, the last with the final value
+    spin(publisher, 3, 1000, value);
+    CHECK_EQUAL(10, broker().publishes);
+    CHECK_EQUAL(10, publisher.getPublishCount());
+    CHECK_EQUAL(990, publisher.getCoalescedCount());
+    CHECK(retained(3) == "1000");
+    CHECK_EQUAL(0, publisher.getPendingCount());
+
+    // Nothing queued, nothing sent
+    host::advanceMillis(PUBLISH_INTERVAL);
+    publisher.update();
+    CHECK_EQUAL(10, broker().publishes);
+
+    // Out-of-range channels are ignored
+    publisher.setChannelValue(MqttPublisher::MAX_CHANNELS, 1);
+    CHECK_EQUAL(0, publisher.getPendingCount());
+}
+
+void testOffline() {
+    MqttPublisher& publisher = start();
+    broker().online = false;
+
+    // Ten seconds offline with every channel moving: one value per channel is held
+    int values[MqttPublisher::MAX_CHANNELS] = {};
+    for (int ms = 0; ms < 10000; ms++) {
+        host::advanceMillis(1);
+        uint8_t channel = ms % MqttPublisher::MAX_CHANNELS;
+        publisher.setChannelValue(channel, values[channel] += 3);
+        publisher.update();
+        CHECK(publisher.getPendingCount() <= MqttPublisher::MAX_CHANNELS);
+    }
+    CHECK(!publisher.isConnected());
+    CHECK_EQUAL(MqttPublisher::MAX_CHANNELS, publisher.getPendingCount());
+    CHECK_EQUAL(0, broker().publishes);
+
+    // Broker back: the next reconnect attempt publishes each channel once, with its latest value
+    broker().online = true;
+    for (unsigned long ms = 0; ms < RECONNECT_INTERVAL && !publisher.isConnected(); ms++) {
+        host::advanceMillis(1);
+        publisher.update();
+    }
+    CHECK(publisher.isConnected());
+    CHECK_EQUAL(2, broker().connects);
+    CHECK_EQUAL(MqttPublisher::MAX_CHANNELS, broker().publishes);
+    for (uint8_t channel = 0; channel < MqttPublisher::MAX_CHANNELS; channel++) {
+        CHECK(retained(channel) == std::to_string(values[channel]));
+    }
+    CHECK_EQUAL(0, publisher.getPendingCount());
+}
+
+void testDropMidFlush() {
+    MqttPublisher& publisher = start();
+    for (uint8_t channel = 0; channel < 6; channel++) {
+        publisher.setChannelValue(channel, 100 + channel);
+    }
+
+    // The session dies after two publishes: the rest, including the failed one, stay queued
+    broker().dropAfter = 2;
+    host::advanceMillis(PUBLISH_INTERVAL);
+    publisher.update();
+    CHECK_EQUAL(2, publisher.getPublishCount());
+    CHECK_EQUAL(1, publisher.getFailedCount());
+    CHECK_EQUAL(4, publisher.getPendingCount());
+    CHECK(!publisher.isConnected());
+    CHECK(retained(1) == "101");
+    CHECK(retained(2) == "");
+
+    // A newer value for a waiting channel replaces the old one before the retry
+    publisher.setChannelValue(4, 999);
+    broker().online = true;
+    broker().dropAfter = -1;
+    host::advanceMillis(RECONNECT_INTERVAL);
+    publisher.update();
+    CHECK_EQUAL(6, publisher.getPublishCount());
+    CHECK(retained(2) == "102");
+    CHECK(retained(4) == "999");
+    CHECK(retained(5) == "105");
+    CHECK_EQUAL(6, broker().publishes);
+}
+
+void benchmark() {
+    const int SETS = 10000000;
+    MqttPublisher& publisher = start();
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < SETS; i++) {
+        publisher.setChannelValue(i & 7, i);
+    }
+    double setNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / SETS;
+
+    // Full flushes of every channel through the stand-in, topic and payload formatting included
+    const int FLUSHES = 100000;
+    double seconds = 0;
+    for (int i = 0; i < FLUSHES; i++) {
+        for (uint8_t channel = 0; channel < MqttPublisher::MAX_CHANNELS; channel++) {
+            publisher.setChannelValue(channel, i);
+        }
+        host::advanceMillis(PUBLISH_INTERVAL);
+        begin = std::chrono::steady_clock::now();
+        publisher.update();
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+    unsigned long flushed = broker().publishes;
+
+    // A spin at 1 kHz for a minute, against one publish per change without coalescing
+    MqttPublisher& spinning = start();
+    int value = 0;
+    spin(spinning, 0, 60000, value);
+
+    printf("mqtt publisher: %.1f ns per set, %.0f publishes/s through the stand-in (%.2f us per 16-channel "
+           "flush), 60 s spin at 1 kHz: %lu publishes for 60000 changes\n",
+           setNs, flushed / seconds, seconds * 1e6 / FLUSHES, broker().publishes);
+
+    CHECK(flushed >= (unsigned long)FLUSHES * MqttPublisher::MAX_CHANNELS);
+    CHECK_EQUAL(600, broker().publishes);
+    CHECK(retained(0) == "60000");
+}
+}
+
+int main() {
+    Network::getInstance();  // The stub's link is up, so the publisher opens sessions
+
+    testCoalescing();
+    testOffline();
+    testDropMidFlush();
+    benchmark();
+
+    MqttPublisher::destroyInstance();
+    return TEST_RESULT("test_publish_queue");
+}
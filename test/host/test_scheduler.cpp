@@ -0,0 +1,147 @@
+// Scheduler: jobs that cancel or reschedule other jobs due on the same tick.
+//
+// expireSlot() takes a whole wheel slot off before running it. A callback
+// that cancels a job still waiting in that batch must stop it from running,
+// and must not corrupt the wheel for the jobs after it.
+
+#include <Arduino.h>
+#include "Check.hpp"
+#include "core/Scheduler.hpp"
+
+namespace {
+struct Counter {
+    int runs = 0;
+    int target = Scheduler::INVALID_JOB;  // Job the callback acts on during its first run
+};
+
+Counter a, b, c;
+
+void count(void* context) {
+    static_cast<Counter*>(context)->runs++;
+}
+
+void countAndCancel(void* context) {
+    Counter* counter = static_cast<Counter*>(context);
+    if (counter->runs++ == 0) {
+        Scheduler::getInstance().cancel(counter->target);
+    }
+}
+
+void countAndReschedule(void* context) {
+    Counter* counter = static_cast<Counter*>(context);
+    if (counter->runs++ == 0) {
+        Scheduler::getInstance().reschedule(counter->target, 5);
+    }
+}
+
+void runFor(unsigned long ms) {
+    for (unsigned long i = 0; i < ms; i++) {
+        host::advanceMillis(1);
+        Scheduler::getInstance().run();
+    }
+}
+
+void reset() {
+    Scheduler::destroyInstance();
+    host::setMillis(1000);
+    a = Counter();
+    b = Counter();
+    c = Counter();
+}
+
+// Slot lists are LIFO, so adding C, B, A runs A first on each shared tick
+void testCancelSameTick() {
+    reset();
+    Scheduler& scheduler = Scheduler::getInstance();
+    int jobC = scheduler.addPeriodic("c", 10, count, &c);
+    int jobB = scheduler.addPeriodic("b", 10, count, &b);
+    a.target = jobB;
+    int jobA = scheduler.addPeriodic("a", 10, countAndCancel, &a);
+    CHECK(jobA != Scheduler::INVALID_JOB && jobC != Scheduler::INVALID_JOB);
+
+    runFor(100);
+    CHECK_EQUAL(10, a.runs);
+    CHECK_EQUAL(0, b.runs);
+    CHECK_EQUAL(10, c.runs);
+    CHECK(!scheduler.isScheduled(jobB));
+    CHECK(scheduler.isScheduled(jobC));
+}
+
+// The cancelled job's pool entry can be reused while the batch is still running
+void testCancelAndReuseSameTick() {
+    reset();
+    Scheduler& scheduler = Scheduler::getInstance();
+    scheduler.addPeriodic("c", 10, count, &c);
+    int jobB = scheduler.addPeriodic("b", 10, count, &b);
+    a.target = jobB;
+    scheduler.addPeriodic("a", 10, countAndCancel, &a);
+
+    runFor(10);
+    Counter d;
+    int jobD = scheduler.addPeriodic("d", 10, count, &d);
+    CHECK_EQUAL(jobB, jobD);
+
+    runFor(90);
+    CHECK_EQUAL(10, a.runs);
+    CHECK_EQUAL(0, b.runs);
+    CHECK_EQUAL(10, c.runs);
+    CHECK_EQUAL(9, d.runs);
+}
+
+// A job moved off the expiring tick runs at its new deadline instead, once
+void testRescheduleSameTick() {
+    reset();
+    Scheduler& scheduler = Scheduler::getInstance();
+    scheduler.addPeriodic("c", 10, count, &c);
+    int jobB = scheduler.addOneShot("b", 10, count, &b);
+    a.target = jobB;
+    scheduler.addPeriodic("a", 10, countAndReschedule, &a);
+
+    runFor(10);
+    CHECK_EQUAL(1, a.runs);
+    CHECK_EQUAL(0, b.runs);
+    CHECK_EQUAL(1, c.runs);
+    CHECK(scheduler.isScheduled(jobB));
+
+    runFor(5);
+    CHECK_EQUAL(1, b.runs);
+    CHECK(!scheduler.isScheduled(jobB));
+
+    runFor(85);
+    CHECK_EQUAL(10, a.runs);
+    CHECK_EQUAL(1, b.runs);
+    CHECK_EQUAL(10, c.runs);
+}
+
+// A job cancelling itself or a job that already ran this tick
+void testCancelRanJob() {
+    reset();
+    Scheduler& scheduler = Scheduler::getInstance();
+    int jobC = scheduler.addPeriodic("c", 10, countAndCancel, &c);
+    int jobA = scheduler.addPeriodic("a", 10, count, &a);
+    c.target = jobA;
+    scheduler.addPeriodic("b", 10, count, &b);
+
+    runFor(100);
+    CHECK_EQUAL(1, a.runs);
+    CHECK_EQUAL(10, b.runs);
+    CHECK_EQUAL(10, c.runs);
+    CHECK(!scheduler.isScheduled(jobA));
+
+    // Then c cancels itself from its own callback
+    c.runs = 0;
+    c.target = jobC;
+    runFor(100);
+    CHECK_EQUAL(1, c.runs);
+    CHECK_EQUAL(20, b.runs);
+    CHECK(scheduler.getNextDeadline() <= 10);
+}
+}
+
+int main() {
+    testCancelSameTick();
+    testCancelAndReuseSameTick();
+    testRescheduleSameTick();
+    testCancelRanJob();
+    return TEST_RESULT("test_scheduler");
+}
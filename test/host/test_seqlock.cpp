@@ -0,0 +1,112 @@
+// Seqlock: torn-read stress test.
+//
+// One thread publishes snapshots as fast as it can while a reader on another
+// thread copies them. Every snapshot carries a serial number, payload words
+// derived from it and a checksum, so a copy mixing two writes is caught.
+// Serial numbers must also never go backwards for the reader. The run is
+// timed rather than counted so that a single-CPU host, where the threads
+// only meet at preemption points, still gets many of them.
+
+#include <chrono>
+#include <thread>
+#include <stdio.h>
+#include "Check.hpp"
+#include "core/Seqlock.hpp"
+
+namespace {
+const double RUN_SECONDS = 1.0;
+const uint32_t CLOCK_CHECK_WRITES = 1024;  // Writes between looks at the clock
+const size_t PAYLOAD_WORDS = 8;  // With serial and checksum, the 40 bytes of Mixer::Snapshot
+
+struct Snapshot {
+    uint32_t serial;
+    uint32_t payload[PAYLOAD_WORDS];
+    uint32_t checksum;
+};
+
+uint32_t checksumOf(const Snapshot& snapshot) {
+    uint32_t sum = 0x9E3779B9u ^ snapshot.serial;
+    for (size_t i = 0; i < PAYLOAD_WORDS; i++) {
+        sum = (sum ^ snapshot.payload[i]) * 16777619u;
+    }
+    return sum;
+}
+
+Snapshot make(uint32_t serial) {
+    Snapshot snapshot;
+    snapshot.serial = serial;
+    for (size_t i = 0; i < PAYLOAD_WORDS; i++) {
+        snapshot.payload[i] = serial * 2654435761u + (uint32_t)i;
+    }
+    snapshot.checksum = checksumOf(snapshot);
+    return snapshot;
+}
+
+Seqlock<Snapshot> shared;
+std::atomic<bool> writing(true);
+
+struct ReaderResult {
+    uint64_t reads = 0;
+    uint64_t clean = 0;
+    uint64_t torn = 0;
+    uint64_t backwards = 0;
+    uint64_t distinct = 0;
+};
+
+void reader(ReaderResult& result) {
+    Snapshot copy = make(0);
+    uint32_t lastSerial = 0;
+    while (writing.load(std::memory_order_relaxed)) {
+        result.reads++;
+        if (!shared.read(copy)) continue;
+        result.clean++;
+
+        if (copy.checksum != checksumOf(copy)) {
+            result.torn++;
+        }
+        if (copy.serial < lastSerial) {
+            result.backwards++;
+        } else if (copy.serial > lastSerial) {
+            result.distinct++;
+        }
+        lastSerial = copy.serial;
+    }
+}
+}
+
+int main() {
+    shared.write(make(0));
+
+    ReaderResult result;
+    std::thread readerThread(reader, std::ref(result));
+
+    auto start = std::chrono::steady_clock::now();
+    uint32_t writes = 0;
+    double seconds = 0;
+    while (seconds < RUN_SECONDS) {
+        for (uint32_t i = 0; i < CLOCK_CHECK_WRITES; i++) {
+            shared.write(make(++writes));
+        }
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    writing = false;
+    readerThread.join();
+
+    printf("seqlock: %u writes in %.2f s, %llu reads, %llu clean (%llu distinct snapshots), %llu given up\n",
+           (unsigned)writes, seconds, (unsigned long long)result.reads, (unsigned long long)result.clean,
+           (unsigned long long)result.distinct, (unsigned long long)(result.reads - result.clean));
+
+    CHECK_EQUAL(0, result.torn);
+    CHECK_EQUAL(0, result.backwards);
+    CHECK(result.distinct > 1);
+    CHECK_EQUAL(writes, shared.getVersion() - 1);
+
+    // A final read after the writer stopped sees the last value
+    Snapshot last = make(0);
+    CHECK(shared.read(last));
+    CHECK_EQUAL(writes, last.serial);
+    CHECK_EQUAL(checksumOf(last), last.checksum);
+
+    return TEST_RESULT("test_seqlock");
+}
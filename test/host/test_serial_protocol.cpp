@@ -0,0 +1,385 @@
+// SerialProtocol and HostDecoder: framing checks and a pseudo-terminal run.
+//
+// The first part checks the pieces on their own: the CRC against the
+// CRC-16/CCITT-FALSE check value, COBS round trips over random payloads
+// heavy in zero bytes and across the 254-byte block boundary, corrupted
+// frames and log text between frames, and HostDecoder's channel mirror,
+// ack queue, telemetry reports and command encoding against the
+// device-side FrameDecoder.
+//
+// The second part streams snapshot and delta frames, built the way
+// SerialLink builds them, through a raw pty from a writer thread. The
+// reader feeds whatever read() returns to a HostDecoder and the test
+// reports frames and bytes per second. It also reports how many frames per
+// second the same stream would fit into at the UART baud rates.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pty.h>
+#include <stdio.h>
+#include <termios.h>
+#include <unistd.h>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include "Check.hpp"
+#include "protocol/HostDecoder.hpp"
+
+using namespace SerialProtocol;
+
+namespace {
+const uint8_t CHANNELS = 8;
+
+void testCrc() {
+    const char* check = "123456789";
+    CHECK_EQUAL(0x29B1, crc16((const uint8_t*)check, 9));
+    CHECK_EQUAL(0xFFFF, crc16(nullptr, 0));
+
+    // Incremental and one-shot agree
+    CHECK_EQUAL(0x29B1, crc16((const uint8_t*)check + 4, 5, crc16((const uint8_t*)check, 4)));
+}
+
+bool roundTrip(const std::vector<uint8_t>& input) {
+    std::vector<uint8_t> encoded(input.size() + input.size() / 254 + 1);
+    size_t encodedLength = cobsEncode(input.data(), input.size(), encoded.data(), encoded.size());
+    if (encodedLength == 0) return false;
+    for (size_t i = 0; i < encodedLength; i++) {
+        if (encoded[i] == 0) return false;
+    }
+
+    std::vector<uint8_t> decoded(input.size() + 1);
+    size_t decodedLength = cobsDecode(encoded.data(), encodedLength, decoded.data(), decoded.size());
+    decoded.resize(decodedLength);
+    return decoded == input;
+}
+
+void testCobs() {
+    std::mt19937 random(12345);
+
+    // Edge cases: empty, lone zeros, and runs either side of the 254-byte block
+    CHECK(roundTrip({}));
+    CHECK(roundTrip({0}));
+    CHECK(roundTrip({0, 0, 0}));
+    for (size_t length : {253, 254, 255, 508, 509}) {
+        CHECK(roundTrip(std::vector<uint8_t>(length, 0x5A)));
+        std::vector<uint8_t> trailingZero(length, 0x5A);
+        trailingZero.back() = 0;
+        CHECK(roundTrip(trailingZero));
+    }
+
+    // Random payloads, about one byte in four a zero
+    int failures = 0;
+    for (int i = 0; i < 5000; i++) {
+        std::vector<uint8_t> input(random() % 600);
+        for (uint8_t& byte : input) {
+            byte = random() % 4 == 0 ? 0 : (uint8_t)random();
+        }
+        if (!roundTrip(input)) failures++;
+    }
+    CHECK_EQUAL(0, failures);
+
+    // Too small an output buffer is refused rather than overrun
+    uint8_t input[10] = {1, 2, 3};
+    uint8_t out[10];
+    CHECK_EQUAL(0, cobsEncode(input, sizeof(input), out, sizeof(input)));
+
+    // A code byte that runs past the end is malformed
+    uint8_t truncated[] = {5, 1, 2};
+    CHECK_EQUAL(0, cobsDecode(truncated, sizeof(truncated), out, sizeof(out)));
+}
+
+// Device-side frame builders, as SerialLink writes them
+size_t buildSnapshot(FrameWriter& writer, uint8_t seq, const ChannelState* states, uint8_t count, uint8_t* out) {
+    writer.begin(MSG_SNAPSHOT, seq);
+    writer.put(count);
+    for (uint8_t channel = 0; channel < count; channel++) {
+        writer.putState(states[channel]);
+    }
+    return writer.finish(out, MAX_ENCODED);
+}
+
+size_t buildDelta(FrameWriter& writer, uint8_t seq, const ChannelState* states, uint32_t mask, uint8_t* out) {
+    writer.begin(MSG_DELTA, seq);
+    writer.put(0);
+    uint8_t count = 0;
+    while (mask) {
+        uint8_t channel = __builtin_ctz(mask);
+        mask &= mask - 1;
+        writer.put(channel);
+        writer.putState(states[channel]);
+        count++;
+    }
+    writer.patch(0, count);
+    return writer.finish(out, MAX_ENCODED);
+}
+
+struct Command {
+    uint8_t type;
+    uint8_t seq;
+    uint8_t payload[2];
+    size_t length;
+};
+
+void captureCommand(uint8_t type, uint8_t seq, const uint8_t* payload, size_t length, void* context) {
+    Command* command = static_cast<Command*>(context);
+    command->type = type;
+    command->seq = seq;
+    command->length = length;
+    memcpy(command->payload, payload, length < 2 ? length : 2);
+}
+
+void testHostDecoder() {
+    FrameWriter writer;
+    HostDecoder host;
+    uint8_t frame[MAX_ENCODED];
+    ChannelState states[CHANNELS];
+    for (uint8_t i = 0; i < CHANNELS; i++) {
+        states[i] = {(uint8_t)(i * 10), (uint8_t)(i * 5), (uint8_t)(i & 1 ? FLAG_MUTED : 0)};
+    }
+
+    // Log text before the first frame is counted as one bad frame and does no harm
+    const char* text = "Boot: ready\r\n";
+    host.feed((const uint8_t*)text, strlen(text));
+    size_t length = buildSnapshot(writer, 0, states, CHANNELS, frame);
+    host.feed(frame, length);
+    CHECK(host.hasSnapshot());
+    CHECK_EQUAL(CHANNELS, host.getChannelCount());
+    CHECK_EQUAL(30, host.getChannel(3).target);
+    CHECK_EQUAL(FLAG_MUTED, host.getChannel(3).flags);
+    CHECK_EQUAL(1, host.getFrameStats().badFrames);
+
+    // A delta touches only its channels
+    states[2].target = 99;
+    states[5].flags = 0;
+    length = buildDelta(writer, 1, states, (1 << 2) | (1 << 5), frame);
+    host.feed(frame, length);
+    CHECK_EQUAL(99, host.getChannel(2).target);
+    CHECK_EQUAL(0, host.getChannel(5).flags);
+    CHECK_EQUAL(40, host.getChannel(4).target);
+    CHECK_EQUAL(1, host.getStats().deltas);
+
+    // A flipped bit fails the CRC and leaves the mirror alone
+    states[2].target = 7;
+    length = buildDelta(writer, 2, states, 1 << 2, frame);
+    frame[6] ^= 0x01;  // The target byte
+    host.feed(frame, length);
+    CHECK_EQUAL(1, host.getFrameStats().crcErrors);
+    CHECK_EQUAL(99, host.getChannel(2).target);
+
+    // The next frame after the lost one is flagged as a gap
+    writer.begin(MSG_ACK, 3);
+    writer.put(0x42);
+    writer.put(ACK_BAD_CHANNEL);
+    length = writer.finish(frame, sizeof(frame));
+    host.feed(frame, length);
+    CHECK_EQUAL(1, host.getStats().seqGaps);
+    HostDecoder::Ack ack = {};
+    CHECK(host.takeAck(ack));
+    CHECK_EQUAL(0x42, ack.commandSeq);
+    CHECK_EQUAL(ACK_BAD_CHANNEL, ack.status);
+    CHECK(!host.takeAck(ack));
+
+    // A snapshot claiming more channels than it carries is rejected
+    writer.begin(MSG_SNAPSHOT, 4);
+    writer.put(CHANNELS);
+    writer.putState(states[0]);
+    length = writer.finish(frame, sizeof(frame));
+    host.feed(frame, length);
+    CHECK_EQUAL(1, host.getStats().badMessages);
+    CHECK_EQUAL(1, host.getStats().snapshots);
+
+    // Commands decode on the device side with a fresh seq each
+    Command command = {};
+    FrameDecoder device(captureCommand, &command);
+    length = host.setTarget(3, 200, frame, sizeof(frame));
+    device.feed(frame, length);
+    CHECK_EQUAL(CMD_SET_TARGET, command.type);
+    CHECK_EQUAL(host.getLastCommandSeq(), command.seq);
+    CHECK_EQUAL(2, command.length);
+    CHECK_EQUAL(3, command.payload[0]);
+    CHECK_EQUAL(200, command.payload[1]);
+
+    uint8_t firstSeq = command.seq;
+    length = host.setMute(1, true, frame, sizeof(frame));
+    device.feed(frame, length);
+    CHECK_EQUAL(CMD_SET_MUTE, command.type);
+    CHECK_EQUAL((uint8_t)(firstSeq + 1), command.seq);
+    CHECK_EQUAL(1, command.payload[1]);
+
+    length = host.requestSnapshot(frame, sizeof(frame));
+    device.feed(frame, length);
+    CHECK_EQUAL(CMD_REQUEST_SNAPSHOT, command.type);
+    CHECK_EQUAL(0, command.length);
+    CHECK_EQUAL(3, device.getStats().frames);
+    CHECK_EQUAL(0, host.ping(frame, 4));
+}
+
+// MSG_TELEMETRY as SerialLink sends it, and CMD_GET_TELEMETRY as a tool asks for it
+void testTelemetry() {
+    Telemetry report = {};
+    report.rssi = {64, -91, -42, -67};
+    report.connect = {16, 812, 20000, 4310};
+    report.sessions = {3, 0, 86400 * 30, 5000};
+    report.failedAttempts = 5;
+    report.lastResult = 4;  // WL_CONNECT_FAILED
+    for (uint8_t i = 0; i < TELEMETRY_RSSI_BINS; i++) {
+        report.rssiBins[i] = i * 3;
+    }
+
+    FrameWriter writer;
+    uint8_t frame[MAX_ENCODED];
+    writer.begin(MSG_TELEMETRY, 9);
+    CHECK(writer.putTelemetry(report));
+    size_t length = writer.finish(frame, sizeof(frame));
+
+    HostDecoder host;
+    Telemetry received = {};
+    CHECK(!host.takeTelemetry(received));
+    host.feed(frame, length);
+    CHECK(host.takeTelemetry(received));
+    CHECK(!host.takeTelemetry(received));
+    CHECK_EQUAL(1, host.getStats().telemetryReports);
+
+    CHECK_EQUAL(64, received.rssi.count);
+    CHECK_EQUAL(-91, received.rssi.min);
+    CHECK_EQUAL(-42, received.rssi.max);
+    CHECK_EQUAL(-67, received.rssi.mean);
+    CHECK_EQUAL(20000, received.connect.max);
+    CHECK_EQUAL(4310, received.connect.mean);
+    CHECK_EQUAL(86400 * 30, received.sessions.max);
+    CHECK_EQUAL(5, received.failedAttempts);
+    CHECK_EQUAL(4, received.lastResult);
+    CHECK(memcmp(report.rssiBins, received.rssiBins, TELEMETRY_RSSI_BINS) == 0);
+
+    // A short report is rejected
+    writer.begin(MSG_TELEMETRY, 10);
+    writer.putSummary(report.rssi);
+    length = writer.finish(frame, sizeof(frame));
+    host.feed(frame, length);
+    CHECK(!host.takeTelemetry(received));
+    CHECK_EQUAL(1, host.getStats().badMessages);
+
+    Command command = {};
+    FrameDecoder device(captureCommand, &command);
+    length = host.getTelemetry(frame, sizeof(frame));
+    device.feed(frame, length);
+    CHECK_EQUAL(CMD_GET_TELEMETRY, command.type);
+    CHECK_EQUAL(0, command.length);
+}
+
+// Device side of the pty run: the stream SerialLink would produce for a busy mixer
+struct Stream {
+    std::vector<uint8_t> bytes;
+    uint32_t frames = 0;
+    ChannelState finalStates[CHANNELS];
+};
+
+Stream buildStream(uint32_t frameCount) {
+    Stream stream;
+    FrameWriter writer;
+    uint8_t frame[MAX_ENCODED];
+    ChannelState states[CHANNELS] = {};
+    std::mt19937 random(777);
+
+    for (uint32_t i = 0; i < frameCount; i++) {
+        size_t length;
+        if (i % 64 == 0) {
+            length = buildSnapshot(writer, (uint8_t)i, states, CHANNELS, frame);
+        } else {
+            // An animation step moves a few channels; zeros in the levels exercise COBS
+            uint32_t mask = random() & ((1 << CHANNELS) - 1);
+            if (mask == 0) mask = 1;
+            for (uint8_t channel = 0; channel < CHANNELS; channel++) {
+                if (mask & (1 << channel)) {
+                    states[channel].current = (uint8_t)random() % 101;
+                    states[channel].target = random() % 8 == 0 ? 0 : (uint8_t)random() % 101;
+                    states[channel].flags = random() % 16 == 0 ? FLAG_MUTED : 0;
+                }
+            }
+            length = buildDelta(writer, (uint8_t)i, states, mask, frame);
+        }
+        stream.bytes.insert(stream.bytes.end(), frame, frame + length);
+    }
+
+    stream.frames = frameCount;
+    memcpy(stream.finalStates, states, sizeof(states));
+    return stream;
+}
+
+void writeAll(int fd, const uint8_t* data, size_t length) {
+    const size_t CHUNK = 512;  // About what a UART driver hands over per interrupt burst
+    while (length > 0) {
+        ssize_t written = write(fd, data, length < CHUNK ? length : CHUNK);
+        if (written < 0) {
+            if (errno == EINTR || errno == EAGAIN) continue;
+            return;
+        }
+        data += written;
+        length -= written;
+    }
+}
+
+void testPtyThroughput() {
+    int master, slave;
+    if (openpty(&master, &slave, nullptr, nullptr, nullptr) != 0) {
+        printf("serial protocol: no pty available (%s), throughput run skipped\n", strerror(errno));
+        return;
+    }
+
+    // Raw mode: no line discipline may touch the bytes, least of all 0x00 and \r\n
+    struct termios raw;
+    tcgetattr(slave, &raw);
+    cfmakeraw(&raw);
+    tcsetattr(slave, TCSANOW, &raw);
+
+    const uint32_t FRAMES = 200000;
+    Stream stream = buildStream(FRAMES);
+
+    HostDecoder host;
+    auto start = std::chrono::steady_clock::now();
+    std::thread writer(writeAll, master, stream.bytes.data(), stream.bytes.size());
+
+    uint8_t buffer[4096];
+    size_t received = 0;
+    while (received < stream.bytes.size()) {
+        ssize_t count = read(slave, buffer, sizeof(buffer));
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) break;
+        host.feed(buffer, count);
+        received += count;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    writer.join();
+    close(slave);
+    close(master);
+
+    const FrameDecoder::Stats& frames = host.getFrameStats();
+    double bytesPerFrame = (double)stream.bytes.size() / FRAMES;
+    printf("serial protocol over pty: %u frames, %.1f bytes/frame, %.0f frames/s, %.2f MB/s decoded\n",
+           (unsigned)frames.frames, bytesPerFrame, frames.frames / seconds, received / seconds / 1e6);
+    printf("serial protocol at UART rates: %.0f frames/s at 115200 baud, %.0f frames/s at 921600 baud\n",
+           115200 / 10 / bytesPerFrame, 921600 / 10 / bytesPerFrame);
+
+    CHECK_EQUAL(stream.bytes.size(), received);
+    CHECK_EQUAL(FRAMES, frames.frames);
+    CHECK_EQUAL(0, frames.crcErrors);
+    CHECK_EQUAL(0, frames.badFrames);
+    CHECK_EQUAL(0, host.getStats().seqGaps);
+    CHECK_EQUAL(0, host.getStats().badMessages);
+    for (uint8_t channel = 0; channel < CHANNELS; channel++) {
+        CHECK_EQUAL(stream.finalStates[channel].target, host.getChannel(channel).target);
+        CHECK_EQUAL(stream.finalStates[channel].current, host.getChannel(channel).current);
+        CHECK_EQUAL(stream.finalStates[channel].flags, host.getChannel(channel).flags);
+    }
+}
+}
+
+int main() {
+    testCrc();
+    testCobs();
+    testHostDecoder();
+    testTelemetry();
+    testPtyThroughput();
+    return TEST_RESULT("test_serial_protocol");
+}
@@ -0,0 +1,210 @@
+// StatePushServer: fan-out to local WebSocket clients, and its latency.
+//
+// support/WebSocketsServer.h serves real WebSockets on 127.0.0.1, so the
+// clients here connect, do the upgrade handshake and read frames through the
+// kernel. Changes start where they do on the device, as Mixer target
+// changes on the control task. They travel in the published snapshot, and
+// forward() passes them on the way serviceNetwork() does in main.cpp.
+//
+// The fake clock checks that getLastFanoutLatency() covers the whole trip,
+// from the input event to the send: the wait for the next snapshot read,
+// the network job's kick and the push interval. The benchmark reports the
+// real cost of one fan-out, from update() until every client has read the
+// frame.
+
+#include <Arduino.h>
+#include <arpa/inet.h>
+#include <chrono>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "Check.hpp"
+#include "mixer/Mixer.hpp"
+#include "network/Network.hpp"
+#include "network/StatePushServer.hpp"
+
+namespace {
+const uint16_t PORT = 18081;
+const uint8_t CLIENTS = 4;
+const unsigned long PUSH_INTERVAL = 50;  // StatePushServer's default, ms
+
+// Minimal WebSocket client: handshake, then unmasked text frames from the server
+class LocalClient {
+   public:
+    bool connectTo(StatePushServer& server) {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(PORT);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (connect(fd, (sockaddr*)&address, sizeof(address)) != 0) return false;
+
+        // The RFC 6455 sample key, whose accept value is known
+        const char* request =
+            "GET / HTTP/1.1\r\nHost: unimix\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+            "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+        send(fd, request, strlen(request), 0);
+        server.update();
+
+        std::string response;
+        char c;
+        while (response.find("\r\n\r\n") == std::string::npos && recv(fd, &c, 1, 0) == 1) {
+            response += c;
+        }
+        return response.find("101 Switching Protocols") != std::string::npos &&
+               response.find("Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=") != std::string::npos;
+    }
+
+    std::string readFrame() {
+        uint8_t header[4];
+        if (!readAll(header, 2)) return "";
+        size_t length = header[1] & 0x7F;
+        if (length == 126) {
+            if (!readAll(header + 2, 2)) return "";
+            length = (size_t)header[2] << 8 | header[3];
+        }
+        std::string payload(length, '\0');
+        if (!readAll(&payload[0], length)) return "";
+        return payload;
+    }
+
+    void disconnect() {
+        close(fd);
+        fd = -1;
+    }
+
+   private:
+    int fd = -1;
+
+    bool readAll(void* data, size_t length) {
+        uint8_t* bytes = (uint8_t*)data;
+        while (length > 0) {
+            ssize_t received = recv(fd, bytes, length, 0);
+            if (received <= 0) return false;
+            bytes += received;
+            length -= received;
+        }
+        return true;
+    }
+};
+
+// serviceNetwork()'s hand-off: changed targets from the published snapshot, with their input time
+void forward(StatePushServer& server) {
+    static uint8_t sentTarget[Mixer::MAX_CHANNELS];
+    static uint8_t sentCount = 0;
+
+    Mixer::Snapshot state;
+    if (!Mixer::getInstance().readSnapshot(state)) return;
+    for (uint8_t channel = 0; channel < state.channelCount; channel++) {
+        if (channel < sentCount && state.target[channel] == sentTarget[channel]) continue;
+        server.setChannelValue(channel, state.target[channel], state.changedAt[channel]);
+        sentTarget[channel] = state.target[channel];
+    }
+    sentCount = state.channelCount;
+}
+
+void testFanout(StatePushServer& server, LocalClient* clients) {
+    Mixer& mixer = Mixer::getInstance();
+
+    for (uint8_t i = 0; i < CLIENTS; i++) {
+        CHECK(clients[i].connectTo(server));
+    }
+    CHECK_EQUAL(CLIENTS, server.getClientCount());
+
+    // New clients get the full state on their first push
+    host::advanceMillis(PUSH_INTERVAL);
+    server.update();
+    for (uint8_t i = 0; i < CLIENTS; i++) {
+        CHECK(clients[i].readFrame() == "{\"s\":[10,20,30,40]}");
+    }
+
+    // An input event, read from the snapshot 3 ms later and sent on the push 7 ms after that
+    host::advanceMillis(PUSH_INTERVAL);
+    mixer.setTarget(1, 80);
+    mixer.publish();
+    host::advanceMillis(3);
+    forward(server);
+    host::advanceMillis(7);
+    server.update();
+    for (uint8_t i = 0; i < CLIENTS; i++) {
+        CHECK(clients[i].readFrame() == "{\"d\":[[1,80]]}");
+    }
+    CHECK_EQUAL(10000, server.getLastFanoutLatency());
+    CHECK_EQUAL(CLIENTS + CLIENTS, server.getFramesSent());
+
+    // Changes inside one push interval go out together. Latency runs from the input behind
+    // each value sent, so the replaced value of channel 0 does not count
+    mixer.setTarget(0, 11);
+    mixer.publish();
+    forward(server);
+    host::advanceMillis(20);
+    mixer.setTarget(0, 12);
+    mixer.setTarget(3, 44);
+    mixer.publish();
+    forward(server);
+    server.update();  // Still inside the interval: nothing sent
+    host::advanceMillis(PUSH_INTERVAL - 20);
+    server.update();
+    for (uint8_t i = 0; i < CLIENTS; i++) {
+        CHECK(clients[i].readFrame() == "{\"d\":[[0,12],[3,44]]}");
+    }
+    CHECK_EQUAL((PUSH_INTERVAL - 20) * 1000, server.getLastFanoutLatency());
+
+    // A closed client is dropped on the next update
+    clients[CLIENTS - 1].disconnect();
+    server.update();
+    CHECK_EQUAL(CLIENTS - 1, server.getClientCount());
+}
+
+void benchmark(StatePushServer& server, LocalClient* clients) {
+    const int FANOUTS = 5000;
+    const uint8_t connected = CLIENTS - 1;
+    Mixer& mixer = Mixer::getInstance();
+
+    double total = 0;
+    double worst = 0;
+    for (int i = 0; i < FANOUTS; i++) {
+        host::advanceMillis(PUSH_INTERVAL);
+        mixer.setTarget(2, i % 100);
+        mixer.publish();
+        forward(server);
+
+        auto start = std::chrono::steady_clock::now();
+        server.update();
+        for (uint8_t c = 0; c < connected; c++) {
+            clients[c].readFrame();
+        }
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        total += us;
+        if (us > worst) worst = us;
+    }
+
+    printf("state push: %.1f us average, %.1f us worst from update() until %u local clients have the frame\n",
+           total / FANOUTS, worst, connected);
+}
+}
+
+int main() {
+    Network::getInstance();  // The stub's link is up, so the server starts listening
+
+    Mixer& mixer = Mixer::getInstance();
+    for (int level = 10; level <= 40; level += 10) {
+        mixer.addChannel(level);
+    }
+    mixer.publish();
+
+    StatePushServer& server = StatePushServer::getInstance();
+    server.setPort(PORT);
+    server.initialize();
+    server.update();  // Starts listening
+    forward(server);
+
+    LocalClient clients[CLIENTS];
+    testFanout(server, clients);
+    benchmark(server, clients);
+
+    StatePushServer::destroyInstance();
+    return TEST_RESULT("test_state_push");
+}